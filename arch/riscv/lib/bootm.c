@@ -52,6 +52,9 @@ static void announce_and_cleanup(int fake)
 
 	board_quiesce_devices();
 
+	/* Don't leave any output in the console buffers */
+	flush();
+
 	/*
 	 * Call remove function of all devices with a removal flag set.
 	 * This may be useful for last-stage operations, like cancelling
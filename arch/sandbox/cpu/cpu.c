@@ -10,6 +10,7 @@
 #include <errno.h>
 #include <log.h>
 #include <os.h>
+#include <profile.h>
 #include <asm/global_data.h>
 #include <asm/io.h>
 #include <asm/malloc.h>
@@ -404,6 +405,18 @@ fail:
 	return NULL;
 }
 
+#if CONFIG_IS_ENABLED(PROFILE)
+int arch_profile_start(ulong period_us)
+{
+	return os_profile_start(period_us, profile_sample);
+}
+
+void arch_profile_stop(void)
+{
+	os_profile_stop();
+}
+#endif
+
 ulong timer_get_boot_us(void)
 {
 	static uint64_t base_count;
@@ -7,6 +7,7 @@
 
 #include <dirent.h>
 #include <errno.h>
+#include <execinfo.h>
 #include <fcntl.h>
 #include <pthread.h>
 #include <getopt.h>
@@ -348,24 +349,33 @@ static void os_sigint_handler(int sig)
 	raise(SIGINT);
 }
 
-static void os_signal_handler(int sig, siginfo_t *info, void *con)
+/* Get the program counter which was interrupted by a signal, or 0 if unknown */
+static unsigned long os_context_pc(void *con)
 {
 	ucontext_t __maybe_unused *context = con;
-	unsigned long pc;
 
 #if defined(__x86_64__)
-	pc = context->uc_mcontext.gregs[REG_RIP];
+	return context->uc_mcontext.gregs[REG_RIP];
 #elif defined(__aarch64__)
-	pc = context->uc_mcontext.pc;
+	return context->uc_mcontext.pc;
 #elif defined(__riscv)
-	pc = context->uc_mcontext.__gregs[REG_PC];
+	return context->uc_mcontext.__gregs[REG_PC];
 #else
-	const char msg[] =
-		"\nUnsupported architecture, cannot read program counter\n";
-
-	os_write(1, msg, sizeof(msg));
-	pc = 0;
+	return 0;
 #endif
+}
+
+static void os_signal_handler(int sig, siginfo_t *info, void *con)
+{
+	unsigned long pc;
+
+	pc = os_context_pc(con);
+	if (!pc) {
+		const char msg[] =
+			"\nUnsupported architecture, cannot read program counter\n";
+
+		os_write(1, msg, sizeof(msg));
+	}
 
 	os_signal_action(sig, pc);
 }
@@ -384,6 +394,62 @@ int os_setup_signal_handlers(void)
 	return 0;
 }
 
+static void (*os_profile_handler)(unsigned long pc, unsigned long caller);
+
+static void os_profile_signal(int sig, siginfo_t *info, void *con)
+{
+	unsigned long pc, caller = 0;
+	void *frames[8];
+	int count, i;
+
+	/* Find the interrupted function in the backtrace, to get its caller */
+	pc = os_context_pc(con);
+	count = backtrace(frames, 8);
+	for (i = 0; i < count - 1; i++) {
+		if ((unsigned long)frames[i] == pc) {
+			caller = (unsigned long)frames[i + 1];
+			break;
+		}
+	}
+
+	os_profile_handler(pc, caller);
+}
+
+int os_profile_start(unsigned long period_us,
+		     void (*handler)(unsigned long pc, unsigned long caller))
+{
+	struct itimerval timer;
+	struct sigaction act;
+	void *frames[1];
+
+	/* The first call may allocate memory, which is not safe in a handler */
+	backtrace(frames, 1);
+
+	os_profile_handler = handler;
+	act.sa_sigaction = os_profile_signal;
+	sigemptyset(&act.sa_mask);
+	act.sa_flags = SA_SIGINFO | SA_RESTART;
+	if (sigaction(SIGPROF, &act, NULL))
+		return -errno;
+
+	timer.it_interval.tv_sec = period_us / 1000000;
+	timer.it_interval.tv_usec = period_us % 1000000;
+	timer.it_value = timer.it_interval;
+	if (setitimer(ITIMER_PROF, &timer, NULL))
+		return -errno;
+
+	return 0;
+}
+
+void os_profile_stop(void)
+{
+	struct itimerval timer;
+
+	memset(&timer, '\0', sizeof(timer));
+	setitimer(ITIMER_PROF, &timer, NULL);
+	signal(SIGPROF, SIG_IGN);
+}
+
 /* Put tty into raw mode so <tab> and <ctrl+c> work */
 void os_tty_raw(int fd, bool allow_sigs)
 {
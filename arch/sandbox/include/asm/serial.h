@@ -38,6 +38,15 @@ size_t sandbox_serial_written(void);
  */
 void sandbox_serial_endisable(bool enabled);
 
+/**
+ * sandbox_serial_tx_stall() - Make the serial device appear busy
+ * @stall: true to reject output with -EAGAIN, false to accept it again
+ *
+ * This emulates a uart whose TX FIFO is full, so that tests can check what
+ * happens to output which cannot be sent yet. Only putc() is affected.
+ */
+void sandbox_serial_tx_stall(bool stall);
+
 /**
  * struct sandbox_serial_priv - Private data for this driver
  *
@@ -361,4 +361,24 @@ bool sandbox_sf_bootdev_enabled(void);
  */
 void sandbox_sf_set_enable_bootdevs(bool enable);
 
+/**
+ * sandbox_mmc_set_busy() - Make a sandbox MMC card slow to power up
+ *
+ * This also clears the count returned by sandbox_mmc_get_cyclic_polls()
+ *
+ * @dev: MMC device
+ * @polls: Number of op_cond commands for which the card reports that it is
+ *	still busy
+ */
+void sandbox_mmc_set_busy(struct udevice *dev, int polls);
+
+/**
+ * sandbox_mmc_get_cyclic_polls() - Count op_cond commands sent by cyclic code
+ *
+ * @dev: MMC device
+ * Return: number of op_cond commands received from a cyclic function since
+ *	sandbox_mmc_set_busy() was called
+ */
+int sandbox_mmc_get_cyclic_polls(struct udevice *dev);
+
 #endif
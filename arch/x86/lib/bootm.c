@@ -44,6 +44,9 @@ void bootm_announce_and_cleanup(void)
 	bootstage_report();
 #endif
 
+	/* Don't leave any output in the console buffers */
+	flush();
+
 	/*
 	 * Call remove function of all devices with a removal flag set.
 	 * This may be useful for last-stage operations, like cancelling
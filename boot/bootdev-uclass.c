@@ -748,6 +748,13 @@ int bootdev_setup_iter(struct bootflow_iter *iter, const char *label,
 		log_debug("- bootdev_hunt_prio() ret %d\n", ret);
 		if (ret)
 			return log_msg_ret("pre", ret);
+
+		/* let slow hunters get going while the faster ones are used */
+		if (IS_ENABLED(CONFIG_BOOTSTD_HUNT_ASYNC) && !label) {
+			ret = bootdev_hunt_start_all(show);
+			if (ret)
+				return log_msg_ret("sta", ret);
+		}
 	}
 
 	/* Handle scanning a single device */
@@ -821,6 +828,7 @@ static int bootdev_hunt_drv(struct bootdev_hunter *info, uint seq, bool show)
 				return ret;
 		}
 		std->hunters_used |= BIT(seq);
+		std->hunters_started &= ~BIT(seq);
 	}
 
 	return 0;
@@ -884,6 +892,7 @@ int bootdev_unhunt(enum uclass_id id)
 			if (!(std->hunters_used & BIT(i)))
 				return -EALREADY;
 			std->hunters_used &= ~BIT(i);
+			std->hunters_started &= ~BIT(i);
 			return 0;
 		}
 	}
@@ -918,6 +927,38 @@ int bootdev_hunt_prio(enum bootdev_prio_t prio, bool show)
 	return result;
 }
 
+int bootdev_hunt_start_all(bool show)
+{
+	struct bootdev_hunter *start;
+	struct bootstd_priv *std;
+	int n_ent, i, ret;
+
+	ret = bootstd_get_priv(&std);
+	if (ret)
+		return log_msg_ret("std", ret);
+
+	start = ll_entry_start(struct bootdev_hunter, bootdev_hunter);
+	n_ent = ll_entry_count(struct bootdev_hunter, bootdev_hunter);
+	for (i = 0; i < n_ent; i++) {
+		struct bootdev_hunter *info = start + i;
+		const char *name = uclass_get_name(info->uclass);
+
+		if (!info->start ||
+		    ((std->hunters_used | std->hunters_started) & BIT(i)))
+			continue;
+		if (show)
+			printf("Starting hunter: %s\n", name);
+		log_debug("Starting hunter: %s\n", name);
+		ret = info->start(info, show);
+		log_debug("  - start result %d\n", ret);
+		if (ret)
+			continue;
+		std->hunters_started |= BIT(i);
+	}
+
+	return 0;
+}
+
 void bootdev_list_hunters(struct bootstd_priv *std)
 {
 	struct bootdev_hunter *orig, *start;
@@ -41,6 +41,11 @@ static int extlinux_pxe_getfile(struct pxe_context *ctx, const char *file_path,
 	return 0;
 }
 
+static void extlinux_pxe_fetch_batch(struct pxe_context *ctx, bool start)
+{
+	net_hold_link(start);
+}
+
 static int extlinux_pxe_check(struct udevice *dev, struct bootflow_iter *iter)
 {
 	int ret;
@@ -153,6 +158,7 @@ static int extlinux_pxe_boot(struct udevice *dev, struct bootflow *bflow)
 			    bflow->subdir, false, false);
 	if (ret)
 		return log_msg_ret("ctx", -EINVAL);
+	ctx->fetch_batch = extlinux_pxe_fetch_batch;
 
 	ret = pxe_process(ctx, addr, false);
 	if (ret)
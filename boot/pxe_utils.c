@@ -220,6 +220,20 @@ static int get_relfile_envaddr(struct pxe_context *ctx, const char *file_path,
 	return get_relfile(ctx, file_path, file_addr, filesizep);
 }
 
+/**
+ * label_fetch_batch() - start or end reading the files for a label
+ *
+ * @ctx: PXE context
+ * @start: true to start reading, false when done
+ */
+static void label_fetch_batch(struct pxe_context *ctx, bool start)
+{
+	if (!ctx->fetch_batch || ctx->fetching == start)
+		return;
+	ctx->fetch_batch(ctx, start);
+	ctx->fetching = start;
+}
+
 /**
  * label_create() - crate a new PXE label
  *
@@ -489,10 +503,24 @@ static int label_boot(struct pxe_context *ctx, struct pxe_label *label)
 		return 1;
 	}
 
+	/*
+	 * Check that the initrd has somewhere to go before reading anything,
+	 * rather than finding out after the kernel has been transferred
+	 */
+	if (label->initrd && strcmp(label->kernel_label, label->initrd) &&
+	    !from_env("ramdisk_addr_r")) {
+		printf("Skipping %s for failure retrieving initrd\n",
+		       label->name);
+		return 1;
+	}
+
+	/* read all the files for this label in one batch */
+	label_fetch_batch(ctx, true);
 	if (get_relfile_envaddr(ctx, label->kernel, "kernel_addr_r",
 				NULL) < 0) {
 		printf("Skipping %s for failure retrieving kernel\n",
 		       label->name);
+		label_fetch_batch(ctx, false);
 		return 1;
 	}
 
@@ -504,7 +532,7 @@ static int label_boot(struct pxe_context *ctx, struct pxe_label *label)
 		fit_addr = malloc(len);
 		if (!fit_addr) {
 			printf("malloc fail (FIT address)\n");
-			return 1;
+			goto cleanup;
 		}
 		snprintf(fit_addr, len, "%s%s", kernel_addr, label->config);
 		kernel_addr = fit_addr;
@@ -691,6 +719,8 @@ static int label_boot(struct pxe_context *ctx, struct pxe_label *label)
 		}
 	}
 
+	label_fetch_batch(ctx, false);
+
 	bootm_argv[1] = kernel_addr;
 	zboot_argv[1] = kernel_addr;
 
@@ -752,6 +782,7 @@ static int label_boot(struct pxe_context *ctx, struct pxe_label *label)
 	unmap_sysmem(buf);
 
 cleanup:
+	label_fetch_batch(ctx, false);
 	free(fit_addr);
 
 	return 1;
@@ -17,8 +17,22 @@ static int do_event_list(struct cmd_tbl *cmdtp, int flag, int argc,
 	return 0;
 }
 
+static int do_event_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			  char *const argv[])
+{
+	if (!CONFIG_IS_ENABLED(EVENT_STATS)) {
+		printf("Event statistics not enabled\n");
+		return CMD_RET_FAILURE;
+	}
+	event_show_stats();
+
+	return 0;
+}
+
 U_BOOT_LONGHELP(event,
-	"list - list event spies");
+	"list - list event spies\n"
+	"event stats - show statistics for each event type");
 
 U_BOOT_CMD_WITH_SUBCMDS(event, "Events", event_help_text,
-	U_BOOT_SUBCMD_MKENT(list, 1, 1, do_event_list));
+	U_BOOT_SUBCMD_MKENT(list, 1, 1, do_event_list),
+	U_BOOT_SUBCMD_MKENT(stats, 1, 1, do_event_stats));
@@ -0,0 +1,31 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Show the time taken by each initcall
+ */
+
+#include <command.h>
+#include <initcall.h>
+
+static int do_initcall(struct cmd_tbl *cmdtp, int flag, int argc,
+		       char *const argv[])
+{
+	bool sort = false;
+
+	if (argc > 1) {
+		if (strcmp(argv[1], "-s"))
+			return CMD_RET_USAGE;
+		sort = true;
+	}
+	if (initcall_show_stats(sort)) {
+		printf("Out of memory\n");
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+U_BOOT_CMD(initcall, 2, 1, do_initcall,
+	"Show the time taken by each initcall",
+	"[-s]\n"
+	"  -s  Sort by time, slowest first"
+);
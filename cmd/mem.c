@@ -16,6 +16,7 @@
 #include <command.h>
 #include <console.h>
 #include <display_options.h>
+#include <dma.h>
 #ifdef CONFIG_MTD_NOR_FLASH
 #include <flash.h>
 #endif
@@ -31,6 +32,8 @@
 #include <linux/compiler.h>
 #include <linux/ctype.h>
 #include <linux/delay.h>
+#include <linux/math64.h>
+#include <linux/sizes.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -311,10 +314,17 @@ static int do_mem_cp(struct cmd_tbl *cmdtp, int flag, int argc,
 		     char *const argv[])
 {
 	ulong	addr, dest, count;
+	ulong	bytes, start, us;
 	void	*src, *dst;
-	int	size;
+	int	size, arg = 1;
+	bool	dma, verbose = false;
 
-	if (argc != 4)
+	/* -v shows the time taken */
+	if (argc > 1 && !strcmp(argv[1], "-v")) {
+		verbose = true;
+		arg++;
+	}
+	if (argc != arg + 3)
 		return CMD_RET_USAGE;
 
 	/* Check for size specification.
@@ -322,13 +332,13 @@ static int do_mem_cp(struct cmd_tbl *cmdtp, int flag, int argc,
 	if ((size = cmd_get_data_size(argv[0], 4)) < 0)
 		return 1;
 
-	addr = hextoul(argv[1], NULL);
+	addr = hextoul(argv[arg], NULL);
 	addr += base_address;
 
-	dest = hextoul(argv[2], NULL);
+	dest = hextoul(argv[arg + 1], NULL);
 	dest += base_address;
 
-	count = hextoul(argv[3], NULL);
+	count = hextoul(argv[arg + 2], NULL);
 
 	if (count == 0) {
 		puts ("Zero length ???\n");
@@ -359,7 +369,16 @@ static int do_mem_cp(struct cmd_tbl *cmdtp, int flag, int argc,
 	}
 #endif
 
-	memmove(dst, src, count * size);
+	bytes = count * size;
+	start = timer_get_us();
+	dma = !dma_memcpy_try(dst, src, bytes);
+	if (!dma)
+		memmove(dst, src, bytes);
+	us = timer_get_us() - start;
+	if (verbose) {
+		printf("Copied %lu bytes in %lu us (%lu MB/s%s)\n", bytes, us,
+		       us ? bytes / us : 0, dma ? ", DMA" : "");
+	}
 
 	unmap_sysmem(src);
 	unmap_sysmem(dst);
@@ -999,20 +1018,20 @@ static ulong mem_test_bitflip(vu_long *buf, ulong start, ulong end)
 	return test_bitflip_comparison(buf, buf + half_size, half_size);
 }
 
-static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
-			    vu_long pattern, int iteration)
+/**
+ * mem_test_pattern() - Get the pattern to use for an iteration
+ *
+ * @pattern: Pattern requested by the user
+ * @iteration: Iteration number
+ * @incrp: Returns the amount to add to the pattern for each word
+ * Return: value to write to the first word
+ */
+static ulong mem_test_pattern(ulong pattern, int iteration, ulong *incrp)
 {
-	vu_long *end;
-	vu_long *addr;
-	ulong errs = 0;
-	ulong incr, length;
-	ulong val, readback;
-	const int plen = 2 * sizeof(ulong);
-
 	/* Alternate the pattern */
-	incr = 1;
+	*incrp = 1;
 	if (iteration & 1) {
-		incr = -incr;
+		*incrp = -1UL;
 		/*
 		 * Flip the pattern each time to make lots of zeros and
 		 * then, the next time, lots of ones.  We decrement
@@ -1024,6 +1043,21 @@ static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
 		else
 			pattern = ~pattern;
 	}
+
+	return pattern;
+}
+
+static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
+			    vu_long pattern, int iteration)
+{
+	vu_long *end;
+	vu_long *addr;
+	ulong errs = 0;
+	ulong incr, length;
+	ulong val, readback;
+	const int plen = 2 * sizeof(ulong);
+
+	pattern = mem_test_pattern(pattern, iteration, &incr);
 	length = (end_addr - start_addr) / sizeof(ulong);
 	end = buf + length;
 	printf("\rPattern %0*lX  Writing..."
@@ -1058,6 +1092,151 @@ static ulong mem_test_quick(vu_long *buf, ulong start_addr, ulong end_addr,
 	return errs;
 }
 
+/* Number of bytes tested between checks for Ctrl-C by the fast test */
+#define MEM_TEST_FAST_BLOCK	SZ_256K
+
+/* Number of words written or read at once by the fast test (a cache line) */
+#define MEM_TEST_FAST_LINE	8
+
+/**
+ * struct mem_test_rate - Throughput of the fast memory test
+ *
+ * @write_bytes: Number of bytes written
+ * @write_us: Time spent writing, in microseconds
+ * @read_bytes: Number of bytes read back
+ * @read_us: Time spent reading, in microseconds
+ */
+struct mem_test_rate {
+	u64 write_bytes;
+	u64 write_us;
+	u64 read_bytes;
+	u64 read_us;
+};
+
+static void mem_test_fast_fill(vu_long *addr, vu_long *end, ulong val,
+			       ulong incr)
+{
+	int i;
+
+	for (; addr + MEM_TEST_FAST_LINE <= end; addr += MEM_TEST_FAST_LINE) {
+		for (i = 0; i < MEM_TEST_FAST_LINE; i++, val += incr)
+			addr[i] = val;
+	}
+	for (; addr < end; addr++, val += incr)
+		*addr = val;
+}
+
+static ulong mem_test_fast_error(vu_long *buf, vu_long *addr, ulong start_addr,
+				 ulong readback, ulong val)
+{
+	const int plen = 2 * sizeof(ulong);
+
+	printf("\nMem error @ 0x%0*lX: found %0*lX, expected %0*lX\n",
+	       plen, start_addr + (addr - buf) * sizeof(vu_long), plen,
+	       readback, plen, val);
+
+	return 1;
+}
+
+static ulong mem_test_fast_check(vu_long *buf, vu_long *addr, vu_long *end,
+				 ulong start_addr, ulong val, ulong incr)
+{
+	ulong word[MEM_TEST_FAST_LINE];
+	ulong errs = 0;
+	ulong diff;
+	int i;
+
+	/* Read a whole line before checking it, so the loads are not stalled */
+	for (; addr + MEM_TEST_FAST_LINE <= end; addr += MEM_TEST_FAST_LINE) {
+		diff = 0;
+		for (i = 0; i < MEM_TEST_FAST_LINE; i++) {
+			word[i] = addr[i];
+			diff |= word[i] ^ (val + i * incr);
+		}
+		if (diff) {
+			for (i = 0; i < MEM_TEST_FAST_LINE; i++) {
+				if (word[i] != val + i * incr)
+					errs += mem_test_fast_error(buf,
+						addr + i, start_addr, word[i],
+						val + i * incr);
+			}
+		}
+		val += MEM_TEST_FAST_LINE * incr;
+	}
+	for (; addr < end; addr++, val += incr) {
+		ulong readback = *addr;
+
+		if (readback != val)
+			errs += mem_test_fast_error(buf, addr, start_addr,
+						    readback, val);
+	}
+
+	return errs;
+}
+
+/*
+ * This writes the same values as mem_test_quick() but works through memory
+ * in blocks, a cache line at a time, only checking for Ctrl-C between blocks,
+ * so that it runs at close to the memory bandwidth
+ */
+static ulong mem_test_fast(vu_long *buf, ulong start_addr, ulong end_addr,
+			   ulong pattern, int iteration,
+			   struct mem_test_rate *rate)
+{
+	const ulong block = MEM_TEST_FAST_BLOCK / sizeof(ulong);
+	vu_long *addr, *end, *next;
+	ulong length, incr, val;
+	const int plen = 2 * sizeof(ulong);
+	ulong errs = 0;
+	ulong start;
+
+	pattern = mem_test_pattern(pattern, iteration, &incr);
+	length = (end_addr - start_addr) / sizeof(ulong);
+	end = buf + length;
+	printf("\rPattern %0*lX  Writing..."
+		"%12s"
+		"\b\b\b\b\b\b\b\b\b\b",
+		plen, pattern, "");
+
+	for (addr = buf, val = pattern; addr < end; addr = next) {
+		next = addr + min(block, (ulong)(end - addr));
+		schedule();
+		if (ctrlc())
+			return -1UL;
+		start = timer_get_us();
+		mem_test_fast_fill(addr, next, val, incr);
+		rate->write_us += timer_get_us() - start;
+		rate->write_bytes += (next - addr) * sizeof(ulong);
+		val += (next - addr) * incr;
+	}
+
+	puts("Reading...");
+
+	for (addr = buf, val = pattern; addr < end; addr = next) {
+		next = addr + min(block, (ulong)(end - addr));
+		schedule();
+		if (ctrlc())
+			return -1UL;
+		start = timer_get_us();
+		errs += mem_test_fast_check(buf, addr, next, start_addr, val,
+					    incr);
+		rate->read_us += timer_get_us() - start;
+		rate->read_bytes += (next - addr) * sizeof(ulong);
+		val += (next - addr) * incr;
+	}
+
+	return errs;
+}
+
+/* Get the throughput in MB/s, given a number of bytes and microseconds */
+static ulong mem_test_mbps(u64 bytes, u64 us)
+{
+	ulong ms = max(div_u64(us, 1000), 1ULL);
+
+	/* bytes per millisecond is 1000 bytes per second */
+	return div_u64(bytes, ms) / 1000;
+}
+
 /*
  * Perform a memory test. A more complete alternative test can be
  * configured using CONFIG_SYS_ALT_MEMTEST. The complete test loops until
@@ -1073,6 +1252,7 @@ static int do_mem_mtest(struct cmd_tbl *cmdtp, int flag, int argc,
 	ulong count = 0;
 	ulong errs = 0;	/* number of errors, or -1 if interrupted */
 	ulong pattern = 0;
+	struct mem_test_rate rate = {};
 	int iteration;
 
 	start = CONFIG_SYS_MEMTEST_START;
@@ -1122,6 +1302,9 @@ static int do_mem_mtest(struct cmd_tbl *cmdtp, int flag, int argc,
 				count += errs;
 				errs = mem_test_bitflip(buf, start, end);
 			}
+		} else if (IS_ENABLED(CONFIG_SYS_MEMTEST_FAST)) {
+			errs = mem_test_fast(buf, start, end, pattern,
+					     iteration, &rate);
 		} else {
 			errs = mem_test_quick(buf, start, end, pattern,
 					      iteration);
@@ -1134,6 +1317,11 @@ static int do_mem_mtest(struct cmd_tbl *cmdtp, int flag, int argc,
 	unmap_sysmem((void *)buf);
 
 	printf("\nTested %d iteration(s) with %lu errors.\n", iteration, count);
+	if (rate.write_bytes) {
+		printf("Throughput: write %lu MB/s, read %lu MB/s\n",
+		       mem_test_mbps(rate.write_bytes, rate.write_us),
+		       mem_test_mbps(rate.read_bytes, rate.read_us));
+	}
 
 	return errs != 0;
 }
@@ -1335,9 +1523,10 @@ U_BOOT_CMD(
 );
 
 U_BOOT_CMD(
-	cp,	4,	1,	do_mem_cp,
+	cp,	5,	1,	do_mem_cp,
 	"memory copy",
-	"[.b, .w, .l" HELP_Q "] source target count"
+	"[.b, .w, .l" HELP_Q "] [-v] source target count\n"
+	"    -v: show the time taken and the throughput"
 );
 
 U_BOOT_CMD(
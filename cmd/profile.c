@@ -0,0 +1,98 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Control the sampling profiler
+ */
+
+#include <command.h>
+#include <env.h>
+#include <mapmem.h>
+#include <profile.h>
+#include <vsprintf.h>
+
+/* Default sampling period in microseconds */
+#define PROFILE_DEFAULT_PERIOD_US	1000
+
+static int do_profile_start(struct cmd_tbl *cmdtp, int flag, int argc,
+			    char *const argv[])
+{
+	ulong period_us = PROFILE_DEFAULT_PERIOD_US;
+	int ret;
+
+	if (argc > 1)
+		period_us = dectoul(argv[1], NULL);
+	ret = profile_start(period_us);
+	if (ret) {
+		printf("Cannot start profiler (err=%dE)\n", ret);
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+static int do_profile_stop(struct cmd_tbl *cmdtp, int flag, int argc,
+			   char *const argv[])
+{
+	if (profile_stop()) {
+		printf("Profiler is not running\n");
+		return CMD_RET_FAILURE;
+	}
+
+	return 0;
+}
+
+static int do_profile_stats(struct cmd_tbl *cmdtp, int flag, int argc,
+			    char *const argv[])
+{
+	profile_print_stats();
+
+	return 0;
+}
+
+/*
+ * This uses the same environment variables as 'trace calls', so that samples
+ * can be added to the same buffer as a function trace
+ */
+static int do_profile_dump(struct cmd_tbl *cmdtp, int flag, int argc,
+			   char *const argv[])
+{
+	size_t buff_size, buff_ptr, avail, needed;
+	char *buff;
+
+	if (argc < 3) {
+		buff_size = env_get_ulong("profsize", 16, 0);
+		buff = map_sysmem(env_get_ulong("profbase", 16, 0), buff_size);
+		buff_ptr = env_get_ulong("profoffset", 16, 0);
+	} else {
+		buff_size = hextoul(argv[2], NULL);
+		buff = map_sysmem(hextoul(argv[1], NULL), buff_size);
+		buff_ptr = 0;
+	}
+	if (buff_ptr > buff_size)
+		return CMD_RET_USAGE;
+
+	avail = buff_size - buff_ptr;
+	if (profile_list_samples(buff + buff_ptr, avail, &needed)) {
+		printf("Error: buffer too small (%#zx bytes needed)\n", needed);
+		return CMD_RET_FAILURE;
+	}
+	printf("Samples dumped to %08lx, size %#zx\n",
+	       (ulong)map_to_sysmem(buff + buff_ptr), needed);
+
+	env_set_hex("profbase", map_to_sysmem(buff));
+	env_set_hex("profsize", buff_size);
+	env_set_hex("profoffset", buff_ptr + needed);
+
+	return 0;
+}
+
+U_BOOT_LONGHELP(profile,
+	"start [<period_us>]     - start sampling (default period 1000us)\n"
+	"profile stop                    - stop sampling\n"
+	"profile stats                   - show information about the samples\n"
+	"profile dump [<addr> <size>]    - dump samples into buffer");
+
+U_BOOT_CMD_WITH_SUBCMDS(profile, "Sampling profiler", profile_help_text,
+	U_BOOT_SUBCMD_MKENT(start, 2, 1, do_profile_start),
+	U_BOOT_SUBCMD_MKENT(stop, 1, 1, do_profile_stop),
+	U_BOOT_SUBCMD_MKENT(stats, 1, 1, do_profile_stats),
+	U_BOOT_SUBCMD_MKENT(dump, 3, 1, do_profile_dump));
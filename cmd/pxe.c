@@ -53,6 +53,12 @@ static int do_get_tftp(struct pxe_context *ctx, const char *file_path,
 	return 1;
 }
 
+/* Keep the network link up while the files for a label are fetched */
+static void do_tftp_fetch_batch(struct pxe_context *ctx, bool start)
+{
+	net_hold_link(start);
+}
+
 /*
  * Looks for a pxe file with specified config file name,
  * which is received from DHCPv4 option 209 or
@@ -141,6 +147,9 @@ int pxe_get(ulong pxefile_addr_r, char **bootdirp, ulong *sizep, bool use_ipv6)
 			  env_get("bootfile"), use_ipv6, false))
 		return -ENOMEM;
 
+	/* there may be many paths to try, so only bring up the link once */
+	net_hold_link(true);
+
 	if (IS_ENABLED(CONFIG_BOOTP_PXE_DHCP_OPTION) &&
 	    pxelinux_configfile && !use_ipv6) {
 		if (pxe_dhcp_option_path(&ctx, pxefile_addr_r) > 0)
@@ -175,10 +184,12 @@ int pxe_get(ulong pxefile_addr_r, char **bootdirp, ulong *sizep, bool use_ipv6)
 	}
 
 error_exit:
+	net_hold_link(false);
 	pxe_destroy_ctx(&ctx);
 
 	return -ENOENT;
 done:
+	net_hold_link(false);
 	*bootdirp = env_get("bootfile");
 
 	/*
@@ -292,6 +303,7 @@ do_pxe_boot(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[])
 		printf("Out of memory\n");
 		return CMD_RET_FAILURE;
 	}
+	ctx.fetch_batch = do_tftp_fetch_batch;
 	ret = pxe_process(&ctx, pxefile_addr_r, false);
 	pxe_destroy_ctx(&ctx);
 	if (ret)
@@ -163,26 +163,161 @@ static int do_spi_flash_probe(int argc, char *const argv[])
 	return 0;
 }
 
+/**
+ * struct sf_update_stats - statistics gathered by spi_flash_update()
+ *
+ * @skipped:	number of bytes which already held the correct data
+ * @written:	number of bytes actually programmed
+ * @erased:	number of sectors erased
+ */
+struct sf_update_stats {
+	size_t skipped;
+	size_t written;
+	uint erased;
+};
+
+/**
+ * sf_buf_is_erased() - Check whether a buffer holds only erased (0xff) bytes
+ *
+ * @buf:	buffer to check
+ * @len:	number of bytes to check
+ * Return: true if all bytes are 0xff
+ */
+static bool sf_buf_is_erased(const char *buf, size_t len)
+{
+	const u8 *ptr = (const u8 *)buf;
+
+	while (len--) {
+		if (*ptr++ != 0xff)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * sf_can_program() - Check whether new data can be written without erasing
+ *
+ * A blank region can always be programmed. With
+ * CONFIG_CMD_SF_UPDATE_PROGRAM_ONLY, data is also programmed over existing
+ * contents when no bit needs to go from 0 to 1, since programming NOR flash
+ * can only clear bits.
+ *
+ * @old:	current flash contents
+ * @new:	data to write
+ * @len:	number of bytes to check
+ * Return: true if @new can be programmed over @old without an erase
+ */
+static bool sf_can_program(const char *old, const char *new, size_t len)
+{
+	const u8 *o = (const u8 *)old;
+	const u8 *n = (const u8 *)new;
+
+	if (!IS_ENABLED(CONFIG_CMD_SF_UPDATE_PROGRAM_ONLY))
+		return sf_buf_is_erased(old, len);
+
+	for (; len; len--, o++, n++) {
+		if ((*o & *n) != *n)
+			return false;
+	}
+
+	return true;
+}
+
+/**
+ * sf_program_pages() - Program the pages of a region which need to change
+ *
+ * Each page of @buf is compared with the matching page of @old, and only
+ * pages which differ are programmed. If @old is NULL the region has just
+ * been erased, so only pages which are not entirely 0xff are programmed.
+ *
+ * @flash:	flash context pointer
+ * @offset:	flash offset corresponding to the start of @buf
+ * @len:	number of bytes to consider
+ * @buf:	data to write
+ * @old:	current contents of the flash at @offset, or NULL if erased
+ * Return: number of bytes programmed, or -ve on error
+ */
+static long sf_program_pages(struct spi_flash *flash, u32 offset, size_t len,
+			     const char *buf, const char *old)
+{
+	u32 page_size = flash->page_size ?: flash->sector_size;
+	long written = 0;
+	size_t todo;
+	int ret;
+
+	for (; len; len -= todo, buf += todo, offset += todo) {
+		todo = min_t(size_t, len, page_size - offset % page_size);
+		if (old) {
+			ret = memcmp(old, buf, todo);
+			old += todo;
+			if (!ret)
+				continue;
+		} else if (sf_buf_is_erased(buf, todo)) {
+			continue;
+		}
+		ret = spi_flash_write(flash, offset, todo, buf);
+		if (ret)
+			return ret;
+		written += todo;
+	}
+
+	return written;
+}
+
+/**
+ * sf_blank_bytes() - Count the bytes of a region which lie in blank pages
+ *
+ * These are the bytes which sf_program_pages() leaves out after an erase.
+ *
+ * @flash:	flash context pointer
+ * @sector:	contents of the whole sector, as about to be written
+ * @start:	offset of the region within the sector
+ * @len:	number of bytes in the region
+ * Return: number of bytes of the region which are in blank pages
+ */
+static size_t sf_blank_bytes(struct spi_flash *flash, const char *sector,
+			     u32 start, size_t len)
+{
+	u32 page_size = flash->page_size ?: flash->sector_size;
+	size_t blank = 0;
+	size_t todo;
+	u32 page;
+
+	for (; len; len -= todo, start += todo) {
+		page = start - start % page_size;
+		todo = min_t(size_t, len, page + page_size - start);
+		if (sf_buf_is_erased(sector + page, page_size))
+			blank += todo;
+	}
+
+	return blank;
+}
+
 /**
  * Write a block of data to SPI flash, first checking if it is different from
  * what is already there.
  *
- * If the data being written is the same, then *skipped is incremented by len.
+ * If the data being written is the same, the block is skipped. If the sector
+ * can be programmed without erasing (see sf_can_program()) only the changed
+ * pages are written. Otherwise the sector is erased and written back, leaving
+ * out any pages which are blank.
  *
  * @param flash		flash context pointer
  * @param offset	flash offset to write
  * @param len		number of bytes to write
  * @param buf		buffer to write from
  * @param cmp_buf	read buffer to use to compare data
- * @param skipped	Count of skipped data (incremented by this function)
+ * @param stats		statistics (updated by this function)
  * Return: NULL if OK, else a string containing the stage which failed
  */
 static const char *spi_flash_update_block(struct spi_flash *flash, u32 offset,
-		size_t len, const char *buf, char *cmp_buf, size_t *skipped)
+		size_t len, const char *buf, char *cmp_buf,
+		struct sf_update_stats *stats)
 {
-	char *ptr = (char *)buf;
 	u32 start_offset = offset % flash->sector_size;
 	u32 read_offset = offset - start_offset;
+	long written;
 
 	debug("offset=%#x+%#x, sector_size=%#x, len=%#zx\n",
 	      read_offset, start_offset, flash->sector_size, len);
@@ -193,27 +328,42 @@ static const char *spi_flash_update_block(struct spi_flash *flash, u32 offset,
 	if (memcmp(cmp_buf + start_offset, buf, len) == 0) {
 		debug("Skip region %x+%x size %zx: no change\n",
 		      start_offset, read_offset, len);
-		*skipped += len;
+		stats->skipped += len;
+		return NULL;
+	}
+	/* Program just the changed pages if no erase is needed */
+	if (sf_can_program(cmp_buf + start_offset, buf, len)) {
+		debug("Region %x+%x size %zx: no erase needed\n",
+		      start_offset, read_offset, len);
+		written = sf_program_pages(flash, offset, len, buf,
+					   cmp_buf + start_offset);
+		if (written < 0)
+			return "write";
+		stats->written += written;
+		stats->skipped += len - written;
 		return NULL;
 	}
 	/* Erase the entire sector */
-	if (spi_flash_erase(flash, offset, flash->sector_size))
+	if (spi_flash_erase(flash, read_offset, flash->sector_size))
 		return "erase";
-	/* If it's a partial sector, copy the data into the temp-buffer */
-	if (len != flash->sector_size) {
-		memcpy(cmp_buf + start_offset, buf, len);
-		ptr = cmp_buf;
-	}
-	/* Write one complete sector */
-	if (spi_flash_write(flash, offset, flash->sector_size, ptr))
+	stats->erased++;
+	/* Merge the new data into the old sector contents */
+	memcpy(cmp_buf + start_offset, buf, len);
+	/* Write back the sector, skipping pages which are now blank */
+	written = sf_program_pages(flash, read_offset, flash->sector_size,
+				   cmp_buf, NULL);
+	if (written < 0)
 		return "write";
+	stats->written += written;
+	stats->skipped += sf_blank_bytes(flash, cmp_buf, start_offset, len);
 
 	return NULL;
 }
 
 /**
  * Update an area of SPI flash by erasing and writing any blocks which need
- * to change. Existing blocks with the correct data are left unchanged.
+ * to change. Existing blocks with the correct data are left unchanged, blank
+ * sectors are not erased and only the pages which differ are written.
  *
  * @param flash		flash context pointer
  * @param offset	flash offset to write
@@ -228,7 +378,7 @@ static int spi_flash_update(struct spi_flash *flash, u32 offset,
 	char *cmp_buf;
 	const char *end = buf + len;
 	size_t todo;		/* number of bytes to do in this pass */
-	size_t skipped = 0;	/* statistics */
+	struct sf_update_stats stats = {};
 	const ulong start_time = get_timer(0);
 	size_t scale = 1;
 	const char *start_buf = buf;
@@ -252,7 +402,7 @@ static int spi_flash_update(struct spi_flash *flash, u32 offset,
 				last_update = get_timer(0);
 			}
 			err_oper = spi_flash_update_block(flash, offset, todo,
-					buf, cmp_buf, &skipped);
+					buf, cmp_buf, &stats);
 		}
 	} else {
 		err_oper = "malloc";
@@ -265,8 +415,8 @@ static int spi_flash_update(struct spi_flash *flash, u32 offset,
 	}
 
 	delta = get_timer(start_time);
-	printf("%zu bytes written, %zu bytes skipped", len - skipped,
-	       skipped);
+	printf("%zu bytes written, %zu bytes skipped, %u sectors erased",
+	       stats.written, stats.skipped, stats.erased);
 	printf(" in %ld.%lds, speed %ld B/s\n",
 	       delta / 1000, delta % 1000, bytes_per_second(len, start_time));
 
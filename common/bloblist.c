@@ -61,6 +61,8 @@ static struct tag_name {
 	{ BLOBLISTT_U_BOOT_SPL_HANDOFF, "SPL hand-off" },
 	{ BLOBLISTT_VBE, "VBE" },
 	{ BLOBLISTT_U_BOOT_VIDEO, "SPL video handoff" },
+	{ BLOBLISTT_U_BOOT_MMC, "eMMC bus setup" },
+	{ BLOBLISTT_U_BOOT_DM, "Driver model snapshot" },
 
 	/* BLOBLISTT_VENDOR_AREA */
 };
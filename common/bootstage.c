@@ -12,6 +12,7 @@
 
 #include <bootstage.h>
 #include <hang.h>
+#include <initcall.h>
 #include <log.h>
 #include <malloc.h>
 #include <sort.h>
@@ -220,6 +221,36 @@ uint32_t bootstage_accum(enum bootstage_id id)
 	return duration;
 }
 
+ulong bootstage_count(enum bootstage_id id, const char *name)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_record *rec;
+
+	if (!data)
+		return 0;
+	rec = ensure_id(data, id);
+	if (!rec)
+		return 0;
+	rec->name = name;
+	rec->flags |= BOOTSTAGEF_COUNT;
+
+	return ++rec->time_us;
+}
+
+ulong bootstage_get_count(enum bootstage_id id)
+{
+	struct bootstage_data *data = gd->bootstage;
+	struct bootstage_record *rec;
+
+	if (!data)
+		return 0;
+	rec = find_id(data, id);
+	if (!rec || !(rec->flags & BOOTSTAGEF_COUNT))
+		return 0;
+
+	return rec->time_us;
+}
+
 /**
  * Get a record name as a printable string
  *
@@ -265,6 +296,50 @@ static int h_compare_record(const void *r1, const void *r2)
 }
 
 #ifdef CONFIG_OF_LIBFDT
+/**
+ * add_initcalls_devicetree() - Add initcall timings to a device tree
+ *
+ * Each initcall is added as an 'accum' record, numbered after the bootstage
+ * records. Since fdt_add_subnode() puts each new node ahead of the existing
+ * ones, these nodes come before the bootstage records in the tree.
+ *
+ * @blob: Device tree blob
+ * @bootstage: Offset of the bootstage node
+ * @seq: Number to use for the first node
+ * Return: 0 on success, -EINVAL on failure
+ */
+static int add_initcalls_devicetree(struct fdt_header *blob, int bootstage,
+				    int seq)
+{
+#if CONFIG_IS_ENABLED(INITCALL_STATS)
+	const struct initcall_stats *stats = &gd->initcall_stats;
+	char buf[40];
+	int count;
+	int i;
+
+	/*
+	 * Each node is inserted at the front, so add them in reverse order to
+	 * keep them in the order in which the initcalls ran
+	 */
+	count = min_t(int, stats->count, CONFIG_INITCALL_STATS_COUNT);
+	for (i = count - 1; i >= 0; i--) {
+		const struct initcall_stat *stat = &stats->stat[i];
+		int node;
+
+		node = fdt_add_subnode(blob, bootstage, simple_itoa(seq + i));
+		if (node < 0)
+			return -EINVAL;
+		if (fdt_setprop_string(blob, node, "name",
+				       initcall_stat_name(stat, buf,
+							  sizeof(buf))) ||
+		    fdt_setprop_cell(blob, node, "accum", stat->time_us))
+			return -EINVAL;
+	}
+#endif
+
+	return 0;
+}
+
 /**
  * Add all bootstage timings to a device tree.
  *
@@ -310,14 +385,15 @@ static int add_bootstages_devicetree(struct fdt_header *blob)
 				       get_record_name(buf, sizeof(buf), rec)))
 			return -EINVAL;
 
-		/* Check if this is a 'mark' or 'accum' record */
+		/* Check if this is a 'mark', 'accum' or 'count' record */
 		if (fdt_setprop_cell(blob, node,
+				rec->flags & BOOTSTAGEF_COUNT ? "count" :
 				rec->start_us ? "accum" : "mark",
 				rec->time_us))
 			return -EINVAL;
 	}
 
-	return 0;
+	return add_initcalls_devicetree(blob, bootstage, i);
 }
 
 int bootstage_fdt_add_report(void)
@@ -334,6 +410,7 @@ void bootstage_report(void)
 	struct bootstage_data *data = gd->bootstage;
 	struct bootstage_record *rec = data->record;
 	uint32_t prev;
+	bool first;
 	int i;
 
 	printf("Timer summary in microseconds (%d records):\n",
@@ -346,7 +423,8 @@ void bootstage_report(void)
 	qsort(data->record, data->rec_count, sizeof(*rec), h_compare_record);
 
 	for (i = 1, rec++; i < data->rec_count; i++, rec++) {
-		if (rec->id && !rec->start_us)
+		if (rec->id && !rec->start_us &&
+		    !(rec->flags & BOOTSTAGEF_COUNT))
 			prev = print_time_record(rec, prev);
 	}
 	if (data->rec_count > RECORD_COUNT)
@@ -359,6 +437,17 @@ void bootstage_report(void)
 		if (rec->start_us)
 			prev = print_time_record(rec, -1);
 	}
+
+	for (i = 0, rec = data->record, first = true; i < data->rec_count;
+	     i++, rec++) {
+		if (!(rec->flags & BOOTSTAGEF_COUNT))
+			continue;
+		if (first) {
+			puts("\nCounts:\n");
+			first = false;
+		}
+		print_time_record(rec, -1);
+	}
 }
 
 /**
@@ -84,6 +84,7 @@
 #include <cli_hush.h>
 #include <command.h>        /* find_cmd */
 #include <asm/global_data.h>
+#include <u-boot/fnv.h>
 #endif
 #ifndef __U_BOOT__
 #include <ctype.h>     /* isalpha, isdigit */
@@ -372,8 +373,12 @@ static inline void debug_printf(const char *format, ...) { }
 #define final_printf debug_printf
 
 #ifdef __U_BOOT__
+/* Set while parsing a script for the parse cache, which is done silently */
+static bool hush_cache_parsing;
+
 static void syntax_err(void) {
-	 printf("syntax error\n");
+	if (!hush_cache_parsing)
+		printf("syntax error\n");
 }
 #else
 static void __syntax(char *file, int line) {
@@ -1528,7 +1533,7 @@ shell_terminal_error:
  */
 static int run_pipe_real(struct pipe *pi)
 {
-	int i;
+	int i, sp;
 #ifndef __U_BOOT__
 	int nextin, nextout;
 	int pipefds[2];				/* pipefds[0] is for reading */
@@ -1613,6 +1618,8 @@ static int run_pipe_real(struct pipe *pi)
 			}
 			return EXIT_SUCCESS;   /* don't worry about errors in set_local_var() yet */
 		}
+		/* leave child->sp alone so that the pipe can be run again */
+		sp = child->sp;
 		for (i = 0; is_assignment(child->argv[i]); i++) {
 			p = insert_var_value(child->argv[i]);
 #ifndef __U_BOOT__
@@ -1621,11 +1628,11 @@ static int run_pipe_real(struct pipe *pi)
 			set_local_var(p, 0);
 #endif
 			if (p != child->argv[i]) {
-				child->sp--;
+				sp--;
 				free(p);
 			}
 		}
-		if (child->sp) {
+		if (sp) {
 			char * str = NULL;
 
 			str = make_string(child->argv + i,
@@ -1752,11 +1759,28 @@ static int run_pipe_real(struct pipe *pi)
 	return -1;
 }
 
+#ifdef __U_BOOT__
+/*
+ * Put back the variable name of a 'for' loop which is stopped part-way
+ * through, so that the parsed list is left as it was
+ */
+static void for_list_abort(struct pipe *for_pi, char *save_name, char **list,
+			   char **save_list)
+{
+	free(for_pi->progs->argv[0]);
+	while (*list)
+		free(*list++);
+	free(save_list);
+	for_pi->progs->argv[0] = save_name;
+}
+#endif
+
 static int run_list_real(struct pipe *pi)
 {
 	char *save_name = NULL;
 	char **list = NULL;
 	char **save_list = NULL;
+	struct pipe *for_pi = NULL;
 	struct pipe *rpipe;
 	int flag_rep = 0;
 #ifndef __U_BOOT__
@@ -1796,6 +1820,9 @@ static int run_list_real(struct pipe *pi)
 				/* check Ctrl-C */
 				ctrlc();
 				if ((had_ctrlc())) {
+					if (list)
+						for_list_abort(for_pi, save_name,
+							       list, save_list);
 					return 1;
 				}
 #endif
@@ -1824,6 +1851,7 @@ static int run_list_real(struct pipe *pi)
 				/* create list of variable values */
 				list = make_list_in(pi->next->progs->argv,
 					pi->progs->argv[0]);
+				for_pi = pi;
 				save_list = list;
 				save_name = pi->progs->argv[0];
 				pi->progs->argv[0] = NULL;
@@ -1895,6 +1923,9 @@ static int run_list_real(struct pipe *pi)
 #else
 		if (rcode < -1) {
 			last_return_code = -rcode - 2;
+			if (list)
+				for_list_abort(for_pi, save_name, list,
+					       save_list);
 			return -2;	/* exit */
 		}
 		last_return_code = rcode;
@@ -1915,6 +1946,10 @@ static int run_list_real(struct pipe *pi)
 		checkjobs(NULL);
 #endif
 	}
+#ifdef __U_BOOT__
+	if (list)
+		for_list_abort(for_pi, save_name, list, save_list);
+#endif
 	return rcode;
 }
 
@@ -3251,6 +3286,183 @@ static int parse_stream_outer(struct in_str *inp, int flag)
 #endif /* __U_BOOT__ */
 }
 
+#if defined(__U_BOOT__) && CONFIG_IS_ENABLED(HUSH_PARSE_CACHE)
+/**
+ * struct hush_cache_ent - A parsed script which can be run again
+ *
+ * @text: Script text, as passed to parse_stream_outer() (allocated)
+ * @len: Length of @text
+ * @hash: Hash of @text
+ * @flag: Parse flags (FLAG_...) used
+ * @lists: Parsed lists, in the order they appear in the script (allocated)
+ * @count: Number of lists
+ * @busy: Number of times this entry is being run (scripts can run themselves)
+ * @last_used: Value of hush_cache_tick when this entry was last run
+ */
+struct hush_cache_ent {
+	char *text;
+	int len;
+	uint hash;
+	int flag;
+	struct pipe **lists;
+	int count;
+	int busy;
+	ulong last_used;
+};
+
+static struct hush_cache_ent hush_cache[CONFIG_HUSH_PARSE_CACHE_SIZE];
+static ulong hush_cache_tick;
+
+static void hush_cache_free_lists(struct pipe **lists, int count)
+{
+	while (count--)
+		free_pipe_list(lists[count], 0);
+	free(lists);
+}
+
+/**
+ * hush_cache_parse() - Parse a whole script without running it
+ *
+ * This follows parse_stream_outer(), except that the lists are collected
+ * instead of being run as they are parsed.
+ *
+ * @s: Script to parse, ending in a newline
+ * @flag: Parse flags (FLAG_...)
+ * @countp: Returns the number of lists
+ * Return: array of lists, or NULL if the script has a syntax error (so cannot
+ *	be cached)
+ */
+static struct pipe **hush_cache_parse(const char *s, int flag, int *countp)
+{
+	struct pipe **lists = NULL;
+	o_string temp = NULL_O_STRING;
+	struct in_str input;
+	struct p_context ctx;
+	int count = 0;
+	int rcode;
+
+	setup_string_in_str(&input, s);
+	hush_cache_parsing = true;
+	do {
+		ctx.type = flag;
+		initialize_context(&ctx);
+		update_ifs_map();
+		if (!(flag & FLAG_PARSE_SEMICOLON) || (flag & FLAG_REPARSING))
+			mapset((uchar *)";$&|", 0);
+		input.promptmode = 1;
+		rcode = parse_stream(&temp, &ctx, &input,
+				     flag & FLAG_CONT_ON_NEWLINE ? -1 : '\n');
+		if (rcode == 1 || ctx.old_flag) {
+			if (ctx.old_flag)
+				free(ctx.stack);
+			free_pipe_list(ctx.list_head, 0);
+			b_free(&temp);
+			hush_cache_free_lists(lists, count);
+			lists = NULL;
+			break;
+		}
+		done_word(&temp, &ctx);
+		done_pipe(&ctx, PIPE_SEQ);
+		b_free(&temp);
+		lists = xrealloc(lists, sizeof(*lists) * (count + 1));
+		lists[count++] = ctx.list_head;
+	} while (rcode != -1 && !(flag & FLAG_EXIT_FROM_LOOP) && b_peek(&input));
+	hush_cache_parsing = false;
+	*countp = count;
+
+	return lists;
+}
+
+/**
+ * hush_cache_lookup() - Find a script in the cache, parsing it if needed
+ *
+ * @s: Script, ending in a newline
+ * @flag: Parse flags (FLAG_...)
+ * Return: cache entry, or NULL if the script cannot be cached
+ */
+static struct hush_cache_ent *hush_cache_lookup(const char *s, int flag)
+{
+	struct hush_cache_ent *ent, *victim = NULL;
+	struct pipe **lists;
+	int len = strlen(s);
+	uint hash = fnv1a(s, len);
+	int count, i;
+
+	for (i = 0; i < CONFIG_HUSH_PARSE_CACHE_SIZE; i++) {
+		ent = &hush_cache[i];
+		if (ent->text && ent->hash == hash && ent->len == len &&
+		    ent->flag == flag && !memcmp(ent->text, s, len))
+			return ent->busy ? NULL : ent;
+		if (ent->busy)
+			continue;
+		if (!victim || !ent->text ||
+		    (victim->text && ent->last_used < victim->last_used))
+			victim = ent;
+	}
+	if (!victim)
+		return NULL;
+
+	lists = hush_cache_parse(s, flag, &count);
+	if (!lists)
+		return NULL;
+	if (victim->text) {
+		free(victim->text);
+		hush_cache_free_lists(victim->lists, victim->count);
+	}
+	victim->text = xmalloc(len + 1);
+	strcpy(victim->text, s);
+	victim->len = len;
+	victim->hash = hash;
+	victim->flag = flag;
+	victim->lists = lists;
+	victim->count = count;
+
+	return victim;
+}
+
+/**
+ * hush_cache_run() - Run a script from the parse cache
+ *
+ * This runs each list of a script in turn, as parse_stream_outer() does,
+ * without parsing the script again. Scripts which use a different IFS, or
+ * are the result of substituting variables into a command, are not cached.
+ *
+ * @s: Script, ending in a newline
+ * @flag: Parse flags (FLAG_...)
+ * @rcodep: Returns the result, as for parse_stream_outer()
+ * Return: true if the script was run, false if it must be run normally
+ */
+static bool hush_cache_run(const char *s, int flag, int *rcodep)
+{
+	struct hush_cache_ent *ent;
+	int code = 1;
+	int i;
+
+	if ((flag & FLAG_REPARSING) || env_get("IFS"))
+		return false;
+	ent = hush_cache_lookup(s, flag);
+	if (!ent)
+		return false;
+
+	ent->busy++;
+	ent->last_used = ++hush_cache_tick;
+	for (i = 0; i < ent->count; i++) {
+		code = run_list_real(ent->lists[i]);
+		if (code == -2) {	/* exit */
+			ent->busy--;
+			*rcodep = -2;
+			return true;
+		}
+		if (code == -1)
+			flag_repeat = 0;
+	}
+	ent->busy--;
+	*rcodep = code != 0 ? 1 : 0;
+
+	return true;
+}
+#endif
+
 #ifndef __U_BOOT__
 static int parse_string_outer(const char *s, int flag)
 #else
@@ -3265,6 +3477,20 @@ int parse_string_outer(const char *s, int flag)
 		return 1;
 	if (!*s)
 		return 0;
+#if CONFIG_IS_ENABLED(HUSH_PARSE_CACHE)
+	if (!(p = strchr(s, '\n')) || *++p) {
+		p = xmalloc(strlen(s) + 2);
+		strcpy(p, s);
+		strcat(p, "\n");
+		if (hush_cache_run(p, flag, &rcode)) {
+			free(p);
+			return rcode == -2 ? last_return_code : rcode;
+		}
+		free(p);
+	} else if (hush_cache_run(s, flag, &rcode)) {
+		return rcode == -2 ? last_return_code : rcode;
+	}
+#endif
 	if (!(p = strchr(s, '\n')) || *++p) {
 		p = xmalloc(strlen(s) + 2);
 		strcpy(p, s);
@@ -18,6 +18,7 @@
 #include <linux/errno.h>
 #include <linux/list.h>
 #include <relocate.h>
+#include <time.h>
 
 DECLARE_GLOBAL_DATA_PTR;
 
@@ -65,14 +66,58 @@ const char *event_type_name(enum event_t type)
 #endif
 }
 
+/**
+ * setup_static() - Work out where the static spies for each event type are
+ *
+ * Linker-list entries are sorted by name and spy names start with the event
+ * type, so the spies for each type are normally next to each other. Record
+ * the range for each type so that notify_static() need not look at the
+ * others. The range covers all spies of that type even if they are not
+ * adjacent, so the result is the same either way.
+ *
+ * Indices are used rather than pointers so that the ranges remain valid
+ * after relocation.
+ *
+ * @state: Event state to update
+ */
+static void setup_static(struct event_state *state)
+{
+	struct evspy_info *start =
+		ll_entry_start(struct evspy_info, evspy_info);
+	const int n_ents = ll_entry_count(struct evspy_info, evspy_info);
+	int i;
+
+	memset(state->static_end, '\0', sizeof(state->static_end));
+	for (i = 0; i < n_ents; i++) {
+		uint type = start[i].type;
+
+		if (type >= EVT_COUNT)
+			continue;
+		if (!state->static_end[type])
+			state->static_first[type] = i;
+		state->static_end[type] = i + 1;
+	}
+	state->static_ready = true;
+}
+
 static int notify_static(struct event *ev)
 {
 	struct evspy_info *start =
 		ll_entry_start(struct evspy_info, evspy_info);
 	const int n_ents = ll_entry_count(struct evspy_info, evspy_info);
-	struct evspy_info *spy;
+	struct event_state *state = gd_event_state();
+	struct evspy_info *spy, *end;
+
+	spy = start;
+	end = start + n_ents;
+	if (ev->type < EVT_COUNT) {
+		if (!state->static_ready)
+			setup_static(state);
+		spy = start + state->static_first[ev->type];
+		end = start + state->static_end[ev->type];
+	}
 
-	for (spy = start; spy != start + n_ents; spy++) {
+	for (; spy < end; spy++) {
 		if (spy->type == ev->type) {
 			int ret;
 
@@ -101,36 +146,78 @@ static int notify_static(struct event *ev)
 	return 0;
 }
 
+#if CONFIG_IS_ENABLED(EVENT_DYNAMIC)
 static int notify_dynamic(struct event *ev)
 {
 	struct event_state *state = gd_event_state();
 	struct event_spy *spy, *next;
 
-	list_for_each_entry_safe(spy, next, &state->spy_head, sibling_node) {
-		if (spy->type == ev->type) {
-			int ret;
+	if (ev->type >= EVT_COUNT)
+		return 0;
 
-			log_debug("Sending event %x/%s to spy '%s'\n", ev->type,
-				  event_type_name(ev->type), spy->id);
-			ret = spy->func(spy->ctx, ev);
+	list_for_each_entry_safe(spy, next, &state->spy_head[ev->type],
+				 sibling_node) {
+		int ret;
 
-			/*
-			 * TODO: Handle various return codes to
-			 *
-			 * - claim an event (no others will see it)
-			 * - return an error from the event
-			 */
-			if (ret)
-				return log_msg_ret("spy", ret);
-		}
+		log_debug("Sending event %x/%s to spy '%s'\n", ev->type,
+			  event_type_name(ev->type), spy->id);
+		ret = spy->func(spy->ctx, ev);
+
+		/*
+		 * TODO: Handle various return codes to
+		 *
+		 * - claim an event (no others will see it)
+		 * - return an error from the event
+		 */
+		if (ret)
+			return log_msg_ret("spy", ret);
 	}
 
 	return 0;
 }
+#endif
+
+/**
+ * event_time_us() - Get the time for event statistics
+ *
+ * Events are sent while the timer itself is being set up, so avoid using it
+ * until it is ready.
+ *
+ * Return: time in microseconds, or 0 if the timer is not available yet
+ */
+static ulong event_time_us(void)
+{
+#ifdef CONFIG_TIMER
+	if (!gd->timer)
+		return 0;
+#endif
+	return timer_get_us();
+}
+
+static void update_stats(enum event_t type, ulong start)
+{
+#if CONFIG_IS_ENABLED(EVENT_STATS)
+	struct event_state *state = gd_event_state();
+	struct event_stats *stats;
+	ulong now, delta;
+
+	if (type >= EVT_COUNT)
+		return;
+	stats = &state->stats[type];
+	stats->count++;
+	now = event_time_us();
+	if (start && now) {
+		delta = now - start;
+		stats->time_us += delta;
+		stats->max_us = max(stats->max_us, delta);
+	}
+#endif
+}
 
 int event_notify(enum event_t type, void *data, int size)
 {
 	struct event event;
+	ulong start = 0;
 	int ret;
 
 	event.type = type;
@@ -138,15 +225,19 @@ int event_notify(enum event_t type, void *data, int size)
 		return log_msg_ret("size", -E2BIG);
 	memcpy(&event.data, data, size);
 
+	if (CONFIG_IS_ENABLED(EVENT_STATS))
+		start = event_time_us();
+
 	ret = notify_static(&event);
 	if (ret)
 		return log_msg_ret("sta", ret);
 
-	if (CONFIG_IS_ENABLED(EVENT_DYNAMIC)) {
-		ret = notify_dynamic(&event);
-		if (ret)
-			return log_msg_ret("dyn", ret);
-	}
+#if CONFIG_IS_ENABLED(EVENT_DYNAMIC)
+	ret = notify_dynamic(&event);
+	if (ret)
+		return log_msg_ret("dyn", ret);
+#endif
+	update_stats(type, start);
 
 	return 0;
 }
@@ -172,6 +263,32 @@ void event_show_spy_list(void)
 	}
 }
 
+const struct event_stats *event_get_stats(enum event_t type)
+{
+#if CONFIG_IS_ENABLED(EVENT_STATS)
+	if (type < EVT_COUNT)
+		return &gd_event_state()->stats[type];
+#endif
+	return NULL;
+}
+
+void event_show_stats(void)
+{
+	const struct event_stats *stats;
+	int type;
+
+	printf("%-24s  %8s  %10s  %8s\n", "Type", "Count", "Total us",
+	       "Max us");
+	for (type = 0; type < EVT_COUNT; type++) {
+		stats = event_get_stats(type);
+		if (!stats || !stats->count)
+			continue;
+		printf("%-3x %-20s  %8u  %10lu  %8lu\n", type,
+		       event_type_name(type), stats->count, stats->time_us,
+		       stats->max_us);
+	}
+}
+
 #if CONFIG_IS_ENABLED(EVENT_DYNAMIC)
 static void spy_free(struct event_spy *spy)
 {
@@ -183,6 +300,8 @@ int event_register(const char *id, enum event_t type, event_handler_t func, void
 	struct event_state *state = gd_event_state();
 	struct event_spy *spy;
 
+	if (type >= EVT_COUNT)
+		return log_msg_ret("type", -EINVAL);
 	spy = malloc(sizeof(*spy));
 	if (!spy)
 		return log_msg_ret("alloc", -ENOMEM);
@@ -191,7 +310,7 @@ int event_register(const char *id, enum event_t type, event_handler_t func, void
 	spy->type = type;
 	spy->func = func;
 	spy->ctx = ctx;
-	list_add_tail(&spy->sibling_node, &state->spy_head);
+	list_add_tail(&spy->sibling_node, &state->spy_head[type]);
 
 	return 0;
 }
@@ -200,9 +319,13 @@ int event_uninit(void)
 {
 	struct event_state *state = gd_event_state();
 	struct event_spy *spy, *next;
+	int type;
 
-	list_for_each_entry_safe(spy, next, &state->spy_head, sibling_node)
-		spy_free(spy);
+	for (type = 0; type < EVT_COUNT; type++) {
+		list_for_each_entry_safe(spy, next, &state->spy_head[type],
+					 sibling_node)
+			spy_free(spy);
+	}
 
 	return 0;
 }
@@ -210,8 +333,10 @@ int event_uninit(void)
 int event_init(void)
 {
 	struct event_state *state = gd_event_state();
+	int type;
 
-	INIT_LIST_HEAD(&state->spy_head);
+	for (type = 0; type < EVT_COUNT; type++)
+		INIT_LIST_HEAD(&state->spy_head[type]);
 
 	return 0;
 }
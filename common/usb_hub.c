@@ -60,6 +60,9 @@ struct usb_device_scan {
 
 static LIST_HEAD(usb_scan_list);
 
+/* Set while ports are being queued for a combined scan of all controllers */
+static bool usb_scan_deferred;
+
 __weak void usb_hub_reset_devices(struct usb_hub_device *hub, int port)
 {
 	return;
@@ -574,7 +577,7 @@ static int usb_device_list_scan(void)
 	int ret = 0;
 
 	/* Only run this loop once for each controller */
-	if (running)
+	if (running || usb_scan_deferred)
 		return 0;
 
 	running = 1;
@@ -936,6 +939,29 @@ int usb_hub_probe(struct usb_device *dev, int ifnum)
 }
 
 #if CONFIG_IS_ENABLED(DM_USB)
+void usb_hub_scan_begin(void)
+{
+	usb_scan_deferred = true;
+}
+
+int usb_hub_scan_complete(void)
+{
+	usb_scan_deferred = false;
+
+	return usb_device_list_scan();
+}
+
+void usb_hub_scan_abort(void)
+{
+	struct usb_device_scan *usb_scan, *tmp;
+
+	list_for_each_entry_safe(usb_scan, tmp, &usb_scan_list, list) {
+		list_del(&usb_scan->list);
+		free(usb_scan);
+	}
+	usb_scan_deferred = false;
+}
+
 int usb_hub_scan(struct udevice *hub)
 {
 	struct usb_device *udev = dev_get_parent_priv(hub);
@@ -122,6 +122,27 @@ unsigned long disk_blk_erase(struct udevice *dev, lbaint_t start,
 			 blkcnt);
 }
 
+/**
+ * disk_blk_zero() - Set part of a block device to zero
+ *
+ * @dev: Device to update (partition udevice)
+ * @start: Start block to zero (from start of partition)
+ * @blkcnt: Number of blocks to zero (within the partition)
+ * @return number of blocks zeroed (which may be less than @blkcnt),
+ * or -ve on error. This never returns 0 unless @blkcnt is 0
+ */
+unsigned long disk_blk_zero(struct udevice *dev, lbaint_t start,
+			    lbaint_t blkcnt)
+{
+	int ret = disk_blk_part_validate(dev, start, blkcnt);
+
+	if (ret)
+		return ret;
+
+	return blk_zero(dev_get_parent(dev), disk_blk_part_offset(dev, start),
+			blkcnt);
+}
+
 UCLASS_DRIVER(partition) = {
 	.id		= UCLASS_PARTITION,
 	.per_device_plat_auto	= sizeof(struct disk_part),
@@ -132,6 +153,7 @@ static const struct blk_ops blk_part_ops = {
 	.read	= disk_blk_read,
 	.write	= disk_blk_write,
 	.erase	= disk_blk_erase,
+	.zero	= disk_blk_zero,
 };
 
 U_BOOT_DRIVER(blk_partition) = {
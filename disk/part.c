@@ -8,6 +8,7 @@
 #include <command.h>
 #include <env.h>
 #include <errno.h>
+#include <fs.h>
 #include <ide.h>
 #include <log.h>
 #include <malloc.h>
@@ -284,6 +285,8 @@ void part_init(struct blk_desc *desc)
 	struct part_driver *entry;
 
 	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	gpt_cache_invalidate(desc);
+	fs_cache_invalidate(desc);
 
 	if (desc->part_type != PART_TYPE_UNKNOWN) {
 		for (entry = drv; entry != drv + n_ents; entry++) {
@@ -680,6 +683,15 @@ int part_get_info_by_name(struct blk_desc *desc, const char *name,
 		return -ENOSYS;
 	}
 
+	if (part_drv->find_by_name) {
+		i = part_drv->find_by_name(desc, name);
+		if (i < 0)
+			return i;
+		ret = part_drv->get_info(desc, i, info);
+
+		return ret ? ret : i;
+	}
+
 	for (i = 1; i < part_drv->max_entries; i++) {
 		ret = part_drv->get_info(desc, i, info);
 		if (ret != 0) {
@@ -698,6 +710,41 @@ int part_get_info_by_name(struct blk_desc *desc, const char *name,
 	return -ENOENT;
 }
 
+int part_get_info_by_uuid(struct blk_desc *desc, const char *uuid,
+			  struct disk_partition *info)
+{
+	struct part_driver *part_drv;
+	int ret;
+	int i;
+
+	if (!CONFIG_IS_ENABLED(PARTITION_UUIDS))
+		return -ENOSYS;
+
+	part_drv = part_driver_lookup_type(desc);
+	if (!part_drv)
+		return -ENOENT;
+	if (!part_drv->get_info)
+		return -ENOSYS;
+
+	if (part_drv->find_by_uuid) {
+		i = part_drv->find_by_uuid(desc, uuid);
+		if (i < 0)
+			return i;
+		ret = part_drv->get_info(desc, i, info);
+
+		return ret ? ret : i;
+	}
+
+	for (i = 1; i < part_drv->max_entries; i++) {
+		if (part_drv->get_info(desc, i, info))
+			continue;
+		if (!strcasecmp(uuid, disk_partition_uuid(info)))
+			return i;
+	}
+
+	return -ENOENT;
+}
+
 /**
  * Get partition info from device number and partition name.
  *
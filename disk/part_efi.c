@@ -61,6 +61,7 @@ static gpt_entry *alloc_read_gpt_entries(struct blk_desc *desc,
 static int is_pte_valid(gpt_entry * pte);
 static int find_valid_gpt(struct blk_desc *desc, gpt_header *gpt_head,
 			  gpt_entry **pgpt_pte);
+static void put_gpt_ptes(gpt_entry *gpt_pte);
 
 static char *print_efiname(gpt_entry *pte)
 {
@@ -211,8 +212,7 @@ int get_disk_guid(struct blk_desc *desc, char *guid)
 	guid_bin = gpt_head->disk_guid.b;
 	uuid_bin_to_str(guid_bin, guid, UUID_STR_FORMAT_GUID);
 
-	/* Remember to free pte */
-	free(gpt_pte);
+	put_gpt_ptes(gpt_pte);
 	return 0;
 }
 
@@ -253,8 +253,7 @@ void part_print_efi(struct blk_desc *desc)
 		printf("\tguid:\t%pUl\n", uuid);
 	}
 
-	/* Remember to free pte */
-	free(gpt_pte);
+	put_gpt_ptes(gpt_pte);
 	return;
 }
 
@@ -277,7 +276,7 @@ int part_get_info_efi(struct blk_desc *desc, int part,
 	if (part > le32_to_cpu(gpt_head->num_partition_entries) ||
 	    !is_pte_valid(&gpt_pte[part - 1])) {
 		log_debug("Invalid partition number %d\n", part);
-		free(gpt_pte);
+		put_gpt_ptes(gpt_pte);
 		return -EPERM;
 	}
 
@@ -306,11 +305,67 @@ int part_get_info_efi(struct blk_desc *desc, int part,
 	log_debug("start 0x" LBAF ", size 0x" LBAF ", name %s\n", info->start,
 		  info->size, info->name);
 
-	/* Remember to free pte */
-	free(gpt_pte);
+	put_gpt_ptes(gpt_pte);
 	return 0;
 }
 
+static int __maybe_unused part_find_by_name_efi(struct blk_desc *desc,
+						 const char *name)
+{
+	ALLOC_CACHE_ALIGN_BUFFER_PAD(gpt_header, gpt_head, 1, desc->blksz);
+	char part_name[PART_NAME_LEN];
+	gpt_entry *gpt_pte = NULL;
+	int ret = -ENOENT;
+	int i;
+
+	if (find_valid_gpt(desc, gpt_head, &gpt_pte) != 1)
+		return -ENOENT;
+
+	for (i = 0; i < le32_to_cpu(gpt_head->num_partition_entries); i++) {
+		if (!is_pte_valid(&gpt_pte[i]))
+			continue;
+
+		/* Truncate the name in the same way as part_get_info_efi() */
+		snprintf(part_name, sizeof(part_name), "%s",
+			 print_efiname(&gpt_pte[i]));
+		if (!strcmp(name, part_name)) {
+			ret = i + 1;
+			break;
+		}
+	}
+	put_gpt_ptes(gpt_pte);
+
+	return ret;
+}
+
+static int __maybe_unused part_find_by_uuid_efi(struct blk_desc *desc,
+						 const char *uuid)
+{
+	ALLOC_CACHE_ALIGN_BUFFER_PAD(gpt_header, gpt_head, 1, desc->blksz);
+	gpt_entry *gpt_pte = NULL;
+	efi_guid_t guid;
+	int ret = -ENOENT;
+	int i;
+
+	if (uuid_str_to_bin(uuid, guid.b, UUID_STR_FORMAT_GUID))
+		return -EINVAL;
+
+	if (find_valid_gpt(desc, gpt_head, &gpt_pte) != 1)
+		return -ENOENT;
+
+	for (i = 0; i < le32_to_cpu(gpt_head->num_partition_entries); i++) {
+		if (is_pte_valid(&gpt_pte[i]) &&
+		    !memcmp(&gpt_pte[i].unique_partition_guid, &guid,
+			    sizeof(guid))) {
+			ret = i + 1;
+			break;
+		}
+	}
+	put_gpt_ptes(gpt_pte);
+
+	return ret;
+}
+
 static int part_test_efi(struct blk_desc *desc)
 {
 	ALLOC_CACHE_ALIGN_BUFFER_PAD(legacy_mbr, legacymbr, 1, desc->blksz);
@@ -1085,15 +1140,15 @@ static int is_gpt_valid(struct blk_desc *desc, u64 lba, gpt_header *pgpt_head,
 }
 
 /**
- * find_valid_gpt() - finds a valid GPT header and PTEs
+ * read_valid_gpt() - reads a valid GPT header and PTEs from the device
  *
  * gpt is a GPT header ptr, filled on return.
  * ptes is a PTEs ptr, filled on return.
  *
  * Description: returns 1 if found a valid gpt,  0 on error.
- * If valid, returns pointers to PTEs.
+ * If valid, returns pointers to PTEs, which must be freed by the caller.
  */
-static int find_valid_gpt(struct blk_desc *desc, gpt_header *gpt_head,
+static int read_valid_gpt(struct blk_desc *desc, gpt_header *gpt_head,
 			  gpt_entry **pgpt_pte)
 {
 	int r;
@@ -1116,6 +1171,112 @@ static int find_valid_gpt(struct blk_desc *desc, gpt_header *gpt_head,
 	return 1;
 }
 
+#if CONFIG_IS_ENABLED(PARTITION_GPT_CACHE)
+/**
+ * struct gpt_cache - A valid GPT read from a block device
+ *
+ * @sibling: Node in gpt_cache_list
+ * @desc: Block device the GPT was read from
+ * @hwpart: Hardware partition which was selected when the GPT was read
+ * @lba: Number of blocks in the device when the GPT was read
+ * @head: GPT header
+ * @pte: Partition table entries
+ */
+struct gpt_cache {
+	struct list_head sibling;
+	struct blk_desc *desc;
+	int hwpart;
+	lbaint_t lba;
+	gpt_header head;
+	gpt_entry *pte;
+};
+
+static LIST_HEAD(gpt_cache_list);
+
+static void gpt_cache_drop(struct gpt_cache *gc)
+{
+	list_del(&gc->sibling);
+	free(gc->pte);
+	free(gc);
+}
+
+void gpt_cache_invalidate(struct blk_desc *desc)
+{
+	struct gpt_cache *gc, *next;
+
+	list_for_each_entry_safe(gc, next, &gpt_cache_list, sibling) {
+		if (!desc || gc->desc == desc)
+			gpt_cache_drop(gc);
+	}
+}
+
+/**
+ * find_valid_gpt() - finds a valid GPT header and PTEs
+ *
+ * The GPT is read from the device the first time and then held in the cache
+ * until it is invalidated, so the caller must not change the PTEs
+ *
+ * gpt is a GPT header ptr, filled on return.
+ * ptes is a PTEs ptr, filled on return.
+ *
+ * Description: returns 1 if found a valid gpt,  0 on error.
+ * If valid, returns pointers to PTEs, to be released with put_gpt_ptes()
+ */
+static int find_valid_gpt(struct blk_desc *desc, gpt_header *gpt_head,
+			  gpt_entry **pgpt_pte)
+{
+	struct gpt_cache *gc;
+
+	list_for_each_entry(gc, &gpt_cache_list, sibling) {
+		if (gc->desc != desc)
+			continue;
+		if (gc->hwpart == desc->hwpart && gc->lba == desc->lba) {
+			memcpy(gpt_head, &gc->head, sizeof(gc->head));
+			*pgpt_pte = gc->pte;
+			return 1;
+		}
+
+		/* The device has changed since the GPT was read */
+		gpt_cache_drop(gc);
+		break;
+	}
+
+	gc = calloc(1, sizeof(*gc));
+	if (!gc) {
+		log_debug("Can't allocate GPT cache\n");
+		return 0;
+	}
+	if (read_valid_gpt(desc, gpt_head, pgpt_pte) != 1) {
+		free(gc);
+		return 0;
+	}
+	gc->desc = desc;
+	gc->hwpart = desc->hwpart;
+	gc->lba = desc->lba;
+	memcpy(&gc->head, gpt_head, sizeof(gc->head));
+	gc->pte = *pgpt_pte;
+	list_add(&gc->sibling, &gpt_cache_list);
+
+	return 1;
+}
+
+static void put_gpt_ptes(gpt_entry *gpt_pte)
+{
+	/* The PTEs belong to the cache */
+}
+#else
+static int find_valid_gpt(struct blk_desc *desc, gpt_header *gpt_head,
+			  gpt_entry **pgpt_pte)
+{
+	return read_valid_gpt(desc, gpt_head, pgpt_pte);
+}
+
+static void put_gpt_ptes(gpt_entry *gpt_pte)
+{
+	free(gpt_pte);
+}
+#endif
+
 /**
  * alloc_read_gpt_entries(): reads partition entries from disk
  * @desc
@@ -1210,6 +1371,8 @@ U_BOOT_PART_TYPE(a_efi) = {
 	.part_type	= PART_TYPE_EFI,
 	.max_entries	= GPT_ENTRY_NUMBERS,
 	.get_info	= part_get_info_ptr(part_get_info_efi),
+	.find_by_name	= part_get_info_ptr(part_find_by_name_efi),
+	.find_by_uuid	= part_get_info_ptr(part_find_by_uuid_efi),
 	.print		= part_print_ptr(part_print_efi),
 	.test		= part_test_efi,
 };
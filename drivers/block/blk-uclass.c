@@ -8,6 +8,7 @@
 
 #include <blk.h>
 #include <dm.h>
+#include <fs.h>
 #include <log.h>
 #include <malloc.h>
 #include <part.h>
@@ -322,13 +323,20 @@ int blk_show_device(enum uclass_id uclass_id, int devnum)
 int blk_select_hwpart(struct udevice *dev, int hwpart)
 {
 	const struct blk_ops *ops = blk_get_ops(dev);
+	int ret;
 
 	if (!ops)
 		return -ENOSYS;
 	if (!ops->select_hwpart)
 		return 0;
 
-	return ops->select_hwpart(dev, hwpart);
+	ret = ops->select_hwpart(dev, hwpart);
+	if (!ret) {
+		gpt_cache_invalidate(dev_get_uclass_plat(dev));
+		fs_cache_invalidate(dev_get_uclass_plat(dev));
+	}
+
+	return ret;
 }
 
 int blk_dselect_hwpart(struct blk_desc *desc, int hwpart)
@@ -478,6 +486,8 @@ long blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
 		return -ENOSYS;
 
 	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	gpt_cache_invalidate(desc);
+	fs_cache_invalidate(desc);
 
 	if (IS_ENABLED(CONFIG_BOUNCE_BUFFER) && desc->bb) {
 		struct blk_bounce_buffer bbstate = { .dev = dev };
@@ -510,10 +520,27 @@ long blk_erase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt)
 		return -ENOSYS;
 
 	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	gpt_cache_invalidate(desc);
+	fs_cache_invalidate(desc);
 
 	return ops->erase(dev, start, blkcnt);
 }
 
+long blk_zero(struct udevice *dev, lbaint_t start, lbaint_t blkcnt)
+{
+	struct blk_desc *desc = dev_get_uclass_plat(dev);
+	const struct blk_ops *ops = blk_get_ops(dev);
+
+	if (!ops->zero)
+		return -ENOSYS;
+
+	blkcache_invalidate(desc->uclass_id, desc->devnum);
+	gpt_cache_invalidate(desc);
+	fs_cache_invalidate(desc);
+
+	return ops->zero(dev, start, blkcnt);
+}
+
 ulong blk_dread(struct blk_desc *desc, lbaint_t start, lbaint_t blkcnt,
 		void *buffer)
 {
@@ -531,6 +558,11 @@ ulong blk_derase(struct blk_desc *desc, lbaint_t start, lbaint_t blkcnt)
 	return blk_erase(desc->bdev, start, blkcnt);
 }
 
+long blk_dzero(struct blk_desc *desc, lbaint_t start, lbaint_t blkcnt)
+{
+	return blk_zero(desc->bdev, start, blkcnt);
+}
+
 int blk_find_from_parent(struct udevice *parent, struct udevice **devp)
 {
 	struct udevice *dev;
@@ -852,9 +884,20 @@ static int blk_post_probe(struct udevice *dev)
 	return 0;
 }
 
+static int blk_pre_unbind(struct udevice *dev)
+{
+	struct blk_desc *desc = dev_get_uclass_plat(dev);
+
+	gpt_cache_invalidate(desc);
+	fs_cache_invalidate(desc);
+
+	return 0;
+}
+
 UCLASS_DRIVER(blk) = {
 	.id		= UCLASS_BLK,
 	.name		= "blk",
 	.post_probe	= blk_post_probe,
+	.pre_unbind	= blk_pre_unbind,
 	.per_device_plat_auto	= sizeof(struct blk_desc),
 };
@@ -231,9 +231,18 @@ int device_remove(struct udevice *dev, uint flags)
 		return ret;
 	}
 
-	ret = uclass_pre_remove_device(dev);
-	if (ret)
-		return ret;
+	/*
+	 * A device whose probe is still pending has not been seen by its
+	 * uclass yet, so just stop polling it and let the driver tidy up
+	 */
+	if (CONFIG_IS_ENABLED(DM_PROBE_ASYNC) &&
+	    (dev_get_flags(dev) & DM_FLAG_PROBE_PENDING)) {
+		device_probe_cancel(dev);
+	} else {
+		ret = uclass_pre_remove_device(dev);
+		if (ret)
+			return ret;
+	}
 
 	if (drv->remove) {
 		ret = drv->remove(dev);
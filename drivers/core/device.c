@@ -9,6 +9,7 @@
  */
 
 #include <cpu_func.h>
+#include <cyclic.h>
 #include <errno.h>
 #include <event.h>
 #include <log.h>
@@ -230,6 +231,7 @@ fail_alloc2:
 		}
 	}
 fail_alloc1:
+	dev_ofnode_index_del(dev);
 	devres_release_all(dev);
 
 	free(dev);
@@ -478,7 +480,109 @@ static int device_get_dma_constraints(struct udevice *dev)
 	return 0;
 }
 
-int device_probe(struct udevice *dev)
+/**
+ * device_probe_undo() - Undo a failed probe
+ *
+ * @dev: Device whose probe failed
+ * @remove: true to call device_remove() first, since the driver's probe()
+ *	method succeeded
+ */
+static void device_probe_undo(struct udevice *dev, bool remove)
+{
+	if (remove && device_remove(dev, DM_REMOVE_NORMAL)) {
+		dm_warn("%s: Device '%s' failed to remove on error path\n",
+			__func__, dev->name);
+	}
+	dev_bic_flags(dev, DM_FLAG_ACTIVATED);
+
+	device_free(dev);
+}
+
+/**
+ * device_probe_finish() - Finish probing a device after its driver is ready
+ *
+ * This runs the steps which follow the driver's probe() method, or its
+ * probe_complete() method for a driver with DM_FLAG_PROBE_ASYNC
+ *
+ * @dev: Device to finish
+ * Return: 0 if OK, -ve on error, in which case the probe is undone
+ */
+static int device_probe_finish(struct udevice *dev)
+{
+	int ret;
+
+	ret = uclass_post_probe_device(dev);
+	if (ret)
+		goto fail;
+
+	if (dev->parent && device_get_uclass_id(dev) == UCLASS_PINCTRL) {
+		ret = pinctrl_select_state(dev, "default");
+		if (ret && ret != -ENOSYS)
+			log_debug("Device '%s' failed to configure default pinctrl: %d (%s)\n",
+				  dev->name, ret, errno_str(ret));
+	}
+
+	ret = device_notify(dev, EVT_DM_POST_PROBE);
+	if (ret)
+		goto fail;
+
+	return 0;
+fail:
+	device_probe_undo(dev, true);
+
+	return ret;
+}
+
+int device_probe_complete(struct udevice *dev)
+{
+	int ret;
+
+	/* Already finished, e.g. joined while the poller was running */
+	if (!(dev_get_flags(dev) & DM_FLAG_PROBE_PENDING))
+		return 0;
+
+	ret = dev->driver->probe_complete(dev);
+	if (ret == -EAGAIN)
+		return ret;
+	dev_bic_flags(dev, DM_FLAG_PROBE_PENDING);
+	if (ret) {
+		/* As with probe(), the driver tidies up if this fails */
+		device_probe_undo(dev, false);
+		return ret;
+	}
+
+	return device_probe_finish(dev);
+}
+
+int device_probe_join(struct udevice *dev)
+{
+	int ret;
+
+	device_probe_dequeue(dev);
+	while (ret = device_probe_complete(dev), ret == -EAGAIN)
+		schedule();
+	if (ret)
+		return log_msg_ret("dpj", ret);
+
+	return 0;
+}
+
+/**
+ * device_probe_activated() - Check the state of an activated device
+ *
+ * @dev: Device which has DM_FLAG_ACTIVATED set
+ * @async: true if the caller is happy for the probe to still be pending
+ * Return: 0 if OK, -ve if a pending probe failed
+ */
+static int device_probe_activated(struct udevice *dev, bool async)
+{
+	if (!async && (dev_get_flags(dev) & DM_FLAG_PROBE_PENDING))
+		return device_probe_join(dev);
+
+	return 0;
+}
+
+static int _device_probe(struct udevice *dev, bool async)
 {
 	const struct driver *drv;
 	int ret;
@@ -487,7 +591,7 @@ int device_probe(struct udevice *dev)
 		return -EINVAL;
 
 	if (dev_get_flags(dev) & DM_FLAG_ACTIVATED)
-		return 0;
+		return device_probe_activated(dev, async);
 
 	ret = device_notify(dev, EVT_DM_PRE_PROBE);
 	if (ret)
@@ -513,7 +617,7 @@ int device_probe(struct udevice *dev)
 		 * so that we don't mess up the device.
 		 */
 		if (dev_get_flags(dev) & DM_FLAG_ACTIVATED)
-			return 0;
+			return device_probe_activated(dev, async);
 	}
 
 	dev_or_flags(dev, DM_FLAG_ACTIVATED);
@@ -586,36 +690,32 @@ int device_probe(struct udevice *dev)
 			goto fail;
 	}
 
-	ret = uclass_post_probe_device(dev);
-	if (ret)
-		goto fail_uclass;
+	/* Without CONFIG_DM_PROBE_ASYNC nothing is queued, so wait here */
+	if ((drv->flags & DM_FLAG_PROBE_ASYNC) && drv->probe_complete) {
+		dev_or_flags(dev, DM_FLAG_PROBE_PENDING);
+		if (async && !device_probe_queue(dev))
+			return 0;
 
-	if (dev->parent && device_get_uclass_id(dev) == UCLASS_PINCTRL) {
-		ret = pinctrl_select_state(dev, "default");
-		if (ret && ret != -ENOSYS)
-			log_debug("Device '%s' failed to configure default pinctrl: %d (%s)\n",
-				  dev->name, ret, errno_str(ret));
+		return device_probe_join(dev);
 	}
 
-	ret = device_notify(dev, EVT_DM_POST_PROBE);
-	if (ret)
-		goto fail_event;
-
-	return 0;
-fail_event:
-fail_uclass:
-	if (device_remove(dev, DM_REMOVE_NORMAL)) {
-		dm_warn("%s: Device '%s' failed to remove on error path\n",
-			__func__, dev->name);
-	}
+	return device_probe_finish(dev);
 fail:
-	dev_bic_flags(dev, DM_FLAG_ACTIVATED);
-
-	device_free(dev);
+	device_probe_undo(dev, false);
 
 	return ret;
 }
 
+int device_probe(struct udevice *dev)
+{
+	return _device_probe(dev, false);
+}
+
+int device_probe_async(struct udevice *dev)
+{
+	return _device_probe(dev, true);
+}
+
 void *dev_get_plat(const struct udevice *dev)
 {
 	if (!dev) {
@@ -895,9 +995,23 @@ static struct udevice *_device_find_global_by_ofnode(struct udevice *parent,
 	return NULL;
 }
 
+static struct udevice *device_find_global(ofnode ofnode)
+{
+	struct udevice *dev;
+	int ret;
+
+	ret = dev_ofnode_index_find(ofnode, UCLASS_INVALID, &dev);
+	if (!ret)
+		return dev;
+	if (ret == -ENODEV)
+		return NULL;
+
+	return _device_find_global_by_ofnode(gd->dm_root, ofnode);
+}
+
 int device_find_global_by_ofnode(ofnode ofnode, struct udevice **devp)
 {
-	*devp = _device_find_global_by_ofnode(gd->dm_root, ofnode);
+	*devp = device_find_global(ofnode);
 
 	return *devp ? 0 : -ENOENT;
 }
@@ -906,7 +1020,7 @@ int device_get_global_by_ofnode(ofnode ofnode, struct udevice **devp)
 {
 	struct udevice *dev;
 
-	dev = _device_find_global_by_ofnode(gd->dm_root, ofnode);
+	dev = device_find_global(ofnode);
 	return device_get_device_tail(dev, dev ? 0 : -ENOENT, devp);
 }
 
@@ -6,6 +6,7 @@
 #include <dm.h>
 #include <malloc.h>
 #include <mapmem.h>
+#include <of_live.h>
 #include <sort.h>
 #include <dm/root.h>
 #include <dm/util.h>
@@ -355,4 +356,17 @@ void dm_dump_mem(struct dm_stats *stats)
 	/* Drop the device name */
 	printf("Drop device name (not SRAM): %x (%d)\n", stats->dev_name_size,
 	       stats->dev_name_size);
+
+	if (IS_ENABLED(CONFIG_OF_LIVE) && !IS_ENABLED(CONFIG_XPL_BUILD) &&
+	    of_live_active()) {
+		struct of_live_stats live;
+
+		of_live_get_stats(&live);
+		printf("\nLive tree: %lx (%ld)\n", live.tree_size,
+		       live.tree_size);
+		if (live.lazy)
+			printf("- loaded on demand: %x nodes, %lx (%ld)\n",
+			       live.nodes_loaded, live.props_size,
+			       live.props_size);
+	}
 }
@@ -15,10 +15,17 @@
 #include <dm/device-internal.h>
 #include <dm/lists.h>
 #include <dm/platdata.h>
+#include <dm/snapshot.h>
 #include <dm/uclass.h>
 #include <dm/util.h>
 #include <fdtdec.h>
+#include <malloc.h>
+#include <asm/global_data.h>
 #include <linux/compiler.h>
+#include <linux/err.h>
+#include <u-boot/fnv.h>
+
+DECLARE_GLOBAL_DATA_PTR;
 
 struct driver *lists_driver_lookup_name(const char *name)
 {
@@ -196,6 +203,142 @@ static int driver_check_compatible(const struct udevice_id *of_match,
 	return -ENOENT;
 }
 
+/**
+ * struct dm_compat_entry - an entry in the compatible-string index
+ *
+ * @id: of_match entry holding the compatible string
+ * @drv: driver which owns @id
+ * @next: index of the next entry in the same hash bucket, or -1 if none
+ */
+struct dm_compat_entry {
+	const struct udevice_id *id;
+	struct driver *drv;
+	int next;
+};
+
+/**
+ * struct dm_compat_index - hash index of all driver compatible strings
+ *
+ * Each bucket is a chain of entries in linker-list order, so the first match
+ * found is the same driver that a linear search would find.
+ *
+ * @mask: number of buckets - 1 (the number of buckets is a power of two)
+ * @buckets: index of the first entry in each bucket, or -1 if none
+ * @entry: entries, one for each compatible string of each driver
+ */
+struct dm_compat_index {
+	uint mask;
+	int *buckets;
+	struct dm_compat_entry entry[];
+};
+
+static uint dm_compat_hash(const char *str)
+{
+	return fnv1a(str, strlen(str));
+}
+
+/**
+ * dm_compat_index_get() - Get the compatible-string index, building it if needed
+ *
+ * The index is built on first use in each phase and lives in the malloc()
+ * heap. If there is not enough memory, the caller falls back to a linear
+ * search.
+ *
+ * Return: index, or NULL if not available
+ */
+static struct dm_compat_index *dm_compat_index_get(void)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct dm_compat_index *idx = gd_dm_compat_index();
+	const struct udevice_id *id;
+	struct driver *entry;
+	uint count, size;
+	int i;
+
+	if (IS_ERR(idx))
+		return NULL;
+	if (idx)
+		return idx;
+
+	count = 0;
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (id = entry->of_match; id && id->compatible; id++)
+			count++;
+	}
+	for (size = 1; size < count; size <<= 1)
+		;
+
+	idx = malloc(sizeof(*idx) + count * sizeof(struct dm_compat_entry) +
+		     size * sizeof(int));
+	if (!idx) {
+		log_debug("No memory for compatible index (%u entries)\n",
+			  count);
+		gd_set_dm_compat_index(ERR_PTR(-ENOMEM));
+		return NULL;
+	}
+	idx->mask = size - 1;
+	idx->buckets = (int *)&idx->entry[count];
+	memset(idx->buckets, '\xff', size * sizeof(int));
+
+	/* Add drivers in reverse so that each chain ends up in list order */
+	i = count;
+	for (entry = driver + n_ents; entry-- != driver;) {
+		const struct udevice_id *start = entry->of_match;
+
+		if (!start)
+			continue;
+		for (id = start; id->compatible; id++)
+			;
+		while (id-- != start) {
+			struct dm_compat_entry *ent = &idx->entry[--i];
+			uint bucket = dm_compat_hash(id->compatible) & idx->mask;
+
+			ent->id = id;
+			ent->drv = entry;
+			ent->next = idx->buckets[bucket];
+			idx->buckets[bucket] = i;
+		}
+	}
+	log_debug("Compatible index: %u entries, %u buckets\n", count, size);
+	gd_set_dm_compat_index(idx);
+
+	return idx;
+}
+
+struct driver *lists_driver_lookup_compat(const char *compat,
+					  const struct udevice_id **idp)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	struct dm_compat_index *idx = NULL;
+	struct driver *entry;
+
+	if (CONFIG_IS_ENABLED(DM_COMPAT_INDEX))
+		idx = dm_compat_index_get();
+	if (idx) {
+		int i = idx->buckets[dm_compat_hash(compat) & idx->mask];
+
+		for (; i != -1; i = idx->entry[i].next) {
+			struct dm_compat_entry *ent = &idx->entry[i];
+
+			if (!strcmp(ent->id->compatible, compat)) {
+				*idp = ent->id;
+				return ent->drv;
+			}
+		}
+
+		return NULL;
+	}
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		if (!driver_check_compatible(entry->of_match, idp, compat))
+			return entry;
+	}
+
+	return NULL;
+}
+
 int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 		   struct driver *drv, bool pre_reloc_only)
 {
@@ -227,6 +370,27 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 		return compat_length;
 	}
 
+	/* Use the driver chosen by the previous phase, if available */
+	if (!drv && !dm_snapshot_lookup(node, &entry, &id)) {
+		if (pre_reloc_only && !ofnode_pre_reloc(node) &&
+		    !(entry->flags & DM_FLAG_PRE_RELOC))
+			return 0;
+		ret = device_bind_with_driver_data(parent, entry, name,
+						   id->data, node, &dev);
+		if (!ret) {
+			log_debug("   - bound driver '%s' from snapshot\n",
+				  entry->name);
+			if (devp)
+				*devp = dev;
+			return 0;
+		}
+		if (ret != -ENODEV) {
+			dm_warn("Error binding driver '%s': %d\n", entry->name,
+				ret);
+			return log_msg_ret("snap", ret);
+		}
+	}
+
 	/*
 	 * Walk through the compatible string list, attempting to match each
 	 * compatible string in order such that we match in order of priority
@@ -238,20 +402,24 @@ int lists_bind_fdt(struct udevice *parent, ofnode node, struct udevice **devp,
 			  compat);
 
 		id = NULL;
-		for (entry = driver; entry != driver + n_ents; entry++) {
-			if (drv) {
+		if (!drv) {
+			entry = lists_driver_lookup_compat(compat, &id);
+			if (!entry)
+				continue;
+		} else {
+			for (entry = driver; entry != driver + n_ents; entry++) {
 				if (drv != entry)
 					continue;
 				if (!entry->of_match)
 					break;
+				ret = driver_check_compatible(entry->of_match,
+							      &id, compat);
+				if (!ret)
+					break;
 			}
-			ret = driver_check_compatible(entry->of_match, &id,
-						      compat);
-			if (!ret)
-				break;
+			if (entry == driver + n_ents)
+				continue;
 		}
-		if (entry == driver + n_ents)
-			continue;
 
 		if (pre_reloc_only) {
 			if (!ofnode_pre_reloc(node) &&
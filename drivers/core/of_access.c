@@ -131,7 +131,13 @@ struct property *of_find_property(const struct device_node *np,
 	if (!np)
 		return NULL;
 
-	for (pp = np->properties; pp; pp = pp->next) {
+	pp = of_node_props(np);
+	if (IS_ERR(pp)) {
+		if (lenp)
+			*lenp = PTR_ERR(pp);
+		return NULL;
+	}
+	for (; pp; pp = pp->next) {
 		if (strcmp(pp->name, name) == 0) {
 			if (lenp)
 				*lenp = pp->length;
@@ -179,7 +185,7 @@ const struct property *of_get_first_property(const struct device_node *np)
 	if (!np)
 		return NULL;
 
-	return  np->properties;
+	return of_node_props(np);
 }
 
 const struct property *of_get_next_property(const struct device_node *np,
@@ -271,8 +277,10 @@ bool of_device_is_available(const struct device_node *device)
 		return false;
 
 	status = of_get_property(device, "status", &statlen);
-	if (status == NULL)
-		return true;
+	if (status == NULL) {
+		/* a node whose properties cannot be loaded must not be used */
+		return statlen != -ENOMEM;
+	}
 
 	if (statlen > 0) {
 		if (!strcmp(status, "okay"))
@@ -341,7 +349,7 @@ static struct device_node *__of_find_node_by_path(struct device_node *parent,
 }
 
 #define for_each_property_of_node(dn, pp) \
-	for (pp = dn->properties; pp != NULL; pp = pp->next)
+	for (pp = of_node_props(dn); !IS_ERR_OR_NULL(pp); pp = pp->next)
 
 struct device_node *of_find_node_opts_by_path(struct device_node *root,
 					      const char *path,
@@ -850,6 +858,8 @@ int of_alias_scan(void)
 
 	if (!of_aliases)
 		return 0;
+	if (IS_ERR(of_node_props(of_aliases)))
+		return log_msg_ret("ali", -ENOMEM);
 
 	for_each_property_of_node(of_aliases, pp) {
 		const char *start = pp->name;
@@ -945,7 +955,10 @@ int of_write_prop(struct device_node *np, const char *propname, int len,
 	if (!np)
 		return -EINVAL;
 
-	for (pp = np->properties; pp; pp = pp->next) {
+	pp = of_node_props(np);
+	if (IS_ERR(pp))
+		return PTR_ERR(pp);
+	for (; pp; pp = pp->next) {
 		if (strcmp(pp->name, propname) == 0) {
 			/* Property exists -> change value */
 			pp->value = (void *)value;
@@ -1045,6 +1058,8 @@ int __of_remove_property(struct device_node *np, struct property *prop)
 {
 	struct property **next;
 
+	if (IS_ERR(of_node_props(np)))
+		return -ENOMEM;
 	for (next = &np->properties; *next; next = &(*next)->next) {
 		if (*next == prop)
 			break;
@@ -1206,6 +1206,8 @@ int ofnode_first_property(ofnode node, struct ofprop *prop)
 
 	if (ofnode_is_np(node)) {
 		prop->prop = of_get_first_property(ofnode_to_np(prop->node));
+		if (IS_ERR(prop->prop))
+			return PTR_ERR(prop->prop);
 		if (!prop->prop)
 			return -FDT_ERR_NOTFOUND;
 	} else {
@@ -0,0 +1,151 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Index of bound devices by devicetree node and phandle
+ *
+ * Looking up the device for a node or phandle otherwise means walking the
+ * whole device tree or a whole uclass. This happens for every clock, reset,
+ * regulator, pinctrl and GPIO reference, so it is worth keeping a hash
+ * table which is updated as devices are bound and unbound.
+ */
+
+#define LOG_CATEGORY LOGC_DM
+
+#include <dm.h>
+#include <log.h>
+#include <malloc.h>
+#include <asm/global_data.h>
+#include <dm/device-internal.h>
+#include <dm/read.h>
+#include <linux/list.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Number of hash buckets for each of the node and phandle tables */
+#define DM_OFNODE_INDEX_BITS	8
+#define DM_OFNODE_INDEX_SIZE	(1 << DM_OFNODE_INDEX_BITS)
+
+static uint dev_ofnode_index_hash(ulong key)
+{
+	/* Nodes are at least 4-byte aligned, so drop the bottom bits */
+	return ((u32)(key >> 2) * 0x9e3779b1U) >> (32 - DM_OFNODE_INDEX_BITS);
+}
+
+static struct hlist_head *dev_ofnode_bucket(ofnode node)
+{
+	return &gd->dm_ofnode_index[dev_ofnode_index_hash(node.of_offset)];
+}
+
+static struct hlist_head *dev_phandle_bucket(uint phandle)
+{
+	return &gd->dm_ofnode_index[DM_OFNODE_INDEX_SIZE +
+		dev_ofnode_index_hash((ulong)phandle << 2)];
+}
+
+int dev_ofnode_index_init(void)
+{
+	const int size = DM_OFNODE_INDEX_SIZE * 2 * sizeof(struct hlist_head);
+
+	/*
+	 * Any devices from a previous driver model are abandoned, not
+	 * unbound, so start with an empty index
+	 */
+	if (gd->dm_ofnode_index) {
+		memset(gd->dm_ofnode_index, '\0', size);
+		return 0;
+	}
+
+	gd->dm_ofnode_index = calloc(1, size);
+	if (!gd->dm_ofnode_index)
+		return log_msg_ret("ofi", -ENOMEM);
+
+	return 0;
+}
+
+void dev_ofnode_index_add(struct udevice *dev)
+{
+	ofnode node = dev_ofnode(dev);
+	uint phandle;
+
+	if (!gd->dm_ofnode_index || !ofnode_valid(node))
+		return;
+	hlist_add_head(&dev->ofnode_hnode_, dev_ofnode_bucket(node));
+
+	phandle = dev_read_phandle(dev);
+	if (phandle)
+		hlist_add_head(&dev->phandle_hnode_,
+			       dev_phandle_bucket(phandle));
+}
+
+void dev_ofnode_index_del(struct udevice *dev)
+{
+	hlist_del_init(&dev->ofnode_hnode_);
+	hlist_del_init(&dev->phandle_hnode_);
+}
+
+void dev_ofnode_index_update(struct udevice *dev, ofnode node)
+{
+	/* Devices are only indexed once they are in their uclass */
+	if (list_empty(&dev->uclass_node)) {
+		dev->node_ = node;
+		return;
+	}
+	dev_ofnode_index_del(dev);
+	dev->node_ = node;
+	dev_ofnode_index_add(dev);
+}
+
+/**
+ * dev_index_match() - Record a match, checking that it is unique
+ *
+ * @dev: Device which matches
+ * @id: Uclass to look in, or UCLASS_INVALID for any
+ * @foundp: Holds the match found so far, updated if @dev is in the uclass
+ * Return: 0 if OK, -EAGAIN if there is more than one match
+ */
+static int dev_index_match(struct udevice *dev, enum uclass_id id,
+			   struct udevice **foundp)
+{
+	if (id != UCLASS_INVALID && device_get_uclass_id(dev) != id)
+		return 0;
+	if (*foundp)
+		return -EAGAIN;
+	*foundp = dev;
+
+	return 0;
+}
+
+int dev_ofnode_index_find(ofnode node, enum uclass_id id,
+			  struct udevice **devp)
+{
+	struct udevice *dev, *found = NULL;
+
+	if (!gd->dm_ofnode_index || !ofnode_valid(node))
+		return -ENOSYS;
+
+	hlist_for_each_entry(dev, dev_ofnode_bucket(node), ofnode_hnode_) {
+		if (ofnode_equal(dev_ofnode(dev), node) &&
+		    dev_index_match(dev, id, &found))
+			return -EAGAIN;
+	}
+	*devp = found;
+
+	return found ? 0 : -ENODEV;
+}
+
+int dev_phandle_index_find(uint phandle, enum uclass_id id,
+			   struct udevice **devp)
+{
+	struct udevice *dev, *found = NULL;
+
+	if (!gd->dm_ofnode_index || !phandle)
+		return -ENOSYS;
+
+	hlist_for_each_entry(dev, dev_phandle_bucket(phandle), phandle_hnode_) {
+		if (dev_read_phandle(dev) == phandle &&
+		    dev_index_match(dev, id, &found))
+			return -EAGAIN;
+	}
+	*devp = found;
+
+	return found ? 0 : -ENODEV;
+}
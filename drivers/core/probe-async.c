@@ -0,0 +1,157 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Queue of devices whose probe is still in progress
+ *
+ * Some devices need a long time after power-up before they are usable, e.g.
+ * waiting for a PHY to link, a controller reset to finish or a card to
+ * respond. A driver with DM_FLAG_PROBE_ASYNC starts its hardware in probe()
+ * and reports readiness from probe_complete(). Devices probed with
+ * device_probe_async() are added to this queue and polled from a cyclic
+ * function, so several slow devices can come up at once. Any later
+ * device_probe() call joins the device, so users never see a half-probed
+ * device.
+ */
+
+#define LOG_CATEGORY LOGC_DM
+
+#include <cyclic.h>
+#include <dm.h>
+#include <log.h>
+#include <malloc.h>
+#include <asm/global_data.h>
+#include <dm/device-internal.h>
+#include <dm/root.h>
+#include <linux/list.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Interval at which pending devices are polled */
+#define DM_PROBE_POLL_US	1000
+
+/**
+ * struct dm_probe_pending - A device in the queue
+ *
+ * @sibling: Node in dm_probe_head
+ * @dev: Device whose probe is pending
+ */
+struct dm_probe_pending {
+	struct list_head sibling;
+	struct udevice *dev;
+};
+
+static LIST_HEAD(dm_probe_head);
+static struct cyclic_info dm_probe_cyclic;
+
+static struct dm_probe_pending *dm_probe_find(struct udevice *dev)
+{
+	struct dm_probe_pending *pend;
+
+	list_for_each_entry(pend, &dm_probe_head, sibling) {
+		if (pend->dev == dev)
+			return pend;
+	}
+
+	return NULL;
+}
+
+static bool dm_probe_cyclic_active(void)
+{
+	struct cyclic_info *cyclic;
+
+	/*
+	 * Check the list rather than keeping a flag, since tests may call
+	 * cyclic_unregister_all() behind our back
+	 */
+	hlist_for_each_entry(cyclic, cyclic_get_list(), list) {
+		if (cyclic == &dm_probe_cyclic)
+			return true;
+	}
+
+	return false;
+}
+
+static void dm_probe_poll(struct cyclic_info *cyclic)
+{
+	int count = list_count_nodes(&dm_probe_head);
+	struct dm_probe_pending *pend;
+	int ret;
+
+	/*
+	 * Completing a probe may probe (and so join, or remove) other devices,
+	 * which takes them off the list. So take one entry off at a time and
+	 * poll each device which was pending at the start no more than once.
+	 */
+	while (count-- && !list_empty(&dm_probe_head)) {
+		pend = list_first_entry(&dm_probe_head, struct dm_probe_pending,
+					sibling);
+		list_del(&pend->sibling);
+
+		ret = device_probe_complete(pend->dev);
+		if (ret == -EAGAIN) {
+			list_add_tail(&pend->sibling, &dm_probe_head);
+			continue;
+		}
+		if (ret)
+			log_warning("Device '%s' failed to probe: %dE\n",
+				    pend->dev->name, ret);
+		free(pend);
+	}
+
+	if (list_empty(&dm_probe_head))
+		cyclic_unregister(cyclic);
+}
+
+int device_probe_queue(struct udevice *dev)
+{
+	struct dm_probe_pending *pend;
+
+	/* Cyclic functions registered before relocation are not kept */
+	if (!(gd->flags & GD_FLG_RELOC))
+		return -EPERM;
+
+	pend = malloc(sizeof(*pend));
+	if (!pend)
+		return -ENOMEM;
+	pend->dev = dev;
+	list_add_tail(&pend->sibling, &dm_probe_head);
+
+	if (!dm_probe_cyclic_active())
+		cyclic_register(&dm_probe_cyclic, dm_probe_poll,
+				DM_PROBE_POLL_US, "dm_probe");
+	log_debug("Queued '%s'\n", dev->name);
+
+	return 0;
+}
+
+void device_probe_dequeue(struct udevice *dev)
+{
+	struct dm_probe_pending *pend;
+
+	pend = dm_probe_find(dev);
+	if (pend) {
+		list_del(&pend->sibling);
+		free(pend);
+	}
+}
+
+void device_probe_cancel(struct udevice *dev)
+{
+	device_probe_dequeue(dev);
+	dev_bic_flags(dev, DM_FLAG_PROBE_PENDING);
+}
+
+int dm_probe_join_all(void)
+{
+	struct dm_probe_pending *pend;
+	int ret, err = 0;
+
+	while (!list_empty(&dm_probe_head)) {
+		pend = list_first_entry(&dm_probe_head, struct dm_probe_pending,
+					sibling);
+		ret = device_probe_join(pend->dev);
+		if (ret && !err)
+			err = ret;
+	}
+
+	return err;
+}
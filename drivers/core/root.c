@@ -8,10 +8,12 @@
 
 #define LOG_CATEGORY UCLASS_ROOT
 
+#include <bootstage.h>
 #include <errno.h>
 #include <fdtdec.h>
 #include <log.h>
 #include <malloc.h>
+#include <spl.h>
 #include <asm-generic/sections.h>
 #include <asm/global_data.h>
 #include <linux/libfdt.h>
@@ -24,6 +26,7 @@
 #include <dm/platdata.h>
 #include <dm/read.h>
 #include <dm/root.h>
+#include <dm/snapshot.h>
 #include <dm/uclass.h>
 #include <dm/uclass-internal.h>
 #include <dm/util.h>
@@ -106,6 +109,10 @@ int dm_init(bool of_live)
 		INIT_LIST_HEAD(DM_UCLASS_ROOT_NON_CONST);
 	}
 
+	ret = dev_ofnode_index_init();
+	if (ret)
+		log_debug("No node index: %d\n", ret);
+
 	if (CONFIG_IS_ENABLED(OF_PLATDATA_INST)) {
 		ret = dm_setup_inst();
 		if (ret) {
@@ -143,6 +150,8 @@ int dm_uninit(void)
 #if CONFIG_IS_ENABLED(DM_DEVICE_REMOVE)
 int dm_remove_devices_flags(uint flags)
 {
+	/* Let pending probes finish, so no device is left half-started */
+	dm_probe_join_all();
 	device_remove(dm_root(), flags);
 
 	return 0;
@@ -293,7 +302,7 @@ static int dm_probe_devices(struct udevice *dev, bool pre_reloc_only)
 		goto probe_children;
 
 	if (dev_get_flags(dev) & DM_FLAG_PROBE_AFTER_BIND) {
-		ret = device_probe(dev);
+		ret = device_probe_async(dev);
 		if (ret)
 			return ret;
 	}
@@ -319,21 +328,24 @@ static int dm_scan(bool pre_reloc_only)
 {
 	int ret;
 
+	bootstage_start(BOOTSTAGE_ID_ACCUM_DM_BIND, "dm_bind");
 	ret = dm_scan_plat(pre_reloc_only);
 	if (ret) {
 		dm_warn("dm_scan_plat() failed: %d\n", ret);
-		return ret;
+		goto out;
 	}
 
 	if (CONFIG_IS_ENABLED(OF_REAL)) {
 		ret = dm_extended_scan(pre_reloc_only);
 		if (ret) {
 			dm_warn("dm_extended_scan() failed: %d\n", ret);
-			return ret;
+			goto out;
 		}
 	}
 
 	ret = dm_scan_other(pre_reloc_only);
+out:
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_DM_BIND);
 	if (ret)
 		return ret;
 
@@ -350,11 +362,22 @@ int dm_init_and_scan(bool pre_reloc_only)
 		return ret;
 	}
 	if (!CONFIG_IS_ENABLED(OF_PLATDATA_INST)) {
+		dm_snapshot_begin();
 		ret = dm_scan(pre_reloc_only);
+		dm_snapshot_end();
 		if (ret) {
 			log_debug("dm_scan() failed: %d\n", ret);
 			return ret;
 		}
+
+		/* There is no later phase to use a snapshot after relocation */
+		if (CONFIG_IS_ENABLED(DM_SNAPSHOT) &&
+		    xpl_phase() != PHASE_BOARD_R) {
+			ret = dm_snapshot_write();
+			if (ret)
+				log_debug("Cannot write snapshot (err=%dE)\n",
+					  ret);
+		}
 	}
 	if (CONFIG_IS_ENABLED(DM_EVENT)) {
 		ret = event_notify_null(gd->flags & GD_FLG_RELOC ?
@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Snapshot of bound devices, passed from one phase to the next
+ *
+ * The snapshot is a table of (node offset, driver index, of_match index)
+ * records, sorted by node offset, stored in the bloblist. It is only valid for
+ * a phase built with the same list of drivers and using the same flat tree,
+ * which is checked before it is used.
+ */
+
+#define LOG_CATEGORY LOGC_DM
+
+#include <bloblist.h>
+#include <dm.h>
+#include <log.h>
+#include <sort.h>
+#include <asm/global_data.h>
+#include <dm/lists.h>
+#include <dm/snapshot.h>
+#include <dm/uclass-internal.h>
+#include <linux/libfdt.h>
+#include <u-boot/fnv.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+#define DM_SNAPSHOT_VERSION	2
+
+/**
+ * struct dm_snapshot_rec - Information about one bound device
+ *
+ * @offset: Offset of the device's node in the flat tree
+ * @drv_idx: Index of the driver in the driver linker list
+ * @match_idx: Index of the matching entry in the driver's of_match table
+ */
+struct dm_snapshot_rec {
+	s32 offset;
+	u16 drv_idx;
+	u16 match_idx;
+};
+
+/**
+ * struct dm_snapshot - Header of the snapshot, followed by the records
+ *
+ * @version: DM_SNAPSHOT_VERSION
+ * @drv_sig: Signature of the driver list, see dm_snapshot_drv_sig()
+ * @fdt_size: Total size of the flat tree
+ * @fdt_struct_size: Size of the structure block of the flat tree
+ * @count: Number of records
+ * @rec: Records, sorted by offset
+ */
+struct dm_snapshot {
+	u32 version;
+	u32 drv_sig;
+	u32 fdt_size;
+	u32 fdt_struct_size;
+	u32 count;
+	struct dm_snapshot_rec rec[];
+};
+
+#define dm_snapshot_size(count)	(sizeof(struct dm_snapshot) + \
+				 (count) * sizeof(struct dm_snapshot_rec))
+
+/* Hash the driver names, so a phase with different drivers is detected */
+static u32 dm_snapshot_drv_sig(void)
+{
+	struct driver *drv = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const u8 sep = 0xff;
+	u32 hash = FNV1A_INIT;
+	int i;
+
+	for (i = 0; i < n_ents; i++) {
+		hash = fnv1a_update(hash, drv[i].name, strlen(drv[i].name));
+		hash = fnv1a_update(hash, &sep, 1);
+	}
+
+	return hash;
+}
+
+int dm_snapshot_begin(void)
+{
+	const void *fdt = gd->fdt_blob;
+	struct dm_snapshot *snap;
+
+	gd->dm_snapshot = NULL;
+	snap = bloblist_find(BLOBLISTT_U_BOOT_DM, 0);
+	if (!snap)
+		return -ENOENT;
+	if (snap->version != DM_SNAPSHOT_VERSION || !fdt ||
+	    snap->fdt_size != fdt_totalsize(fdt) ||
+	    snap->fdt_struct_size != fdt_size_dt_struct(fdt) ||
+	    !bloblist_find(BLOBLISTT_U_BOOT_DM,
+			   dm_snapshot_size(snap->count)) ||
+	    snap->drv_sig != dm_snapshot_drv_sig()) {
+		log_debug("Ignoring stale snapshot\n");
+		return -ESTALE;
+	}
+	gd->dm_snapshot = snap;
+	log_debug("Using snapshot with %d devices\n", snap->count);
+
+	return 0;
+}
+
+void dm_snapshot_end(void)
+{
+	gd->dm_snapshot = NULL;
+}
+
+int dm_snapshot_lookup(ofnode node, struct driver **drvp,
+		       const struct udevice_id **idp)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct dm_snapshot *snap = gd->dm_snapshot;
+	const struct dm_snapshot_rec *rec;
+	const struct udevice_id *id;
+	struct driver *drv;
+	int lo, hi, mid, offset, i;
+
+	if (!snap || ofnode_is_np(node) || ofnode_to_fdt(node) != gd->fdt_blob)
+		return -ENOENT;
+
+	offset = ofnode_to_offset(node);
+	rec = NULL;
+	for (lo = 0, hi = snap->count; lo < hi;) {
+		mid = (lo + hi) / 2;
+		if (snap->rec[mid].offset == offset) {
+			rec = &snap->rec[mid];
+			break;
+		}
+		if (snap->rec[mid].offset < offset)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (!rec || rec->drv_idx >= n_ents)
+		return -ENOENT;
+
+	drv = driver + rec->drv_idx;
+	if (!drv->of_match)
+		return -ENOENT;
+	for (i = 0, id = drv->of_match; id->compatible && i < rec->match_idx;
+	     i++, id++)
+		;
+	if (!id->compatible || !ofnode_device_is_compatible(node,
+							    id->compatible))
+		return -ENOENT;
+	*drvp = drv;
+	*idp = id;
+
+	return 0;
+}
+
+static int dm_snapshot_cmp(const void *a, const void *b)
+{
+	const struct dm_snapshot_rec *ra = a, *rb = b;
+
+	return ra->offset - rb->offset;
+}
+
+/**
+ * dm_snapshot_match_idx() - Find the of_match entry used to bind a device
+ *
+ * Devices which share a node with their parent were bound by the parent's
+ * driver rather than by scanning the tree, so are not included. Nor are
+ * devices bound by a fallback driver after the first driver matching the node
+ * refused to bind, since that driver may bind in the next phase.
+ *
+ * @dev: Device to check
+ * Return: index into the driver's of_match table, or -ENOENT if none
+ */
+static int dm_snapshot_match_idx(struct udevice *dev)
+{
+	ofnode node = dev_ofnode(dev);
+	const struct udevice_id *id;
+	const char *compat;
+	struct driver *drv;
+	int i;
+
+	if (!dev_has_ofnode(dev) || !dev->driver->of_match ||
+	    ofnode_to_fdt(node) != gd->fdt_blob ||
+	    (dev->parent && ofnode_equal(node, dev_ofnode(dev->parent))))
+		return -ENOENT;
+
+	/* Find the driver which lists_bind_fdt() tries first */
+	for (i = 0; !ofnode_read_string_index(node, "compatible", i, &compat);
+	     i++) {
+		drv = lists_driver_lookup_compat(compat, &id);
+		if (!drv)
+			continue;
+		if (drv != dev->driver || id->data != dev->driver_data)
+			return -ENOENT;
+
+		return id - drv->of_match;
+	}
+
+	return -ENOENT;
+}
+
+int dm_snapshot_write(void)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const void *fdt = gd->fdt_blob;
+	struct dm_snapshot *snap;
+	struct udevice *dev;
+	struct uclass *uc;
+	int count, size, idx, ret, i, j;
+
+	if (of_live_active() || !fdt)
+		return -EPERM;
+
+	count = 0;
+	list_for_each_entry(uc, gd->uclass_root, sibling_node) {
+		uclass_foreach_dev(dev, uc) {
+			if (dm_snapshot_match_idx(dev) >= 0)
+				count++;
+		}
+	}
+
+	size = dm_snapshot_size(count);
+	if (bloblist_find(BLOBLISTT_U_BOOT_DM, 0)) {
+		ret = bloblist_resize(BLOBLISTT_U_BOOT_DM, size);
+		if (ret)
+			return log_msg_ret("res", ret);
+		snap = bloblist_find(BLOBLISTT_U_BOOT_DM, size);
+	} else {
+		snap = bloblist_add(BLOBLISTT_U_BOOT_DM, size, 0);
+	}
+	if (!snap)
+		return log_msg_ret("add", -ENOSPC);
+
+	snap->version = DM_SNAPSHOT_VERSION;
+	snap->drv_sig = dm_snapshot_drv_sig();
+	snap->fdt_size = fdt_totalsize(fdt);
+	snap->fdt_struct_size = fdt_size_dt_struct(fdt);
+	count = 0;
+	list_for_each_entry(uc, gd->uclass_root, sibling_node) {
+		uclass_foreach_dev(dev, uc) {
+			struct dm_snapshot_rec *rec;
+
+			idx = dm_snapshot_match_idx(dev);
+			if (idx < 0)
+				continue;
+			rec = &snap->rec[count++];
+			rec->offset = dev_of_offset(dev);
+			rec->drv_idx = dev->driver - driver;
+			rec->match_idx = idx;
+		}
+	}
+	qsort(snap->rec, count, sizeof(*snap->rec), dm_snapshot_cmp);
+
+	/* Drop nodes with more than one device, since they are ambiguous */
+	for (i = 0, j = 0; i < count;) {
+		int end;
+
+		for (end = i + 1; end < count &&
+		     snap->rec[end].offset == snap->rec[i].offset; end++)
+			;
+		if (end == i + 1)
+			snap->rec[j++] = snap->rec[i];
+		i = end;
+	}
+	snap->count = j;
+	if (j != count) {
+		ret = bloblist_resize(BLOBLISTT_U_BOOT_DM,
+				      dm_snapshot_size(j));
+		if (ret)
+			return log_msg_ret("shr", ret);
+	}
+	log_debug("Wrote snapshot with %d devices\n", j);
+
+	return 0;
+}
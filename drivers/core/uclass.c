@@ -393,6 +393,11 @@ int uclass_find_device_by_ofnode(enum uclass_id id, ofnode node,
 	if (ret)
 		return ret;
 
+	ret = dev_ofnode_index_find(node, id, devp);
+	if (ret != -ENOSYS && ret != -EAGAIN)
+		goto done;
+	ret = 0;
+
 	uclass_foreach_dev(dev, uc) {
 		log(LOGC_DM, LOGL_DEBUG_CONTENT, "      - checking %s\n",
 		    dev->name);
@@ -422,6 +427,10 @@ static int uclass_find_device_by_phandle_id(enum uclass_id id,
 	if (ret)
 		return ret;
 
+	ret = dev_phandle_index_find(find_phandle, id, devp);
+	if (ret != -ENOSYS && ret != -EAGAIN)
+		return ret;
+
 	uclass_foreach_dev(dev, uc) {
 		uint phandle;
 
@@ -693,6 +702,7 @@ int uclass_bind_device(struct udevice *dev)
 
 	uc = dev->uclass;
 	list_add_tail(&dev->uclass_node, &uc->dev_head);
+	dev_ofnode_index_add(dev);
 
 	if (dev->parent) {
 		struct uclass_driver *uc_drv = dev->parent->uclass->uc_drv;
@@ -707,6 +717,7 @@ int uclass_bind_device(struct udevice *dev)
 	return 0;
 err:
 	/* There is no need to undo the parent's post_bind call */
+	dev_ofnode_index_del(dev);
 	list_del(&dev->uclass_node);
 
 	return ret;
@@ -730,6 +741,7 @@ int uclass_pre_unbind_device(struct udevice *dev)
 
 int uclass_unbind_device(struct udevice *dev)
 {
+	dev_ofnode_index_del(dev);
 	list_del(&dev->uclass_node);
 
 	return 0;
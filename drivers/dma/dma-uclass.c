@@ -260,6 +260,40 @@ int dma_memcpy(void *dst, void *src, size_t len)
 	return ret;
 }
 
+#if CONFIG_IS_ENABLED(DMA_MEMCPY_OFFLOAD)
+int dma_memcpy_try(void *dst, const void *src, size_t len)
+{
+	ulong to = (ulong)dst, from = (ulong)src;
+	size_t head, tail;
+	int ret;
+
+	/* DMA cannot handle overlapping regions */
+	if (len < CONFIG_DMA_MEMCPY_OFFLOAD_MIN ||
+	    (to < from + len && from < to + len))
+		return -EINVAL;
+
+	/*
+	 * Cache maintenance works on whole lines, so the destination must not
+	 * share a line with other data. Partial lines at either end are copied
+	 * by the CPU, which needs the source to have the same alignment.
+	 */
+	if ((to ^ from) & (ARCH_DMA_MINALIGN - 1))
+		return -EINVAL;
+	head = ALIGN(to, ARCH_DMA_MINALIGN) - to;
+	tail = (to + len) & (ARCH_DMA_MINALIGN - 1);
+	if (len <= head + tail)
+		return -EINVAL;
+
+	ret = dma_memcpy(dst + head, (void *)src + head, len - head - tail);
+	if (ret < 0)
+		return log_msg_ret("dma", ret);
+	memcpy(dst, src, head);
+	memcpy(dst + len - tail, src + len - tail, tail);
+
+	return 0;
+}
+#endif
+
 UCLASS_DRIVER(dma) = {
 	.id		= UCLASS_DMA,
 	.name		= "dma",
@@ -10,6 +10,7 @@
 #include <fastboot-internal.h>
 #include <fb_mmc.h>
 #include <fb_nand.h>
+#include <image-sparse.h>
 #include <part.h>
 #include <stdlib.h>
 #include <vsprintf.h>
@@ -43,6 +44,9 @@ static void oem_partconf(char *, char *);
 static void oem_bootbus(char *, char *);
 static void oem_console(char *, char *);
 static void oem_board(char *, char *);
+#if CONFIG_IS_ENABLED(FASTBOOT_FLASH_STREAM)
+static void oem_stream(char *, char *);
+#endif
 static void run_ucmd(char *, char *);
 static void run_acmd(char *, char *);
 
@@ -118,6 +122,10 @@ static const struct {
 		.command = "oem board",
 		.dispatch = CONFIG_IS_ENABLED(FASTBOOT_OEM_BOARD, (oem_board), (NULL))
 	},
+	[FASTBOOT_COMMAND_OEM_STREAM] = {
+		.command = "oem stream",
+		.dispatch = CONFIG_IS_ENABLED(FASTBOOT_FLASH_STREAM, (oem_stream), (NULL))
+	},
 	[FASTBOOT_COMMAND_UCMD] = {
 		.command = "UCmd",
 		.dispatch = CONFIG_IS_ENABLED(FASTBOOT_UUU_SUPPORT, (run_ucmd), (NULL))
@@ -218,6 +226,128 @@ static void getvar(char *cmd_parameter, char *response)
 	fastboot_getvar(cmd_parameter, response);
 }
 
+#if CONFIG_IS_ENABLED(FASTBOOT_FLASH_STREAM)
+/**
+ * stream_part - partition to write the next download to, or "" if none
+ */
+static char stream_part[FASTBOOT_COMMAND_LEN];
+
+/**
+ * stream_response - response to send if the stream fails
+ *
+ * Errors are reported once the download completes, since the client only
+ * reads the response at that point
+ */
+static char stream_response[FASTBOOT_RESPONSE_LEN];
+
+static struct sparse_stream stream;
+static bool streaming;
+
+/**
+ * stream_start() - Start writing a download to the partition from 'oem stream'
+ *
+ * @cmd_parameter: Pointer to command parameter
+ * @response: Pointer to fastboot response buffer
+ * Return: true if the download was started or failed, false if it is not to
+ *	be streamed
+ */
+static bool stream_start(char *cmd_parameter, char *response)
+{
+	size_t buf_size;
+
+	if (!*stream_part)
+		return false;
+
+	buf_size = min_t(size_t, fastboot_buf_size,
+			 2 * CONFIG_FASTBOOT_FLASH_STREAM_BUF_SIZE);
+	*stream_response = '\0';
+	if (fastboot_mmc_stream_start(stream_part, &stream, fastboot_buf_addr,
+				      buf_size, fastboot_bytes_expected,
+				      response)) {
+		*stream_part = '\0';
+		return true;
+	}
+	streaming = true;
+	printf("Starting download of %d bytes to '%s'\n",
+	       fastboot_bytes_expected, stream_part);
+	fastboot_response("DATA", response, "%s", cmd_parameter);
+
+	return true;
+}
+
+static bool stream_data(const void *data, unsigned int len)
+{
+	if (!streaming)
+		return false;
+
+	/* An error stops the stream and is reported by stream_complete() */
+	sparse_stream_write(&stream, data, len, stream_response);
+
+	return true;
+}
+
+static bool stream_complete(char *response)
+{
+	if (!streaming)
+		return false;
+
+	streaming = false;
+	if (sparse_stream_finish(&stream, stream_part, stream_response)) {
+		if (*stream_response)
+			strlcpy(response, stream_response,
+				FASTBOOT_RESPONSE_LEN);
+		else
+			fastboot_fail("flash write failure", response);
+	} else {
+		fastboot_okay(NULL, response);
+	}
+	*stream_part = '\0';
+
+	return true;
+}
+
+void fastboot_data_flush(void)
+{
+	if (streaming)
+		sparse_stream_flush(&stream, stream_response);
+}
+
+/**
+ * oem_stream() - Select a partition to write the next download to
+ *
+ * @cmd_parameter: Pointer to partition name
+ * @response: Pointer to fastboot response buffer
+ */
+static void oem_stream(char *cmd_parameter, char *response)
+{
+	if (!cmd_parameter || !*cmd_parameter) {
+		fastboot_fail("Expected command parameter", response);
+		return;
+	}
+	strlcpy(stream_part, cmd_parameter, sizeof(stream_part));
+	fastboot_okay(NULL, response);
+}
+#else
+static bool stream_start(char *cmd_parameter, char *response)
+{
+	return false;
+}
+
+static bool stream_data(const void *data, unsigned int len)
+{
+	return false;
+}
+
+static bool stream_complete(char *response)
+{
+	return false;
+}
+
+void fastboot_data_flush(void)
+{
+}
+#endif
+
 /**
  * fastboot_download() - Start a download transfer from the client
  *
@@ -244,6 +374,8 @@ static void download(char *cmd_parameter, char *response)
 	 *
 	 * where cmd_parameter is an 8 digit hexadecimal number
 	 */
+	if (stream_start(cmd_parameter, response))
+		return;
 	if (fastboot_bytes_expected > fastboot_buf_size) {
 		fastboot_fail(cmd_parameter, response);
 	} else {
@@ -291,9 +423,10 @@ void fastboot_data_download(const void *fastboot_data,
 			      response);
 		return;
 	}
-	/* Download data to fastboot_buf_addr */
-	memcpy(fastboot_buf_addr + fastboot_bytes_received,
-	       fastboot_data, fastboot_data_len);
+	/* Download data to fastboot_buf_addr, unless writing it to flash */
+	if (!stream_data(fastboot_data, fastboot_data_len))
+		memcpy(fastboot_buf_addr + fastboot_bytes_received,
+		       fastboot_data, fastboot_data_len);
 
 	pre_dot_num = fastboot_bytes_received / BYTES_PER_DOT;
 	fastboot_bytes_received += fastboot_data_len;
@@ -313,14 +446,20 @@ void fastboot_data_download(const void *fastboot_data,
  * @response: Pointer to fastboot response buffer
  *
  * Set image_size and ${filesize} to the total size of the downloaded image.
+ * If the image was written to flash as it arrived, finish writing it instead.
  */
 void fastboot_data_complete(char *response)
 {
-	/* Download complete. Respond with "OKAY" */
-	fastboot_okay(NULL, response);
 	printf("\ndownloading of %d bytes finished\n", fastboot_bytes_received);
-	image_size = fastboot_bytes_received;
-	env_set_hex("filesize", image_size);
+	if (stream_complete(response)) {
+		/* The image was written to flash, not to the buffer */
+		image_size = 0;
+	} else {
+		/* Download complete. Respond with "OKAY" */
+		fastboot_okay(NULL, response);
+		image_size = fastboot_bytes_received;
+		env_set_hex("filesize", image_size);
+	}
 	fastboot_bytes_expected = 0;
 	fastboot_bytes_received = 0;
 }
@@ -164,6 +164,14 @@ static lbaint_t fb_mmc_sparse_reserve(struct sparse_storage *info,
 	return blkcnt;
 }
 
+static lbaint_t fb_mmc_sparse_zero(struct sparse_storage *info,
+		lbaint_t blk, lbaint_t blkcnt)
+{
+	struct fb_mmc_sparse *sparse = info->priv;
+
+	return blk_dzero(sparse->dev_desc, blk, blkcnt);
+}
+
 static void write_raw_image(struct blk_desc *dev_desc,
 			    struct disk_partition *info, const char *part_name,
 			    void *buffer, u32 download_bytes, char *response)
@@ -620,6 +628,7 @@ void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
 		sparse.size = info.size;
 		sparse.write = fb_mmc_sparse_write;
 		sparse.reserve = fb_mmc_sparse_reserve;
+		sparse.zero = fb_mmc_sparse_zero;
 		sparse.mssg = fastboot_fail;
 
 		printf("Flashing sparse image at offset " LBAFU "\n",
@@ -636,6 +645,45 @@ void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
 	}
 }
 
+#if CONFIG_IS_ENABLED(FASTBOOT_FLASH_STREAM)
+int fastboot_mmc_stream_start(const char *cmd, struct sparse_stream *ss,
+			      void *buf, size_t buf_size, u32 image_size,
+			      char *response)
+{
+	/* These are used until the stream is finished */
+	static struct fb_mmc_sparse sparse_priv;
+	static struct sparse_storage sparse;
+	struct blk_desc *dev_desc;
+	struct disk_partition info;
+	int ret;
+
+	ret = fastboot_mmc_get_part_info(cmd, &dev_desc, &info, response);
+	if (ret < 0)
+		return ret;
+
+	sparse_priv.dev_desc = dev_desc;
+
+	sparse.blksz = info.blksz;
+	sparse.start = info.start;
+	sparse.size = info.size;
+	sparse.write = fb_mmc_sparse_write;
+	sparse.reserve = fb_mmc_sparse_reserve;
+	sparse.zero = fb_mmc_sparse_zero;
+	sparse.mssg = fastboot_fail;
+	sparse.priv = &sparse_priv;
+
+	ret = sparse_stream_start(ss, &sparse, buf, buf_size, image_size);
+	if (ret) {
+		fastboot_fail("download buffer too small", response);
+		return ret;
+	}
+	printf("Streaming image to '%s' at offset " LBAFU "\n", cmd,
+	       sparse.start);
+
+	return 0;
+}
+#endif
+
 /**
  * fastboot_mmc_flash_erase() - Erase eMMC for fastboot
  *
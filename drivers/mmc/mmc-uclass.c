@@ -131,6 +131,24 @@ int mmc_execute_tuning(struct mmc *mmc, uint opcode)
 
 	return ret;
 }
+
+int mmc_get_tuning(struct mmc *mmc, u32 *tap)
+{
+	struct dm_mmc_ops *ops = mmc_get_ops(mmc->dev);
+
+	if (!ops->get_tuning)
+		return -ENOSYS;
+	return ops->get_tuning(mmc->dev, tap);
+}
+
+int mmc_set_tuning(struct mmc *mmc, u32 tap)
+{
+	struct dm_mmc_ops *ops = mmc_get_ops(mmc->dev);
+
+	if (!ops->set_tuning)
+		return -ENOSYS;
+	return ops->set_tuning(mmc->dev, tap);
+}
 #endif
 
 #if CONFIG_IS_ENABLED(MMC_HS400_ES_SUPPORT)
@@ -373,6 +391,27 @@ void mmc_do_preinit(void)
 	}
 }
 
+#if CONFIG_IS_ENABLED(MMC_INIT_ASYNC)
+int mmc_start_init_all(void)
+{
+	struct udevice *dev;
+	int ret;
+
+	uclass_foreach_dev_probe(UCLASS_MMC, dev) {
+		struct mmc *m = mmc_get_mmc_dev(dev);
+
+		if (!m)
+			continue;
+		ret = mmc_start_init_async(m);
+		if (ret)
+			log_debug("%s: cannot start init (err=%d)\n", dev->name,
+				  ret);
+	}
+
+	return 0;
+}
+#endif
+
 #if !defined(CONFIG_XPL_BUILD) || defined(CONFIG_SPL_LIBCOMMON_SUPPORT)
 void print_mmc_devices(char separator)
 {
@@ -524,6 +563,7 @@ static const struct blk_ops mmc_blk_ops = {
 #if CONFIG_IS_ENABLED(MMC_WRITE)
 	.write	= mmc_bwrite,
 	.erase	= mmc_berase,
+	.zero	= mmc_bzero,
 #endif
 	.select_hwpart	= mmc_select_hwpart,
 };
@@ -538,9 +578,22 @@ U_BOOT_DRIVER(mmc_blk) = {
 };
 #endif /* CONFIG_BLK */
 
+static int __maybe_unused mmc_pre_remove(struct udevice *dev)
+{
+	struct mmc *mmc = mmc_get_mmc_dev(dev);
+
+	if (mmc)
+		mmc_cancel_async_init(mmc);
+
+	return 0;
+}
+
 UCLASS_DRIVER(mmc) = {
 	.id		= UCLASS_MMC,
 	.name		= "mmc",
 	.flags		= DM_UC_FLAG_SEQ_ALIAS,
+#if CONFIG_IS_ENABLED(MMC_INIT_ASYNC)
+	.pre_remove	= mmc_pre_remove,
+#endif
 	.per_device_auto	= sizeof(struct mmc_uclass_priv),
 };
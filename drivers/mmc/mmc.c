@@ -645,73 +645,66 @@ static int mmc_switch_voltage(struct mmc *mmc, int signal_voltage)
 }
 #endif
 
-static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
+static int sd_send_op_cond_iter(struct mmc *mmc, bool uhs_en,
+				struct mmc_cmd *cmd)
 {
-	int timeout = 1000;
 	int err;
-	struct mmc_cmd cmd;
-
-	while (1) {
-		cmd.cmdidx = MMC_CMD_APP_CMD;
-		cmd.resp_type = MMC_RSP_R1;
-		cmd.cmdarg = 0;
 
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+	cmd->cmdidx = MMC_CMD_APP_CMD;
+	cmd->resp_type = MMC_RSP_R1;
+	cmd->cmdarg = 0;
 
-		if (err)
-			return err;
+	err = mmc_send_cmd(mmc, cmd, NULL);
 
-		cmd.cmdidx = SD_CMD_APP_SEND_OP_COND;
-		cmd.resp_type = MMC_RSP_R3;
-
-		/*
-		 * Most cards do not answer if some reserved bits
-		 * in the ocr are set. However, Some controller
-		 * can set bit 7 (reserved for low voltages), but
-		 * how to manage low voltages SD card is not yet
-		 * specified.
-		 */
-		cmd.cmdarg = mmc_host_is_spi(mmc) ? 0 :
-			(mmc->cfg->voltages & 0xff8000);
-
-		if (mmc->version == SD_VERSION_2)
-			cmd.cmdarg |= OCR_HCS;
+	if (err)
+		return err;
 
-		if (uhs_en)
-			cmd.cmdarg |= OCR_S18R;
+	cmd->cmdidx = SD_CMD_APP_SEND_OP_COND;
+	cmd->resp_type = MMC_RSP_R3;
 
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+	/*
+	 * Most cards do not answer if some reserved bits
+	 * in the ocr are set. However, Some controller
+	 * can set bit 7 (reserved for low voltages), but
+	 * how to manage low voltages SD card is not yet
+	 * specified.
+	 */
+	cmd->cmdarg = mmc_host_is_spi(mmc) ? 0 :
+		(mmc->cfg->voltages & 0xff8000);
 
-		if (err)
-			return err;
+	if (mmc->version == SD_VERSION_2)
+		cmd->cmdarg |= OCR_HCS;
 
-		if (cmd.response[0] & OCR_BUSY)
-			break;
+	if (uhs_en)
+		cmd->cmdarg |= OCR_S18R;
 
-		if (timeout-- <= 0)
-			return -EOPNOTSUPP;
+	return mmc_send_cmd(mmc, cmd, NULL);
+}
 
-		udelay(1000);
-	}
+/* Finish setting up an SD card once it has reported that it is not busy */
+static int sd_complete_op_cond(struct mmc *mmc, bool uhs_en,
+			       struct mmc_cmd *cmd)
+{
+	int err;
 
 	if (mmc->version != SD_VERSION_2)
 		mmc->version = SD_VERSION_1_0;
 
 	if (mmc_host_is_spi(mmc)) { /* read OCR for spi */
-		cmd.cmdidx = MMC_CMD_SPI_READ_OCR;
-		cmd.resp_type = MMC_RSP_R3;
-		cmd.cmdarg = 0;
+		cmd->cmdidx = MMC_CMD_SPI_READ_OCR;
+		cmd->resp_type = MMC_RSP_R3;
+		cmd->cmdarg = 0;
 
-		err = mmc_send_cmd(mmc, &cmd, NULL);
+		err = mmc_send_cmd(mmc, cmd, NULL);
 
 		if (err)
 			return err;
 	}
 
-	mmc->ocr = cmd.response[0];
+	mmc->ocr = cmd->response[0];
 
 #if CONFIG_IS_ENABLED(MMC_UHS_SUPPORT)
-	if (uhs_en && !(mmc_host_is_spi(mmc)) && (cmd.response[0] & 0x41000000)
+	if (uhs_en && !(mmc_host_is_spi(mmc)) && (cmd->response[0] & 0x41000000)
 	    == 0x41000000) {
 		err = mmc_switch_voltage(mmc, MMC_SIGNAL_VOLTAGE_180);
 		if (err)
@@ -725,6 +718,36 @@ static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
 	return 0;
 }
 
+static int sd_send_op_cond(struct mmc *mmc, bool uhs_en)
+{
+	int timeout = 1000;
+	int err;
+	struct mmc_cmd cmd;
+
+	while (1) {
+		err = sd_send_op_cond_iter(mmc, uhs_en, &cmd);
+		if (err)
+			return err;
+
+		if (cmd.response[0] & OCR_BUSY)
+			break;
+
+		/* let mmc_poll_op_cond() wait for the card to power up */
+		if (CONFIG_IS_ENABLED(MMC_INIT_ASYNC) && mmc->async_init) {
+			mmc->sd_op_cond_pending = 1;
+			mmc->op_cond_start = get_timer(0);
+			return 0;
+		}
+
+		if (timeout-- <= 0)
+			return -EOPNOTSUPP;
+
+		udelay(1000);
+	}
+
+	return sd_complete_op_cond(mmc, uhs_en, &cmd);
+}
+
 static int mmc_send_op_cond_iter(struct mmc *mmc, int use_arg)
 {
 	struct mmc_cmd cmd;
@@ -766,6 +789,12 @@ static int mmc_send_op_cond(struct mmc *mmc)
 		if (mmc->ocr & OCR_BUSY)
 			break;
 
+		/* let mmc_poll_op_cond() wait for the card to power up */
+		if (CONFIG_IS_ENABLED(MMC_INIT_ASYNC) && mmc->async_init && i) {
+			mmc->op_cond_start = start;
+			break;
+		}
+
 		if (get_timer(start) > timeout)
 			return -ETIMEDOUT;
 		udelay(100);
@@ -911,7 +940,13 @@ static int __mmc_switch(struct mmc *mmc, u8 set, u8 index, u8 value,
 
 int mmc_switch(struct mmc *mmc, u8 set, u8 index, u8 value)
 {
-	return __mmc_switch(mmc, set, index, value, true);
+	int ret;
+
+	ret = __mmc_switch(mmc, set, index, value, true);
+	if (!ret)
+		mmc_handoff_update_ext_csd(mmc, index, value);
+
+	return ret;
 }
 
 int mmc_boot_wp(struct mmc *mmc)
@@ -1423,6 +1458,7 @@ static int sd_get_capabilities(struct mmc *mmc)
 
 	if (mmc->scr[0] & SD_DATA_4BIT)
 		mmc->card_caps |= MMC_MODE_4BIT;
+	mmc->erased_zero = !(mmc->scr[0] & SD_DATA_STAT_AFTER_ERASE);
 
 	/* Version 1.0 doesn't support switching */
 	if (mmc->version == SD_VERSION_1_0)
@@ -2053,8 +2089,24 @@ static const struct ext_csd_bus_width {
 	{MMC_MODE_1BIT, false, EXT_CSD_BUS_WIDTH_1},
 };
 
+#if CONFIG_IS_ENABLED(MMC_SUPPORTS_TUNING)
+/*
+ * Restore the tuning result recorded by an earlier boot phase if possible,
+ * otherwise run the tuning procedure
+ */
+static int mmc_tune(struct mmc *mmc, uint opcode,
+		    const struct mmc_handoff_card *hoff)
+{
+	if (hoff && hoff->has_tuning && !mmc_set_tuning(mmc, hoff->tuning))
+		return 0;
+
+	return mmc_execute_tuning(mmc, opcode);
+}
+#endif
+
 #if CONFIG_IS_ENABLED(MMC_HS400_SUPPORT)
-static int mmc_select_hs400(struct mmc *mmc)
+static int mmc_select_hs400(struct mmc *mmc,
+			    const struct mmc_handoff_card *hoff)
 {
 	int err;
 
@@ -2069,7 +2121,7 @@ static int mmc_select_hs400(struct mmc *mmc)
 
 	/* execute tuning if needed */
 	mmc->hs400_tuning = true;
-	err = mmc_execute_tuning(mmc, MMC_CMD_SEND_TUNING_BLOCK_HS200);
+	err = mmc_tune(mmc, MMC_CMD_SEND_TUNING_BLOCK_HS200, hoff);
 	mmc->hs400_tuning = false;
 	if (err) {
 		debug("tuning failed\n");
@@ -2100,7 +2152,8 @@ static int mmc_select_hs400(struct mmc *mmc)
 	return 0;
 }
 #else
-static int mmc_select_hs400(struct mmc *mmc)
+static int mmc_select_hs400(struct mmc *mmc,
+			    const struct mmc_handoff_card *hoff)
 {
 	return -ENOTSUPP;
 }
@@ -2158,6 +2211,7 @@ static int mmc_select_mode_and_width(struct mmc *mmc, uint card_caps)
 	int err = 0;
 	const struct mode_width_tuning *mwt;
 	const struct ext_csd_bus_width *ecbw;
+	struct mmc_handoff_card *hoff;
 
 #ifdef DEBUG
 	mmc_dump_capabilities("mmc", card_caps);
@@ -2199,10 +2253,21 @@ static int mmc_select_mode_and_width(struct mmc *mmc, uint card_caps)
 #endif
 		mmc_set_clock(mmc, mmc->legacy_speed, MMC_CLK_ENABLE);
 
+	/*
+	 * If an earlier boot phase recorded the setup for this card, try only
+	 * that mode and width first
+	 */
+	hoff = mmc_handoff_find(mmc);
+retry:
 	for_each_mmc_mode_by_pref(card_caps, mwt) {
+		if (hoff && mwt->mode != hoff->mode)
+			continue;
 		for_each_supported_width(card_caps & mwt->widths,
 					 mmc_is_mode_ddr(mwt->mode), ecbw) {
 			enum mmc_voltage old_voltage;
+
+			if (hoff && bus_width(ecbw->cap) != hoff->bus_width)
+				continue;
 			pr_debug("trying mode %s width %d (at %d MHz)\n",
 				 mmc_mode_name(mwt->mode),
 				 bus_width(ecbw->cap),
@@ -2222,7 +2287,7 @@ static int mmc_select_mode_and_width(struct mmc *mmc, uint card_caps)
 			mmc_set_bus_width(mmc, bus_width(ecbw->cap));
 
 			if (mwt->mode == MMC_HS_400) {
-				err = mmc_select_hs400(mmc);
+				err = mmc_select_hs400(mmc, hoff);
 				if (err) {
 					printf("Select HS400 failed %d\n", err);
 					goto error;
@@ -2262,8 +2327,7 @@ static int mmc_select_mode_and_width(struct mmc *mmc, uint card_caps)
 
 				/* execute tuning if needed */
 				if (mwt->tuning) {
-					err = mmc_execute_tuning(mmc,
-								 mwt->tuning);
+					err = mmc_tune(mmc, mwt->tuning, hoff);
 					if (err) {
 						pr_debug("tuning failed : %d\n", err);
 						goto error;
@@ -2286,6 +2350,11 @@ error:
 			mmc_set_bus_width(mmc, 1);
 		}
 	}
+	if (hoff) {
+		log_debug("recorded mode not usable, trying all modes\n");
+		hoff = NULL;
+		goto retry;
+	}
 
 	log_err("unable to select a mode: %d\n", err);
 
@@ -2343,14 +2412,21 @@ static int mmc_startup_v4(struct mmc *mmc)
 		mmc->ext_csd = ext_csd;
 #else
 	ALLOC_CACHE_ALIGN_BUFFER(u8, ext_csd, MMC_MAX_BLOCK_LEN);
+	struct mmc_handoff_card *hoff;
 
 	if (IS_SD(mmc) || (mmc->version < MMC_VERSION_4))
 		return 0;
 
-	/* check  ext_csd version and capacity */
-	err = mmc_send_ext_csd(mmc, ext_csd);
-	if (err)
-		goto error;
+	hoff = mmc_handoff_find(mmc);
+	if (hoff && hoff->has_ext_csd) {
+		/* use the snapshot recorded by an earlier boot phase */
+		mmc_handoff_get_ext_csd(hoff, ext_csd);
+	} else {
+		/* check  ext_csd version and capacity */
+		err = mmc_send_ext_csd(mmc, ext_csd);
+		if (err)
+			goto error;
+	}
 
 	/* store the ext csd for future reference */
 	if (!mmc->ext_csd)
@@ -2504,6 +2580,7 @@ static int mmc_startup_v4(struct mmc *mmc)
 
 	mmc->can_trim =
 		!!(ext_csd[EXT_CSD_SEC_FEATURE] & EXT_CSD_SEC_FEATURE_TRIM_EN);
+	mmc->erased_zero = !ext_csd[EXT_CSD_ERASED_MEM_CONT];
 
 	return 0;
 error:
@@ -2700,6 +2777,8 @@ static int mmc_startup(struct mmc *mmc)
 		if (err)
 			return err;
 		err = mmc_select_mode_and_width(mmc, mmc->card_caps);
+		if (!err && mmc_handoff_save(mmc))
+			log_debug("cannot record bus setup\n");
 	}
 #endif
 	if (err)
@@ -2965,6 +3044,104 @@ retry:
 	return err;
 }
 
+#if CONFIG_IS_ENABLED(MMC_INIT_ASYNC)
+static void mmc_async_done(struct mmc *mmc)
+{
+	if (!mmc->async_init)
+		return;
+	mmc->async_init = 0;
+	cyclic_unregister(&mmc->init_cyclic);
+}
+
+void mmc_cancel_async_init(struct mmc *mmc)
+{
+	if (!mmc->async_init)
+		return;
+	mmc_async_done(mmc);
+	mmc->op_cond_pending = 0;
+	mmc->sd_op_cond_pending = 0;
+	mmc->init_in_progress = 0;
+}
+
+int mmc_poll_op_cond(struct mmc *mmc)
+{
+	struct mmc_cmd cmd;
+	bool uhs_en;
+	int err;
+
+	if (mmc->sd_op_cond_pending) {
+		uhs_en = supports_uhs(mmc->host_caps);
+		err = sd_send_op_cond_iter(mmc, uhs_en, &cmd);
+		if (!err && !(cmd.response[0] & OCR_BUSY)) {
+			if (get_timer(mmc->op_cond_start) < 1000)
+				return -EAGAIN;
+			err = -EOPNOTSUPP;
+		}
+		mmc->sd_op_cond_pending = 0;
+		mmc_async_done(mmc);
+		if (!err)
+			err = sd_complete_op_cond(mmc, uhs_en, &cmd);
+
+		return err;
+	}
+
+	if (mmc->op_cond_pending) {
+		if (!(mmc->ocr & OCR_BUSY)) {
+			err = mmc_send_op_cond_iter(mmc, 1);
+			if (!err && !(mmc->ocr & OCR_BUSY)) {
+				if (get_timer(mmc->op_cond_start) < 1000)
+					return -EAGAIN;
+				err = -EOPNOTSUPP;
+			}
+		}
+		mmc_async_done(mmc);
+		if (err) {
+			mmc->op_cond_pending = 0;
+			return err;
+		}
+
+		return mmc_complete_op_cond(mmc);
+	}
+	mmc_async_done(mmc);
+
+	return 0;
+}
+
+static void mmc_cyclic_op_cond_poll(struct cyclic_info *c)
+{
+	struct mmc *m = container_of(c, struct mmc, init_cyclic);
+	int err;
+
+	err = mmc_poll_op_cond(m);
+	if (err && err != -EAGAIN) {
+		/*
+		 * The fallback can take a second, which is too long for a
+		 * cyclic function, so let mmc_init() start again instead
+		 */
+		m->init_in_progress = 0;
+	}
+}
+
+int mmc_start_init_async(struct mmc *mmc)
+{
+	int err;
+
+	if (mmc->has_init || mmc->init_in_progress)
+		return 0;
+
+	mmc->async_init = 1;
+	err = mmc_start_init(mmc);
+	if (err || (!mmc->op_cond_pending && !mmc->sd_op_cond_pending)) {
+		mmc->async_init = 0;
+		return err;
+	}
+	cyclic_register(&mmc->init_cyclic, mmc_cyclic_op_cond_poll, 1000,
+			mmc->cfg->name);
+
+	return 0;
+}
+#endif
+
 int mmc_start_init(struct mmc *mmc)
 {
 	bool no_card;
@@ -3027,6 +3204,29 @@ static int mmc_complete_init(struct mmc *mmc)
 	int err = 0;
 
 	mmc->init_in_progress = 0;
+#if CONFIG_IS_ENABLED(MMC_INIT_ASYNC)
+	if (mmc->async_init) {
+		bool sd = mmc->sd_op_cond_pending;
+
+		/*
+		 * Stop polling in the background first, since udelay() runs the
+		 * cyclic functions. Then wait for the card to finish powering up
+		 */
+		mmc_async_done(mmc);
+		do {
+			err = mmc_poll_op_cond(mmc);
+			if (err == -EAGAIN)
+				udelay(100);
+		} while (err == -EAGAIN);
+
+		/* go through the full sequence, with its UHS fallback */
+		if (err && sd) {
+			err = mmc_get_op_cond(mmc, false);
+			if (!err && mmc->op_cond_pending)
+				err = mmc_complete_op_cond(mmc);
+		}
+	} else
+#endif
 	if (mmc->op_cond_pending)
 		err = mmc_complete_op_cond(mmc);
 
@@ -19,6 +19,11 @@ static int mmc_bootdev_bind(struct udevice *dev)
 	return 0;
 }
 
+static int __maybe_unused mmc_bootdev_hunt(struct bootdev_hunter *info, bool show)
+{
+	return mmc_start_init_all();
+}
+
 struct bootdev_ops mmc_bootdev_ops = {
 };
 
@@ -38,5 +43,9 @@ U_BOOT_DRIVER(mmc_bootdev) = {
 BOOTDEV_HUNTER(mmc_bootdev_hunter) = {
 	.prio		= BOOTDEVP_2_INTERNAL_FAST,
 	.uclass		= UCLASS_MMC,
+#if CONFIG_IS_ENABLED(MMC_INIT_ASYNC)
+	.hunt		= mmc_bootdev_hunt,
+	.start		= mmc_bootdev_hunt,
+#endif
 	.drv		= DM_DRIVER_REF(mmc_bootdev),
 };
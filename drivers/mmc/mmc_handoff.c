@@ -0,0 +1,96 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Passing the eMMC bus setup between boot phases
+ *
+ * Selecting HS200/HS400 and tuning the host can take tens of milliseconds.
+ * The result is recorded in the bloblist so that later phases can go straight
+ * to the same setup, provided that the same card is present.
+ */
+
+#define LOG_CATEGORY	UCLASS_MMC
+
+#include <bloblist.h>
+#include <log.h>
+#include <mmc.h>
+#include "mmc_private.h"
+
+static struct mmc_handoff_card *find_card(struct mmc_handoff *ho,
+					  struct mmc *mmc)
+{
+	int i;
+
+	for (i = 0; i < ho->count && i < MMC_HANDOFF_MAX_CARDS; i++) {
+		if (!memcmp(ho->card[i].cid, mmc->cid, sizeof(mmc->cid)))
+			return &ho->card[i];
+	}
+
+	return NULL;
+}
+
+struct mmc_handoff_card *mmc_handoff_find(struct mmc *mmc)
+{
+	struct mmc_handoff *ho;
+
+	ho = bloblist_find(BLOBLISTT_U_BOOT_MMC, sizeof(*ho));
+	if (!ho)
+		return NULL;
+
+	return find_card(ho, mmc);
+}
+
+int mmc_handoff_save(struct mmc *mmc)
+{
+	struct mmc_handoff_card *card;
+	struct mmc_handoff *ho;
+	u32 tap;
+
+	ho = bloblist_ensure(BLOBLISTT_U_BOOT_MMC, sizeof(*ho));
+	if (!ho)
+		return log_msg_ret("blf", -ENOSPC);
+
+	card = find_card(ho, mmc);
+	if (!card) {
+		if (ho->count >= MMC_HANDOFF_MAX_CARDS)
+			return log_msg_ret("ful", -ENOSPC);
+		card = &ho->card[ho->count++];
+		memcpy(card->cid, mmc->cid, sizeof(card->cid));
+	}
+	card->mode = mmc->selected_mode;
+	card->bus_width = mmc->bus_width;
+	card->has_tuning = 0;
+	if (CONFIG_IS_ENABLED(MMC_SUPPORTS_TUNING) &&
+	    !mmc_get_tuning(mmc, &tap)) {
+		card->tuning = tap;
+		card->has_tuning = 1;
+	}
+	card->has_ext_csd = 0;
+	if (mmc->ext_csd) {
+		memcpy(card->ext_csd, mmc->ext_csd, MMC_MAX_BLOCK_LEN);
+		card->has_ext_csd = 1;
+	}
+	log_debug("%s: mode %s, width %d, tuning %s\n", mmc->cfg->name,
+		  mmc_mode_name(mmc->selected_mode), mmc->bus_width,
+		  card->has_tuning ? "saved" : "none");
+
+	return 0;
+}
+
+void mmc_handoff_get_ext_csd(const struct mmc_handoff_card *card, u8 *ext_csd)
+{
+	memcpy(ext_csd, card->ext_csd, MMC_MAX_BLOCK_LEN);
+
+	/* The card has been reset since, which clears these fields */
+	ext_csd[EXT_CSD_PART_CONF] &= ~PART_ACCESS_MASK;
+	ext_csd[EXT_CSD_BUS_WIDTH] = 0;
+	ext_csd[EXT_CSD_HS_TIMING] = 0;
+	ext_csd[EXT_CSD_ERASE_GROUP_DEF] = 0;
+}
+
+void mmc_handoff_update_ext_csd(struct mmc *mmc, u8 index, u8 value)
+{
+	struct mmc_handoff_card *card;
+
+	card = mmc_handoff_find(mmc);
+	if (card && card->has_ext_csd)
+		card->ext_csd[index] = value;
+}
@@ -31,6 +31,7 @@ ulong mmc_bread(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
 ulong mmc_bwrite(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
 		 const void *src);
 ulong mmc_berase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt);
+ulong mmc_bzero(struct udevice *dev, lbaint_t start, lbaint_t blkcnt);
 #else
 ulong mmc_bwrite(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt,
 		 const void *src);
@@ -132,4 +133,81 @@ int mmc_switch_part(struct mmc *mmc, unsigned int part_num);
  */
 int mmc_switch(struct mmc *mmc, u8 set, u8 index, u8 value);
 
+/**
+ * mmc_cancel_async_init() - Stop polling a card set up by mmc_start_init_async()
+ *
+ * This must be called before the device is removed. A later mmc_init() starts
+ * the initialization again from the beginning.
+ *
+ * @mmc:	MMC device
+ */
+void mmc_cancel_async_init(struct mmc *mmc);
+
+#if CONFIG_IS_ENABLED(MMC_HANDOFF)
+/**
+ * mmc_handoff_find() - Find the bus setup recorded for the current card
+ *
+ * This looks in the bloblist for a record whose CID matches @mmc->cid
+ *
+ * @mmc:	MMC device, with the CID already read from the card
+ * Return: pointer to the record, or NULL if none
+ */
+struct mmc_handoff_card *mmc_handoff_find(struct mmc *mmc);
+
+/**
+ * mmc_handoff_save() - Record the bus setup of the current card
+ *
+ * This stores the selected mode, bus width, tuning result and EXT_CSD snapshot
+ * in the bloblist, replacing any existing record for the same card
+ *
+ * @mmc:	MMC device which has completed mode selection
+ * Return: 0 if OK, -ENOSPC if there is no space, other -ve on error
+ */
+int mmc_handoff_save(struct mmc *mmc);
+
+/**
+ * mmc_handoff_get_ext_csd() - Get the EXT_CSD snapshot for a card
+ *
+ * The card has been sent CMD0 since the snapshot was taken, so the fields
+ * which that resets (partition access, bus width, timing and erase group
+ * definition) are cleared in the copy
+ *
+ * @card:	Record found by mmc_handoff_find(), with has_ext_csd set
+ * @ext_csd:	Returns the EXT_CSD register (MMC_MAX_BLOCK_LEN bytes)
+ */
+void mmc_handoff_get_ext_csd(const struct mmc_handoff_card *card, u8 *ext_csd);
+
+/**
+ * mmc_handoff_update_ext_csd() - Track a change to the card's EXT_CSD
+ *
+ * This keeps the EXT_CSD snapshot in sync with a successful mmc_switch(), so
+ * that settings such as the partition configuration are not lost
+ *
+ * @mmc:	MMC device
+ * @index:	EXT_CSD byte which was written
+ * @value:	New value of that byte
+ */
+void mmc_handoff_update_ext_csd(struct mmc *mmc, u8 index, u8 value);
+#else
+static inline struct mmc_handoff_card *mmc_handoff_find(struct mmc *mmc)
+{
+	return NULL;
+}
+
+static inline int mmc_handoff_save(struct mmc *mmc)
+{
+	return 0;
+}
+
+static inline void mmc_handoff_get_ext_csd(const struct mmc_handoff_card *card,
+					   u8 *ext_csd)
+{
+}
+
+static inline void mmc_handoff_update_ext_csd(struct mmc *mmc, u8 index,
+					      u8 value)
+{
+}
+#endif
+
 #endif /* _MMC_PRIVATE_H_ */
@@ -138,6 +138,29 @@ ulong mmc_berase(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt)
 	return blk;
 }
 
+#if CONFIG_IS_ENABLED(BLK)
+ulong mmc_bzero(struct udevice *dev, lbaint_t start, lbaint_t blkcnt)
+{
+	struct blk_desc *block_dev = dev_get_uclass_plat(dev);
+	struct mmc *mmc = find_mmc_device(block_dev->devnum);
+	u32 start_rem, blkcnt_rem;
+
+	if (!mmc || !mmc->erased_zero)
+		return -EOPNOTSUPP;
+
+	/*
+	 * Without trim the card rounds the range out to whole erase groups,
+	 * which would lose the data on either side
+	 */
+	div_u64_rem(start, mmc->erase_grp_size, &start_rem);
+	div_u64_rem(blkcnt, mmc->erase_grp_size, &blkcnt_rem);
+	if ((start_rem || blkcnt_rem) && !mmc->can_trim)
+		return -EOPNOTSUPP;
+
+	return mmc_berase(dev, start, blkcnt);
+}
+#endif
+
 static ulong mmc_write_blocks(struct mmc *mmc, lbaint_t start,
 		lbaint_t blkcnt, const void *src)
 {
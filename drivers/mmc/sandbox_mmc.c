@@ -11,12 +11,16 @@
 #include <malloc.h>
 #include <mmc.h>
 #include <os.h>
+#include <asm/global_data.h>
 #include <asm/test.h>
 
+DECLARE_GLOBAL_DATA_PTR;
+
 struct sandbox_mmc_plat {
 	struct mmc_config cfg;
 	struct mmc mmc;
 	const char *fname;
+	bool emmc;
 };
 
 #define MMC_CMULT		8 /* 8 because the card is high-capacity */
@@ -26,23 +30,104 @@ struct sandbox_mmc_plat {
 /* Granularity of priv->csize - this is 1MB */
 #define SIZE_MULTIPLE		((1 << (MMC_CMULT + 2)) * MMC_BL_LEN)
 
+/* EXT_CSD revision to report for an eMMC card (v4.5) */
+#define MMC_EXT_CSD_REV		6
+
 struct sandbox_mmc_priv {
 	char *buf;
 	int csize;	/* CSIZE value to report */
 	int size;
+	bool emmc;	/* true to emulate an eMMC card rather than SD */
+	int busy_polls;	/* number of op_cond commands to report busy */
+	int cyclic_polls;	/* op_cond commands sent from a cyclic function */
+	u8 ext_csd[MMC_MAX_BLOCK_LEN];
 };
 
+/* Return the OCR busy flag, which is set when the card has powered up */
+static u32 sandbox_mmc_op_cond(struct sandbox_mmc_priv *priv)
+{
+	if (gd->flags & GD_FLG_CYCLIC_RUNNING)
+		priv->cyclic_polls++;
+	if (priv->busy_polls) {
+		priv->busy_polls--;
+		return 0;
+	}
+
+	return OCR_BUSY;
+}
+
+/*
+ * sandbox_emmc_send_cmd() - Emulate the eMMC commands which differ from SD
+ *
+ * Return: -ENOENT if the command is handled as for SD, else the result
+ */
+static int sandbox_emmc_send_cmd(struct sandbox_mmc_priv *priv,
+				 struct mmc_cmd *cmd, struct mmc_data *data)
+{
+	switch (cmd->cmdidx) {
+	case MMC_CMD_GO_IDLE_STATE:
+		/* these fields are reset along with the card */
+		priv->ext_csd[EXT_CSD_PART_CONF] &= ~PART_ACCESS_MASK;
+		priv->ext_csd[EXT_CSD_BUS_WIDTH] = 0;
+		priv->ext_csd[EXT_CSD_HS_TIMING] = 0;
+		priv->ext_csd[EXT_CSD_ERASE_GROUP_DEF] = 0;
+		break;
+	case MMC_CMD_APP_CMD:
+		/* an eMMC card does not answer SD commands */
+		return -ETIMEDOUT;
+	case MMC_CMD_SEND_OP_COND:
+		cmd->response[0] = sandbox_mmc_op_cond(priv) | OCR_HCS |
+				   OCR_VOLTAGE_MASK;
+		break;
+	case MMC_CMD_ALL_SEND_CID:
+		memset(cmd->response, '\0', sizeof(cmd->response));
+		cmd->response[0] = 0x15 << 24;	/* manufacturer ID */
+		break;
+	case MMC_CMD_SEND_CSD:
+		/* high capacity, so only the spec version differs from SD */
+		cmd->response[0] = 4 << 26;
+		cmd->response[1] = (MMC_BL_LEN_SHIFT << 16) |
+				   ((priv->csize >> 16) & 0x3f);
+		cmd->response[2] = (priv->csize & 0xffff) << 16;
+		cmd->response[3] = 0;
+		break;
+	case MMC_CMD_SWITCH:
+		if ((cmd->cmdarg >> 24 & 3) == MMC_SWITCH_MODE_WRITE_BYTE)
+			priv->ext_csd[cmd->cmdarg >> 16 & 0xff] =
+				cmd->cmdarg >> 8 & 0xff;
+		break;
+	case MMC_CMD_SEND_EXT_CSD:
+		/* this is also SD_CMD_SEND_IF_COND, which has no data */
+		if (!data)
+			return -ETIMEDOUT;
+		memcpy(data->dest, priv->ext_csd, MMC_MAX_BLOCK_LEN);
+		break;
+	default:
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
 /**
  * sandbox_mmc_send_cmd() - Emulate SD commands
  *
- * This emulate an SD card version 2. Single-block reads result in zero data.
- * Multiple-block reads return a test string.
+ * This emulate an SD card version 2, or an eMMC card if the 'sandbox,emmc'
+ * property is present. Single-block reads result in zero data. Multiple-block
+ * reads return a test string.
  */
 static int sandbox_mmc_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 				struct mmc_data *data)
 {
 	struct sandbox_mmc_priv *priv = dev_get_priv(dev);
 	static ulong erase_start, erase_end;
+	int ret;
+
+	if (priv->emmc) {
+		ret = sandbox_emmc_send_cmd(priv, cmd, data);
+		if (ret != -ENOENT)
+			return ret;
+	}
 
 	switch (cmd->cmdidx) {
 	case MMC_CMD_ALL_SEND_CID:
@@ -105,7 +190,7 @@ static int sandbox_mmc_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 	}
 #endif
 	case SD_CMD_APP_SEND_OP_COND:
-		cmd->response[0] = OCR_BUSY | OCR_HCS;
+		cmd->response[0] = sandbox_mmc_op_cond(priv) | OCR_HCS;
 		cmd->response[1] = 0;
 		cmd->response[2] = 0;
 		break;
@@ -128,6 +213,21 @@ static int sandbox_mmc_send_cmd(struct udevice *dev, struct mmc_cmd *cmd,
 	return 0;
 }
 
+void sandbox_mmc_set_busy(struct udevice *dev, int polls)
+{
+	struct sandbox_mmc_priv *priv = dev_get_priv(dev);
+
+	priv->busy_polls = polls;
+	priv->cyclic_polls = 0;
+}
+
+int sandbox_mmc_get_cyclic_polls(struct udevice *dev)
+{
+	struct sandbox_mmc_priv *priv = dev_get_priv(dev);
+
+	return priv->cyclic_polls;
+}
+
 static int sandbox_mmc_set_ios(struct udevice *dev)
 {
 	return 0;
@@ -152,6 +252,7 @@ static int sandbox_mmc_of_to_plat(struct udevice *dev)
 	int ret;
 
 	plat->fname = dev_read_string(dev, "filename");
+	plat->emmc = dev_read_bool(dev, "sandbox,emmc");
 
 	ret = mmc_of_parse(dev, cfg);
 	if (ret)
@@ -190,6 +291,20 @@ static int sandbox_mmc_probe(struct udevice *dev)
 		}
 	}
 
+	priv->emmc = plat->emmc;
+	if (priv->emmc) {
+		u32 sectors = priv->size / MMC_MAX_BLOCK_LEN;
+
+		priv->ext_csd[EXT_CSD_REV] = MMC_EXT_CSD_REV;
+		priv->ext_csd[EXT_CSD_CARD_TYPE] = EXT_CSD_CARD_TYPE_26 |
+			EXT_CSD_CARD_TYPE_52;
+		priv->ext_csd[EXT_CSD_BOOT_MULT] = 1;
+		priv->ext_csd[EXT_CSD_SEC_CNT] = sectors;
+		priv->ext_csd[EXT_CSD_SEC_CNT + 1] = sectors >> 8;
+		priv->ext_csd[EXT_CSD_SEC_CNT + 2] = sectors >> 16;
+		priv->ext_csd[EXT_CSD_SEC_CNT + 3] = sectors >> 24;
+	}
+
 	return mmc_init(&plat->mmc);
 }
 
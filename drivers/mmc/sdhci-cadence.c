@@ -129,8 +129,12 @@ static int sdhci_cdns_set_tune_val(struct sdhci_cdns_plat *plat,
 	u32 tmp;
 	int i, ret;
 
-	if (device_is_compatible(plat->mmc.dev, "cdns,sd6hc"))
-		return sdhci_cdns6_set_tune_val(plat, val);
+	if (device_is_compatible(plat->mmc.dev, "cdns,sd6hc")) {
+		ret = sdhci_cdns6_set_tune_val(plat, val);
+		if (!ret)
+			plat->tune_val = val;
+		return ret;
+	}
 
 	if (WARN_ON(!FIELD_FIT(SDHCI_CDNS_HRS06_TUNE, val)))
 		return -EINVAL;
@@ -153,10 +157,30 @@ static int sdhci_cdns_set_tune_val(struct sdhci_cdns_plat *plat,
 		if (ret)
 			return ret;
 	}
+	plat->tune_val = val;
+
+	return 0;
+}
+
+static int __maybe_unused sdhci_cdns_get_tuning(struct udevice *dev, u32 *tap)
+{
+	struct sdhci_cdns_plat *plat = dev_get_plat(dev);
+
+	*tap = plat->tune_val;
 
 	return 0;
 }
 
+static int __maybe_unused sdhci_cdns_set_tuning(struct udevice *dev, u32 tap)
+{
+	struct sdhci_cdns_plat *plat = dev_get_plat(dev);
+
+	if (tap >= SDHCI_CDNS_MAX_TUNING_LOOP)
+		return -EINVAL;
+
+	return sdhci_cdns_set_tune_val(plat, tap);
+}
+
 static int __maybe_unused sdhci_cdns_execute_tuning(struct udevice *dev,
 						    unsigned int opcode)
 {
@@ -232,6 +256,8 @@ static int sdhci_cdns_probe(struct udevice *dev)
 	sdhci_cdns_mmc_ops = sdhci_ops;
 #if CONFIG_IS_ENABLED(MMC_SUPPORTS_TUNING)
 	sdhci_cdns_mmc_ops.execute_tuning = sdhci_cdns_execute_tuning;
+	sdhci_cdns_mmc_ops.get_tuning = sdhci_cdns_get_tuning;
+	sdhci_cdns_mmc_ops.set_tuning = sdhci_cdns_set_tuning;
 #endif
 
 	ret = mmc_of_parse(dev, &plat->cfg);
@@ -636,6 +636,7 @@ static int nvme_get_info_from_identify(struct nvme_dev *dev)
 
 	dev->nn = le32_to_cpu(ctrl->nn);
 	dev->vwc = ctrl->vwc;
+	dev->oncs = le16_to_cpu(ctrl->oncs);
 	memcpy(dev->serial, ctrl->sn, sizeof(ctrl->sn));
 	memcpy(dev->model, ctrl->mn, sizeof(ctrl->mn));
 	memcpy(dev->firmware_rev, ctrl->fr, sizeof(ctrl->fr));
@@ -814,9 +815,37 @@ static ulong nvme_blk_write(struct udevice *udev, lbaint_t blknr,
 	return nvme_blk_rw(udev, blknr, blkcnt, (void *)buffer, false);
 }
 
+static ulong nvme_blk_zero(struct udevice *udev, lbaint_t blknr,
+			   lbaint_t blkcnt)
+{
+	struct nvme_ns *ns = dev_get_priv(udev);
+	struct nvme_dev *dev = ns->dev;
+	struct nvme_command c;
+	lbaint_t done, lbas;
+
+	if (!(dev->oncs & NVME_CTRL_ONCS_WRITE_ZEROES))
+		return -EOPNOTSUPP;
+
+	/* No data is transferred, so only the 16-bit length limits this */
+	memset(&c, '\0', sizeof(c));
+	c.rw.opcode = nvme_cmd_write_zeroes;
+	c.rw.nsid = cpu_to_le32(ns->ns_id);
+	for (done = 0; done < blkcnt; done += lbas) {
+		lbas = min_t(lbaint_t, blkcnt - done, 0x10000);
+		c.rw.slba = cpu_to_le64(blknr + done);
+		c.rw.length = cpu_to_le16(lbas - 1);
+		if (nvme_submit_sync_cmd(dev->queues[NVME_IO_Q], &c, NULL,
+					 IO_TIMEOUT))
+			break;
+	}
+
+	return done;
+}
+
 static const struct blk_ops nvme_blk_ops = {
 	.read	= nvme_blk_read,
 	.write	= nvme_blk_write,
+	.zero	= nvme_blk_zero,
 };
 
 U_BOOT_DRIVER(nvme_blk) = {
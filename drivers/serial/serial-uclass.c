@@ -6,6 +6,7 @@
 #define LOG_CATEGORY UCLASS_SERIAL
 
 #include <config.h>
+#include <cyclic.h>
 #include <dm.h>
 #include <env_internal.h>
 #include <errno.h>
@@ -232,10 +233,109 @@ int serial_initialize(void)
 	return serial_init();
 }
 
+static void __serial_putc(struct udevice *dev, char ch)
+{
+	struct dm_serial_ops *ops = serial_get_ops(dev);
+	int err;
+
+	do {
+		err = ops->putc(dev, ch);
+	} while (err == -EAGAIN);
+}
+
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+/* Interval at which the TX buffer is drained when U-Boot is idle */
+#define SERIAL_TX_POLL_US	1000
+
+/**
+ * serial_tx_drain() - Send characters from the TX buffer to the uart
+ *
+ * @dev: Device to drain
+ * @wait: true to wait until the buffer is empty, false to stop as soon as the
+ *	uart cannot accept any more
+ */
+static void serial_tx_drain(struct udevice *dev, bool wait)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+	struct dm_serial_ops *ops = serial_get_ops(dev);
+	uint rd;
+	int err;
+
+	/* The driver may call schedule(), which can come back here */
+	if (upriv->tx_busy)
+		return;
+	upriv->tx_busy = true;
+	while (upriv->tx_rd_ptr != upriv->tx_wr_ptr) {
+		rd = upriv->tx_rd_ptr % CONFIG_SERIAL_TX_BUFFER_SIZE;
+		err = ops->putc(dev, upriv->tx_buf[rd]);
+		if (err == -EAGAIN) {
+			if (!wait)
+				break;
+			continue;
+		}
+		upriv->tx_rd_ptr++;
+	}
+	upriv->tx_busy = false;
+}
+
+static void serial_tx_cyclic(struct cyclic_info *c)
+{
+	struct serial_dev_priv *upriv = container_of(c, struct serial_dev_priv,
+						     tx_cyclic);
+
+	serial_tx_drain(upriv->dev, false);
+}
+
+static void _serial_tx_putc(struct udevice *dev, char ch)
+{
+	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+	uint wr;
+
+	BUILD_BUG_ON_NOT_POWER_OF_2(CONFIG_SERIAL_TX_BUFFER_SIZE);
+
+	/* Before relocation the device is dropped, along with its buffer */
+	if (!(gd->flags & GD_FLG_RELOC)) {
+		__serial_putc(dev, ch);
+		return;
+	}
+
+	/* Wait for room, unless this is a message from inside the driver */
+	while (upriv->tx_wr_ptr - upriv->tx_rd_ptr ==
+	       CONFIG_SERIAL_TX_BUFFER_SIZE) {
+		if (upriv->tx_busy) {
+			__serial_putc(dev, ch);
+			return;
+		}
+		serial_tx_drain(dev, false);
+	}
+	wr = upriv->tx_wr_ptr++ % CONFIG_SERIAL_TX_BUFFER_SIZE;
+	upriv->tx_buf[wr] = ch;
+
+	serial_tx_drain(dev, false);
+}
+
+static void _serial_tx_flush(struct udevice *dev)
+{
+	serial_tx_drain(dev, true);
+}
+
+#else /* CONFIG_IS_ENABLED(SERIAL_TX_BUFFER) */
+
+static void _serial_tx_putc(struct udevice *dev, char ch)
+{
+	__serial_putc(dev, ch);
+}
+
+static void _serial_tx_flush(struct udevice *dev)
+{
+}
+#endif /* CONFIG_IS_ENABLED(SERIAL_TX_BUFFER) */
+
 static void _serial_flush(struct udevice *dev)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
 
+	_serial_tx_flush(dev);
 	if (!ops->pending)
 		return;
 	while (ops->pending(dev, false) > 0)
@@ -244,15 +344,10 @@ static void _serial_flush(struct udevice *dev)
 
 static void _serial_putc(struct udevice *dev, char ch)
 {
-	struct dm_serial_ops *ops = serial_get_ops(dev);
-	int err;
-
 	if (ch == '\n')
 		_serial_putc(dev, '\r');
 
-	do {
-		err = ops->putc(dev, ch);
-	} while (err == -EAGAIN);
+	_serial_tx_putc(dev, ch);
 
 	if (IS_ENABLED(CONFIG_CONSOLE_FLUSH_ON_NEWLINE) && ch == '\n')
 		_serial_flush(dev);
@@ -278,7 +373,9 @@ static void _serial_puts(struct udevice *dev, const char *str)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
 
-	if (!CONFIG_IS_ENABLED(SERIAL_PUTS) || !ops->puts) {
+	/* The TX buffer takes the place of the driver's puts() */
+	if (!CONFIG_IS_ENABLED(SERIAL_PUTS) || !ops->puts ||
+	    CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)) {
 		while (*str)
 			_serial_putc(dev, *str++);
 		return;
@@ -561,8 +658,10 @@ U_BOOT_ENV_CALLBACK(baudrate, on_baudrate);
 static int serial_post_probe(struct udevice *dev)
 {
 	struct dm_serial_ops *ops = serial_get_ops(dev);
-#if CONFIG_IS_ENABLED(DM_STDIO)
+#if CONFIG_IS_ENABLED(DM_STDIO) || CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
 	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+#endif
+#if CONFIG_IS_ENABLED(DM_STDIO)
 	struct stdio_dev sdev;
 #endif
 	int ret;
@@ -574,6 +673,13 @@ static int serial_post_probe(struct udevice *dev)
 			return ret;
 	}
 
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	upriv->dev = dev;
+	if (gd->flags & GD_FLG_RELOC)
+		cyclic_register(&upriv->tx_cyclic, serial_tx_cyclic,
+				SERIAL_TX_POLL_US, dev->name);
+#endif
+
 #if CONFIG_IS_ENABLED(DM_STDIO)
 	if (!(gd->flags & GD_FLG_RELOC))
 		return 0;
@@ -595,12 +701,20 @@ static int serial_post_probe(struct udevice *dev)
 
 static int serial_pre_remove(struct udevice *dev)
 {
-#if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER)
+#if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER) || \
+	CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
 	struct serial_dev_priv *upriv = dev_get_uclass_priv(dev);
+#endif
 
+#if CONFIG_IS_ENABLED(SYS_STDIO_DEREGISTER)
 	if (stdio_deregister_dev(upriv->sdev, true))
 		return -EPERM;
 #endif
+#if CONFIG_IS_ENABLED(SERIAL_TX_BUFFER)
+	_serial_tx_flush(dev);
+	if (gd->flags & GD_FLG_RELOC)
+		cyclic_unregister(&upriv->tx_cyclic);
+#endif
 
 	return 0;
 }
@@ -383,6 +383,65 @@ static bool cadence_spi_mem_supports_op(struct spi_slave *slave,
 		return spi_mem_default_supports_op(slave, op);
 }
 
+static int cadence_spi_dirmap_create(struct spi_mem_dirmap_desc *desc)
+{
+	struct udevice *bus = desc->slave->dev->parent;
+	struct cadence_spi_priv *priv = dev_get_priv(bus);
+
+	/*
+	 * Only reads can use the AHB window, writes stay indirect. A
+	 * DMA-capable controller reads through its own DMA path instead.
+	 */
+	if (!priv->use_dac_mode || priv->is_dma ||
+	    desc->info.op_tmpl.data.dir != SPI_MEM_DATA_IN)
+		return -EOPNOTSUPP;
+
+	if (!cadence_spi_mem_supports_op(desc->slave, &desc->info.op_tmpl))
+		return -EOPNOTSUPP;
+
+	return 0;
+}
+
+static ssize_t cadence_spi_dirmap_read(struct spi_mem_dirmap_desc *desc,
+				       u64 offs, size_t len, void *buf)
+{
+	struct udevice *bus = desc->slave->dev->parent;
+	struct cadence_spi_priv *priv = dev_get_priv(bus);
+	struct spi_mem_op op = desc->info.op_tmpl;
+	u64 from = desc->info.offset + offs;
+	int ret;
+
+	op.addr.val = from;
+	op.data.buf.in = buf;
+	op.data.nbytes = len;
+
+	/* Small reads and reads beyond the AHB window go through exec_op() */
+	if (len <= CQSPI_STIG_DATA_LEN_MAX || from >= priv->ahbsize) {
+		ret = cadence_spi_mem_exec_op(desc->slave, &op);
+		if (ret)
+			return ret;
+
+		return len;
+	}
+
+	/* Stop at the end of the window, the caller asks again for the rest */
+	len = min_t(u64, len, priv->ahbsize - from);
+
+	cadence_qspi_apb_chipselect(priv->regbase,
+				    spi_chip_select(desc->slave->dev),
+				    priv->is_decoded_cs);
+
+	ret = cadence_qspi_apb_read_setup(priv, &op);
+	if (ret)
+		return ret;
+
+	ret = cadence_qspi_apb_direct_read_execute(priv, from, len, buf);
+	if (ret)
+		return ret;
+
+	return len;
+}
+
 static int cadence_spi_of_to_plat(struct udevice *bus)
 {
 	struct cadence_spi_plat *plat = dev_get_plat(bus);
@@ -442,6 +501,8 @@ static int cadence_spi_of_to_plat(struct udevice *bus)
 static const struct spi_controller_mem_ops cadence_spi_mem_ops = {
 	.exec_op = cadence_spi_mem_exec_op,
 	.supports_op = cadence_spi_mem_supports_op,
+	.dirmap_create = cadence_spi_dirmap_create,
+	.dirmap_read = cadence_spi_dirmap_read,
 };
 
 static const struct dm_spi_ops cadence_spi_ops = {
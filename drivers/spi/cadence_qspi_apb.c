@@ -756,6 +756,19 @@ failrd:
 	return ret;
 }
 
+int cadence_qspi_apb_direct_read_execute(struct cadence_spi_priv *priv,
+					 u64 from, size_t len, void *buf)
+{
+	cadence_qspi_apb_enable_linear_mode(true);
+
+	if (len < 256 || dma_memcpy(buf, priv->ahbbase + from, len) < 0)
+		memcpy_fromio(buf, priv->ahbbase + from, len);
+	if (!cadence_qspi_wait_idle(priv->regbase))
+		return -EIO;
+
+	return 0;
+}
+
 int cadence_qspi_apb_read_execute(struct cadence_spi_priv *priv,
 				  const struct spi_mem_op *op)
 {
@@ -763,17 +776,11 @@ int cadence_qspi_apb_read_execute(struct cadence_spi_priv *priv,
 	void *buf = op->data.buf.in;
 	size_t len = op->data.nbytes;
 
-	cadence_qspi_apb_enable_linear_mode(true);
+	if (priv->use_dac_mode && (from + len < priv->ahbsize))
+		return cadence_qspi_apb_direct_read_execute(priv, from, len,
+							    buf);
 
-	if (priv->use_dac_mode && (from + len < priv->ahbsize)) {
-		if (len < 256 ||
-		    dma_memcpy(buf, priv->ahbbase + from, len) < 0) {
-			memcpy_fromio(buf, priv->ahbbase + from, len);
-		}
-		if (!cadence_qspi_wait_idle(priv->regbase))
-			return -EIO;
-		return 0;
-	}
+	cadence_qspi_apb_enable_linear_mode(true);
 
 	return cadence_qspi_apb_indirect_read_execute(priv, len, buf);
 }
@@ -20,6 +20,12 @@
 
 static bool asynch_allowed;
 
+/* Set when usb_init_start() has queued the root-hub ports for scanning */
+static bool usb_init_pending;
+
+/* Number of controllers found by usb_init_start() */
+static int usb_pending_controllers;
+
 struct usb_uclass_priv {
 	int companion_device_count;
 };
@@ -187,6 +193,8 @@ int usb_stop(void)
 
 	uc_priv = uclass_get_priv(uc);
 
+	usb_init_abort();
+
 	uclass_foreach_dev(bus, uc) {
 		ret = device_remove(bus, DM_REMOVE_NORMAL);
 		if (ret && !err)
@@ -221,25 +229,115 @@ int usb_stop(void)
 	return err;
 }
 
+static void usb_show_bus_scan(struct udevice *bus, int ret)
+{
+	struct usb_bus_priv *priv = dev_get_uclass_priv(bus);
+
+	if (ret)
+		printf("failed, error %d\n", ret);
+	else if (priv->next_addr == 0)
+		printf("No USB Device found\n");
+	else
+		printf("%d USB Device(s) found\n", priv->next_addr);
+}
+
 static void usb_scan_bus(struct udevice *bus, bool recurse)
 {
-	struct usb_bus_priv *priv;
 	struct udevice *dev;
 	int ret;
 
-	priv = dev_get_uclass_priv(bus);
-
 	assert(recurse);	/* TODO: Support non-recusive */
 
 	printf("scanning bus %s for devices... ", bus->name);
 	debug("\n");
 	ret = usb_scan_device(bus, 0, USB_SPEED_FULL, &dev);
+	usb_show_bus_scan(bus, ret);
+}
+
+/**
+ * usb_scan_buses_start() - Start scanning the primary or companion controllers
+ *
+ * With CONFIG_USB_SCAN_PARALLEL the root hubs of all the controllers are set
+ * up first, powering all their ports, and the ports are then scanned together
+ * by usb_scan_buses_finish() so that the power-good and debounce delays
+ * overlap. Otherwise each controller is scanned in turn here.
+ *
+ * @uc: USB uclass
+ * @companion: true to scan the companion controllers, false for the others
+ */
+static void usb_scan_buses_start(struct uclass *uc, bool companion)
+{
+	struct usb_bus_priv *priv;
+	struct udevice *bus, *dev;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_USB_SCAN_PARALLEL)) {
+		uclass_foreach_dev(bus, uc) {
+			if (!device_active(bus))
+				continue;
+
+			priv = dev_get_uclass_priv(bus);
+			if (priv->companion == companion)
+				usb_scan_bus(bus, true);
+		}
+		return;
+	}
+
+	usb_hub_scan_begin();
+	uclass_foreach_dev(bus, uc) {
+		if (!device_active(bus))
+			continue;
+
+		priv = dev_get_uclass_priv(bus);
+		if (priv->companion != companion)
+			continue;
+		ret = usb_scan_device(bus, 0, USB_SPEED_FULL, &dev);
+		if (ret)
+			printf("Bus %s: root hub failed, error %d\n", bus->name,
+			       ret);
+	}
+}
+
+/**
+ * usb_scan_buses_finish() - Scan the ports queued by usb_scan_buses_start()
+ *
+ * @uc: USB uclass
+ * @companion: true for the companion controllers, false for the others
+ * @show_bus: true to show the name of each bus, since usb_init_controllers()
+ *	did not
+ */
+static void usb_scan_buses_finish(struct uclass *uc, bool companion,
+				  bool show_bus)
+{
+	struct usb_bus_priv *priv;
+	struct udevice *bus;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_USB_SCAN_PARALLEL))
+		return;
+
+	ret = usb_hub_scan_complete();
 	if (ret)
-		printf("failed, error %d\n", ret);
-	else if (priv->next_addr == 0)
-		printf("No USB Device found\n");
-	else
-		printf("%d USB Device(s) found\n", priv->next_addr);
+		printf("USB port scan failed, error %d\n", ret);
+
+	uclass_foreach_dev(bus, uc) {
+		if (!device_active(bus))
+			continue;
+
+		priv = dev_get_uclass_priv(bus);
+		if (priv->companion != companion)
+			continue;
+		if (show_bus)
+			printf("Bus %s: ", bus->name);
+		printf("scanning bus %s for devices... ", bus->name);
+		usb_show_bus_scan(bus, 0);
+	}
+}
+
+static void usb_scan_buses(struct uclass *uc, bool companion)
+{
+	usb_scan_buses_start(uc, companion);
+	usb_scan_buses_finish(uc, companion, false);
 }
 
 static void remove_inactive_children(struct uclass *uc, struct udevice *bus)
@@ -287,26 +385,25 @@ static int usb_probe_companion(struct udevice *bus)
 	return 0;
 }
 
-int usb_init(void)
+/**
+ * usb_init_controllers() - Probe the USB controllers
+ *
+ * This sets usb_started if any controller is ready for use
+ *
+ * @uc: USB uclass
+ * @show: true to show the name of each bus as it is probed
+ * Return: number of controllers found
+ */
+static int usb_init_controllers(struct uclass *uc, bool show)
 {
 	int controllers_initialized = 0;
-	struct usb_uclass_priv *uc_priv;
-	struct usb_bus_priv *priv;
 	struct udevice *bus;
-	struct uclass *uc;
 	int ret;
 
-	asynch_allowed = 1;
-
-	ret = uclass_get(UCLASS_USB, &uc);
-	if (ret)
-		return ret;
-
-	uc_priv = uclass_get_priv(uc);
-
 	uclass_foreach_dev(bus, uc) {
 		/* init low_level USB */
-		printf("Bus %s: ", bus->name);
+		if (show)
+			printf("Bus %s: ", bus->name);
 
 		/*
 		 * For Sandbox, we need scan the device tree each time when we
@@ -346,17 +443,78 @@ int usb_init(void)
 		usb_started = true;
 	}
 
+	return controllers_initialized;
+}
+
+int usb_init_start(void)
+{
+	struct uclass *uc;
+	int ret;
+
+	if (!IS_ENABLED(CONFIG_USB_SCAN_PARALLEL))
+		return -ENOSYS;
+	if (usb_started || usb_init_pending)
+		return 0;
+
+	ret = uclass_get(UCLASS_USB, &uc);
+	if (ret)
+		return ret;
+
+	/* This runs in the background, so usb_init() shows the buses later */
+	asynch_allowed = 1;
+	usb_pending_controllers = usb_init_controllers(uc, false);
+	if (!usb_started)
+		return -ENOENT;
+	usb_scan_buses_start(uc, false);
+
+	/* Nothing can use USB until usb_init() has scanned the ports */
+	usb_started = false;
+	usb_init_pending = true;
+
+	return 0;
+}
+
+#if IS_ENABLED(CONFIG_USB_SCAN_PARALLEL)
+void usb_init_abort(void)
+{
+	if (!usb_init_pending)
+		return;
+	usb_hub_scan_abort();
+	usb_init_pending = false;
+}
+#endif
+
+int usb_init(void)
+{
+	int controllers_initialized;
+	struct usb_uclass_priv *uc_priv;
+	struct udevice *bus = NULL;
+	struct uclass *uc;
+	int ret;
+
+	asynch_allowed = 1;
+
+	ret = uclass_get(UCLASS_USB, &uc);
+	if (ret)
+		return ret;
+
+	uc_priv = uclass_get_priv(uc);
+
 	/*
 	 * lowlevel init done, now scan the bus for devices i.e. search HUBs
-	 * and configure them, first scan primary controllers.
+	 * and configure them, first scan primary controllers. If
+	 * usb_init_start() has already powered up the root hubs, just finish
+	 * off its scan.
 	 */
-	uclass_foreach_dev(bus, uc) {
-		if (!device_active(bus))
-			continue;
-
-		priv = dev_get_uclass_priv(bus);
-		if (!priv->companion)
-			usb_scan_bus(bus, true);
+	if (usb_init_pending) {
+		usb_init_pending = false;
+		usb_started = true;
+		controllers_initialized = usb_pending_controllers;
+		usb_scan_buses_finish(uc, false, true);
+	} else {
+		controllers_initialized = usb_init_controllers(uc, true);
+		usb_scan_buses_start(uc, false);
+		usb_scan_buses_finish(uc, false, false);
 	}
 
 	/*
@@ -364,16 +522,8 @@ int usb_init(void)
 	 * over any devices they do not understand to their companions, scan
 	 * the companions if necessary.
 	 */
-	if (uc_priv->companion_device_count) {
-		uclass_foreach_dev(bus, uc) {
-			if (!device_active(bus))
-				continue;
-
-			priv = dev_get_uclass_priv(bus);
-			if (priv->companion)
-				usb_scan_bus(bus, true);
-		}
-	}
+	if (uc_priv->companion_device_count)
+		usb_scan_buses(uc, true);
 
 	debug("scan end\n");
 
@@ -27,6 +27,13 @@ static int usb_bootdev_hunt(struct bootdev_hunter *info, bool show)
 	return usb_init();
 }
 
+#if IS_ENABLED(CONFIG_USB_SCAN_PARALLEL)
+static int usb_bootdev_hunt_start(struct bootdev_hunter *info, bool show)
+{
+	return usb_init_start();
+}
+#endif
+
 struct bootdev_ops usb_bootdev_ops = {
 };
 
@@ -47,5 +54,8 @@ BOOTDEV_HUNTER(usb_bootdev_hunter) = {
 	.prio		= BOOTDEVP_5_SCAN_SLOW,
 	.uclass		= UCLASS_USB,
 	.hunt		= usb_bootdev_hunt,
+#if IS_ENABLED(CONFIG_USB_SCAN_PARALLEL)
+	.start		= usb_bootdev_hunt_start,
+#endif
 	.drv		= DM_DRIVER_REF(usb_bootdev),
 };
@@ -194,6 +194,8 @@ static const struct blk_ops virtio_blk_ops = {
 	.read	= virtio_blk_read,
 	.write	= virtio_blk_write,
 	.erase	= virtio_blk_erase,
+	/* Erase is implemented with write-zeroes, so can be used for both */
+	.zero	= virtio_blk_erase,
 };
 
 U_BOOT_DRIVER(virtio_blk) = {
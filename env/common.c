@@ -31,6 +31,60 @@ DECLARE_GLOBAL_DATA_PTR;
  */
 #include <env_default.h>
 
+#ifdef CONFIG_ENV_DEFAULT_INDEX
+#include <env_index.h>
+#include <generated/env_index.h>
+
+/*
+ * Check that the index was generated from this default environment, since
+ * it can differ, e.g. because the board's environment depends on the
+ * compiler used. The environment is hashed only once, with the result kept
+ * in gd so that this works before relocation.
+ */
+static bool env_index_valid(void)
+{
+	if (!(gd->flags & GD_FLG_ENV_INDEX_CHECKED)) {
+		if (sizeof(default_environment) == ENV_INDEX_ENV_SIZE &&
+		    fnv1a(default_environment, sizeof(default_environment)) ==
+		    ENV_INDEX_ENV_HASH)
+			gd->flags |= GD_FLG_ENV_INDEX_OK;
+		gd->flags |= GD_FLG_ENV_INDEX_CHECKED;
+	}
+
+	return gd->flags & GD_FLG_ENV_INDEX_OK;
+}
+
+/*
+ * Find a variable in the default environment, using the index generated at
+ * build time. This returns -EAGAIN if the index cannot be used, or -ENOENT
+ * if the variable is not in the default environment.
+ */
+static int env_index_find(const char *name, size_t name_len, const char **varp)
+{
+	const char *var;
+	uint i;
+
+	if (!env_index_valid())
+		return -EAGAIN;
+
+	for (i = env_index_hash(name, name_len) & (ENV_INDEX_SLOTS - 1);
+	     env_index[i]; i = (i + 1) & (ENV_INDEX_SLOTS - 1)) {
+		var = default_environment + env_index[i] - 1;
+		if (!strncmp(name, var, name_len) && var[name_len] == '=') {
+			*varp = var;
+			return 0;
+		}
+	}
+
+	return -ENOENT;
+}
+#else
+static int env_index_find(const char *name, size_t name_len, const char **varp)
+{
+	return -EAGAIN;
+}
+#endif
+
 struct hsearch_data env_htab = {
 	.change_ok = env_flags_validate,
 };
@@ -253,39 +307,52 @@ char *from_env(const char *envvar)
 	return ret;
 }
 
+static int env_copy_value(const char *name, const char *value, char *buf,
+			  unsigned len)
+{
+	unsigned res = strlen(value);
+
+	memcpy(buf, value, min(len, res + 1));
+
+	if (len <= res) {
+		buf[len - 1] = '\0';
+		printf("env_buf [%u bytes] too small for value of \"%s\"\n",
+		       len, name);
+	}
+
+	return res;
+}
+
 static int env_get_from_linear(const char *env, const char *name, char *buf,
 			       unsigned len)
 {
 	const char *p, *end;
 	size_t name_len;
+	int ret;
 
 	if (name == NULL || *name == '\0')
 		return -1;
 
 	name_len = strlen(name);
 
-	for (p = env; *p != '\0'; p = end + 1) {
-		const char *value;
-		unsigned res;
+	/* The default environment can be looked up without scanning it */
+	if (env == default_environment) {
+		ret = env_index_find(name, name_len, &p);
+		if (!ret)
+			return env_copy_value(name, &p[name_len + 1], buf, len);
+		if (ret == -ENOENT)
+			return -1;
+	}
 
+	for (p = env; *p != '\0'; p = end + 1) {
 		for (end = p; *end != '\0'; ++end)
 			if (end - env >= CONFIG_ENV_SIZE)
 				return -1;
 
 		if (strncmp(name, p, name_len) || p[name_len] != '=')
 			continue;
-		value = &p[name_len + 1];
-
-		res = end - value;
-		memcpy(buf, value, min(len, res + 1));
-
-		if (len <= res) {
-			buf[len - 1] = '\0';
-			printf("env_buf [%u bytes] too small for value of \"%s\"\n",
-			       len, name);
-		}
 
-		return res;
+		return env_copy_value(name, &p[name_len + 1], buf, len);
 	}
 
 	return -1;
@@ -29,6 +29,7 @@
 #include <search.h>
 #include <errno.h>
 #include <ext4fs.h>
+#include <fs.h>
 #include <mmc.h>
 #include <scsi.h>
 #include <virtio.h>
@@ -75,6 +76,7 @@ static int env_ext4_save_buffer(env_t *env_new)
 		return 1;
 
 	dev = dev_desc->devnum;
+	fs_cache_invalidate(NULL);
 	ext4fs_set_blk_dev(dev_desc, &info);
 
 	if (!ext4fs_mount()) {
@@ -162,6 +164,7 @@ static int env_ext4_load(void)
 		goto err_env_relocate;
 
 	dev = dev_desc->devnum;
+	fs_cache_invalidate(NULL);
 	ext4fs_set_blk_dev(dev_desc, &info);
 
 	if (!ext4fs_mount()) {
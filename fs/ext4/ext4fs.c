@@ -261,6 +261,37 @@ int ext4_read_file(const char *filename, void *buf, loff_t offset, loff_t len,
 	return ext4fs_read(buf, offset, len, len_read);
 }
 
+/*
+ * An open file keeps its node, which holds the inode, so that it can be read
+ * without looking up the path again
+ */
+int ext4fs_open_file(const char *filename, void **privp, loff_t *sizep)
+{
+	if (ext4fs_open(filename, sizep) < 0)
+		return -ENOENT;
+
+	/* The node now belongs to the caller, so ext4fs_close() keeps it */
+	*privp = ext4fs_file;
+	ext4fs_file = NULL;
+
+	return 0;
+}
+
+int ext4fs_pread(void *priv, void *buf, loff_t offset, loff_t len,
+		 loff_t *actread)
+{
+	if (!ext4fs_root)
+		return -ENODEV;
+
+	return ext4fs_read_file(priv, offset, len, buf, actread);
+}
+
+void ext4fs_release_file(void *priv)
+{
+	/* This is never the root node, since it is a regular file */
+	free(priv);
+}
+
 int ext4fs_uuid(char *uuid_str)
 {
 	if (ext4fs_root == NULL)
@@ -1419,6 +1419,67 @@ void fat_closedir(struct fs_dir_stream *dirs)
 	free(dir);
 }
 
+/*
+ * An open file keeps the volume information and its directory entry, so that
+ * it can be read without looking up the path again
+ */
+typedef struct {
+	fsdata fsdata;
+	dir_entry dent;
+} fat_file;
+
+int fat_open_file(const char *filename, void **privp, loff_t *sizep)
+{
+	fat_file *file;
+	fat_itr *itr;
+	int ret;
+
+	file = calloc(1, sizeof(*file));
+	itr = malloc_cache_aligned(sizeof(fat_itr));
+	if (!file || !itr) {
+		ret = -ENOMEM;
+		goto out_free_itr;
+	}
+	ret = fat_itr_root(itr, &file->fsdata);
+	if (ret)
+		goto out_free_itr;
+
+	ret = fat_itr_resolve(itr, filename, TYPE_FILE);
+	if (ret)
+		goto out_free_both;
+
+	file->dent = *itr->dent;
+	*sizep = FAT2CPU32(file->dent.size);
+	*privp = file;
+	free(itr);
+
+	return 0;
+
+out_free_both:
+	free(file->fsdata.fatbuf);
+out_free_itr:
+	free(itr);
+	free(file);
+	return ret;
+}
+
+int fat_pread(void *priv, void *buf, loff_t offset, loff_t len,
+	      loff_t *actread)
+{
+	fat_file *file = priv;
+
+	return get_contents(&file->fsdata, &file->dent, offset, buf, len,
+			    actread);
+}
+
+void fat_release_file(void *priv)
+{
+	fat_file *file = priv;
+
+	free(file->fsdata.fatbuf);
+	free(file);
+}
+
 void fat_close(void)
 {
 }
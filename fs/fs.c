@@ -5,6 +5,7 @@
 
 #define LOG_CATEGORY LOGC_CORE
 
+#include <bootstage.h>
 #include <command.h>
 #include <config.h>
 #include <display_options.h>
@@ -39,9 +40,16 @@ static int fs_dev_part;
 static struct disk_partition fs_partition;
 static int fs_type = FS_TYPE_ANY;
 
+/*
+ * Incremented whenever the current filesystem is closed or may have changed,
+ * so that an open file can tell whether it must be mounted again
+ */
+static uint fs_mount_seq;
+
 void fs_set_type(int type)
 {
 	fs_type = type;
+	fs_mount_seq++;
 }
 
 static inline int fs_probe_unsupported(struct blk_desc *fs_dev_desc,
@@ -182,6 +190,21 @@ struct fstype_info {
 	int (*unlink)(const char *filename);
 	int (*mkdir)(const char *dirname);
 	int (*ln)(const char *filename, const char *target);
+	/*
+	 * Open a file for fs_pread().  On success return 0, the state of the
+	 * open file via 'privp' and its size via 'sizep'.  On error, return
+	 * -errno.  This is optional: without it, fs_pread() uses read() with
+	 * the file's path.  See fs_open().
+	 */
+	int (*open)(const char *filename, void **privp, loff_t *sizep);
+	/* Read from a file opened with open(), see fs_pread() */
+	int (*pread)(void *priv, void *buf, loff_t offset, loff_t len,
+		     loff_t *actread);
+	/*
+	 * Free the state from open().  The filesystem may no longer be
+	 * mounted, so this must not access it.
+	 */
+	void (*release)(void *priv);
 };
 
 static struct fstype_info fstypes[] = {
@@ -210,6 +233,11 @@ static struct fstype_info fstypes[] = {
 		.readdir = fat_readdir,
 		.closedir = fat_closedir,
 		.ln = fs_ln_unsupported,
+#ifndef CONFIG_XPL_BUILD
+		.open = fat_open_file,
+		.pread = fat_pread,
+		.release = fat_release_file,
+#endif
 	},
 #endif
 
@@ -235,6 +263,11 @@ static struct fstype_info fstypes[] = {
 		.opendir = fs_opendir_unsupported,
 		.unlink = fs_unlink_unsupported,
 		.mkdir = fs_mkdir_unsupported,
+#ifndef CONFIG_XPL_BUILD
+		.open = ext4fs_open_file,
+		.pread = ext4fs_pread,
+		.release = ext4fs_release_file,
+#endif
 	},
 #endif
 #if IS_ENABLED(CONFIG_SANDBOX) && !IS_ENABLED(CONFIG_XPL_BUILD)
@@ -392,6 +425,151 @@ static struct fstype_info *fs_get_info(int fstype)
 	return info;
 }
 
+#if CONFIG_IS_ENABLED(FS_MOUNT_CACHE)
+/**
+ * struct fs_mount_cache - The filesystem left mounted by fs_close()
+ *
+ * @desc: Block device, or NULL if nothing is cached
+ * @part: Partition number
+ * @hwpart: Hardware partition selected on @desc
+ * @start: Start block of the partition
+ * @size: Size of the partition in blocks
+ * @fstype: Filesystem type, or FS_TYPE_ANY if the partition has no filesystem
+ * @stale: true if the device has changed during a filesystem operation, so
+ *	the filesystem must be closed when the operation finishes
+ */
+struct fs_mount_cache {
+	struct blk_desc *desc;
+	int part;
+	int hwpart;
+	lbaint_t start;
+	lbaint_t size;
+	int fstype;
+	bool stale;
+};
+
+static struct fs_mount_cache fs_mcache;
+
+/* Close the cached filesystem, if there is one */
+static void fs_cache_drop(void)
+{
+	if (fs_mcache.desc && fs_mcache.fstype != FS_TYPE_ANY) {
+		fs_get_info(fs_mcache.fstype)->close();
+		fs_mount_seq++;
+	}
+	fs_mcache.desc = NULL;
+}
+
+/**
+ * fs_cache_lookup() - Use the cached filesystem for a partition, if any
+ *
+ * Anything else that is cached is closed, so that the partition can be probed
+ *
+ * @desc: Block device, or NULL if none
+ * @part: Partition number, with its information in fs_partition
+ * @fstype: Filesystem type wanted (FS_TYPE_...)
+ * Return: 0 if the filesystem is mounted and now current, -ENOENT if the
+ *	partition is known to have no filesystem, -EAGAIN if it must be probed
+ */
+static int fs_cache_lookup(struct blk_desc *desc, int part, int fstype)
+{
+	struct fs_mount_cache *mc = &fs_mcache;
+
+	/* Filesystems without a block device are not cached */
+	if (!desc)
+		return -EAGAIN;
+
+	if (mc->desc == desc && mc->part == part &&
+	    mc->hwpart == desc->hwpart && mc->start == fs_partition.start &&
+	    mc->size == fs_partition.size && !mc->stale) {
+		if (mc->fstype == FS_TYPE_ANY && fstype == FS_TYPE_ANY) {
+			bootstage_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_HIT,
+					"fs_mount_hit");
+			return -ENOENT;
+		}
+		if (mc->fstype != FS_TYPE_ANY &&
+		    (fstype == FS_TYPE_ANY || fstype == mc->fstype)) {
+			bootstage_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_HIT,
+					"fs_mount_hit");
+			fs_type = mc->fstype;
+			fs_dev_part = part;
+			return 0;
+		}
+	}
+	bootstage_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_MISS, "fs_mount_miss");
+	fs_cache_drop();
+
+	return -EAGAIN;
+}
+
+/**
+ * fs_cache_set() - Record the result of probing a partition
+ *
+ * @info: Filesystem found, or NULL if none
+ * @part: Partition number, with its information in fs_partition
+ * @fstype: Filesystem type which was probed for (FS_TYPE_...)
+ */
+static void fs_cache_set(struct fstype_info *info, int part, int fstype)
+{
+	struct fs_mount_cache *mc = &fs_mcache;
+
+	/* Only remember a missing filesystem if every type was tried */
+	if (!fs_dev_desc || (info && info->null_dev_desc_ok) ||
+	    (!info && fstype != FS_TYPE_ANY))
+		return;
+
+	mc->desc = fs_dev_desc;
+	mc->part = part;
+	mc->hwpart = fs_dev_desc->hwpart;
+	mc->start = fs_partition.start;
+	mc->size = fs_partition.size;
+	mc->fstype = info ? info->fstype : FS_TYPE_ANY;
+	mc->stale = false;
+}
+
+/* Check whether fs_close() can leave the current filesystem mounted */
+static bool fs_cache_keep(void)
+{
+	struct fs_mount_cache *mc = &fs_mcache;
+
+	if (!mc->desc || mc->desc != fs_dev_desc || mc->part != fs_dev_part ||
+	    mc->fstype != fs_type)
+		return false;
+	if (mc->stale) {
+		mc->desc = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+void fs_cache_invalidate(struct blk_desc *desc)
+{
+	if (!fs_mcache.desc || (desc && desc != fs_mcache.desc))
+		return;
+
+	/* An operation may be writing through the filesystem, so wait for it */
+	if (fs_type != FS_TYPE_ANY)
+		fs_mcache.stale = true;
+	else
+		fs_cache_drop();
+}
+#else
+static int fs_cache_lookup(struct blk_desc *desc, int part, int fstype)
+{
+	return -EAGAIN;
+}
+
+static void fs_cache_set(struct fstype_info *info, int part, int fstype)
+{
+}
+
+static bool fs_cache_keep(void)
+{
+	return false;
+}
+#endif
+
 /**
  * fs_get_type() - Get type of current filesystem
  *
@@ -421,13 +599,19 @@ const char *fs_get_type_name(void)
 int fs_set_blk_dev(const char *ifname, const char *dev_part_str, int fstype)
 {
 	struct fstype_info *info;
-	int part, i;
+	int part, ret, i;
 
 	part = part_get_info_by_dev_and_name_or_num(ifname, dev_part_str, &fs_dev_desc,
 						    &fs_partition, 1);
-	if (part < 0)
+	if (part < 0) {
+		fs_mount_seq++;
 		return -1;
+	}
+	ret = fs_cache_lookup(fs_dev_desc, part, fstype);
+	if (ret != -EAGAIN)
+		return ret ? -1 : 0;
 
+	fs_mount_seq++;
 	for (i = 0, info = fstypes; i < ARRAY_SIZE(fstypes); i++, info++) {
 		if (fstype != FS_TYPE_ANY && info->fstype != FS_TYPE_ANY &&
 				fstype != info->fstype)
@@ -439,9 +623,11 @@ int fs_set_blk_dev(const char *ifname, const char *dev_part_str, int fstype)
 		if (!info->probe(fs_dev_desc, &fs_partition)) {
 			fs_type = info->fstype;
 			fs_dev_part = part;
+			fs_cache_set(info, part, fstype);
 			return 0;
 		}
 	}
+	fs_cache_set(NULL, part, fstype);
 
 	return -1;
 }
@@ -456,17 +642,25 @@ int fs_set_blk_dev_with_part(struct blk_desc *desc, int part)
 		ret = part_get_info(desc, part, &fs_partition);
 	else
 		ret = part_get_info_whole_disk(desc, &fs_partition);
-	if (ret)
+	if (ret) {
+		fs_mount_seq++;
 		return ret;
+	}
 	fs_dev_desc = desc;
+	ret = fs_cache_lookup(desc, part, FS_TYPE_ANY);
+	if (ret != -EAGAIN)
+		return ret ? -1 : 0;
 
+	fs_mount_seq++;
 	for (i = 0, info = fstypes; i < ARRAY_SIZE(fstypes); i++, info++) {
 		if (!info->probe(fs_dev_desc, &fs_partition)) {
 			fs_type = info->fstype;
 			fs_dev_part = part;
+			fs_cache_set(info, part, FS_TYPE_ANY);
 			return 0;
 		}
 	}
+	fs_cache_set(NULL, part, FS_TYPE_ANY);
 
 	return -1;
 }
@@ -475,7 +669,11 @@ void fs_close(void)
 {
 	struct fstype_info *info = fs_get_info(fs_type);
 
-	info->close();
+	/* the filesystem stays mounted if it is cached */
+	if (!fs_cache_keep()) {
+		info->close();
+		fs_mount_seq++;
+	}
 
 	fs_type = FS_TYPE_ANY;
 }
@@ -596,6 +794,133 @@ int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 	return _fs_read(filename, addr, offset, len, 0, actread);
 }
 
+/* Open the filesystem-specific state for a file, and get its size */
+static int fs_open_priv(struct fs_file *file, struct fstype_info *info)
+{
+	if (info->open)
+		return info->open(file->path, &file->priv, &file->size);
+	if (info->size(file->path, &file->size))
+		return -ENOENT;
+
+	return 0;
+}
+
+/*
+ * Make sure that the filesystem holding a file is mounted, since any other
+ * filesystem operation may have closed it. If it must be mounted again, the
+ * file is opened again too, since its state may refer to the old mount.
+ *
+ * This updates the file size, so callers must check it afterwards
+ */
+static int fs_file_mount(struct fs_file *file)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+	int ret;
+
+	if (file->mount_seq == fs_mount_seq)
+		return 0;
+
+	if (file->priv) {
+		info->release(file->priv);
+		file->priv = NULL;
+	}
+	if (file->desc) {
+		ret = fs_set_blk_dev_with_part(file->desc, file->part);
+	} else {
+		fs_mount_seq++;
+		ret = info->probe(NULL, &fs_partition);
+		if (!ret)
+			fs_type = file->fstype;
+	}
+	if (ret)
+		return log_msg_ret("mnt", -EIO);
+	if (fs_type != file->fstype) {
+		fs_close();
+		return log_msg_ret("typ", -ESTALE);
+	}
+	/* the file may have been written meanwhile, so update its size */
+	ret = fs_open_priv(file, info);
+	if (ret) {
+		fs_close();
+		return log_msg_ret("opn", ret);
+	}
+	file->mount_seq = fs_mount_seq;
+
+	return 0;
+}
+
+int fs_open(const char *filename, struct fs_file **filep)
+{
+	struct fstype_info *info = fs_get_info(fs_type);
+	struct fs_file *file;
+	int ret;
+
+	if (fs_type == FS_TYPE_ANY)
+		return log_msg_ret("typ", -ENODEV);
+
+	file = calloc(1, sizeof(*file) + strlen(filename) + 1);
+	if (!file) {
+		fs_close();
+		return log_msg_ret("fil", -ENOMEM);
+	}
+	strcpy(file->path, filename);
+	file->desc = fs_dev_desc;
+	file->part = fs_dev_part;
+	file->fstype = fs_type;
+
+	ret = fs_open_priv(file, info);
+	if (ret) {
+		free(file);
+		fs_close();
+		return log_msg_ret("opn", ret);
+	}
+	file->mount_seq = fs_mount_seq;
+	*filep = file;
+
+	return 0;
+}
+
+int fs_pread(struct fs_file *file, void *buf, loff_t offset, loff_t len,
+	     loff_t *actread)
+{
+	struct fstype_info *info = fs_get_info(file->fstype);
+	int ret;
+
+	*actread = 0;
+	if (!len)
+		return 0;
+	ret = fs_file_mount(file);
+	if (ret)
+		return log_msg_ret("pmt", ret);
+	if (offset >= file->size)
+		return 0;
+	len = min(len, file->size - offset);
+
+	if (info->pread)
+		ret = info->pread(file->priv, buf, offset, len, actread);
+	else
+		ret = info->read(file->path, buf, offset, len, actread);
+	if (ret)
+		return log_msg_ret("prd", -EIO);
+
+	return 0;
+}
+
+void fs_closefile(struct fs_file *file)
+{
+	struct fstype_info *info;
+
+	if (!file)
+		return;
+
+	info = fs_get_info(file->fstype);
+	if (file->priv)
+		info->release(file->priv);
+	if (file->mount_seq == fs_mount_seq)
+		fs_close();
+	free(file);
+}
+
 int fs_write(const char *filename, ulong addr, loff_t offset, loff_t len,
 	     loff_t *actwrite)
 {
@@ -24,6 +24,7 @@
 #include <cyclic.h>
 #include <event_internal.h>
 #include <fdtdec.h>
+#include <initcall.h>
 #include <membuff.h>
 #include <linux/list.h>
 #include <linux/build_bug.h>
@@ -243,6 +244,28 @@ struct global_data {
 	 * @uclass_root_s.
 	 */
 	struct list_head *uclass_root;
+# if CONFIG_IS_ENABLED(DM_COMPAT_INDEX)
+	/**
+	 * @dm_compat_index: index of driver compatible strings, used to speed
+	 * up binding. This is NULL until first used, or an ERR_PTR() if it
+	 * could not be allocated
+	 */
+	struct dm_compat_index *dm_compat_index;
+# endif
+# if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+	/**
+	 * @dm_ofnode_index: hash buckets for looking up devices by node
+	 * (first half) and by phandle (second half)
+	 */
+	struct hlist_head *dm_ofnode_index;
+# endif
+# if CONFIG_IS_ENABLED(DM_SNAPSHOT)
+	/**
+	 * @dm_snapshot: snapshot of devices bound by the previous phase, used
+	 * while scanning the devicetree. NULL if none
+	 */
+	const struct dm_snapshot *dm_snapshot;
+# endif
 # if CONFIG_IS_ENABLED(OF_PLATDATA_DRIVER_RT)
 	/** @dm_driver_rt: Dynamic info about the driver */
 	struct driver_rt *dm_driver_rt;
@@ -431,6 +454,12 @@ struct global_data {
 	 */
 	struct event_state event_state;
 #endif
+#if CONFIG_IS_ENABLED(INITCALL_STATS)
+	/**
+	 * @initcall_stats: time taken by each initcall
+	 */
+	struct initcall_stats initcall_stats;
+#endif
 #if CONFIG_IS_ENABLED(CYCLIC)
 	/**
 	 * @cyclic_list: list of registered cyclic functions
@@ -470,6 +499,20 @@ static_assert(sizeof(struct global_data) == GD_SIZE);
 #define gd_set_of_root(_root)
 #endif
 
+#if CONFIG_IS_ENABLED(DM_COMPAT_INDEX)
+#define gd_dm_compat_index()		gd->dm_compat_index
+#define gd_set_dm_compat_index(idx)	gd->dm_compat_index = idx
+#else
+#define gd_dm_compat_index()		NULL
+#define gd_set_dm_compat_index(idx)
+#endif
+
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+#define gd_set_dm_ofnode_index(idx)	gd->dm_ofnode_index = idx
+#else
+#define gd_set_dm_ofnode_index(idx)
+#endif
+
 #if CONFIG_IS_ENABLED(OF_PLATDATA_DRIVER_RT)
 #define gd_set_dm_driver_rt(dyn)	gd->dm_driver_rt = dyn
 #define gd_dm_driver_rt()		gd->dm_driver_rt
@@ -516,7 +559,7 @@ static_assert(sizeof(struct global_data) == GD_SIZE);
 #define gd_set_multi_dtb_fit(_dtb)
 #endif
 
-#if CONFIG_IS_ENABLED(EVENT_DYNAMIC)
+#if CONFIG_IS_ENABLED(EVENT)
 #define gd_event_state()	((struct event_state *)&gd->event_state)
 #else
 #define gd_event_state()	NULL
@@ -665,6 +708,16 @@ enum gd_flags {
 	 * drivers shall not be called.
 	 */
 	GD_FLG_HAVE_CONSOLE = 0x8000000,
+	/**
+	 * @GD_FLG_ENV_INDEX_CHECKED: The build-time index of the default
+	 * environment has been checked against the default environment
+	 */
+	GD_FLG_ENV_INDEX_CHECKED = 0x10000000,
+	/**
+	 * @GD_FLG_ENV_INDEX_OK: The index of the default environment matches
+	 * it, so can be used to look up variables
+	 */
+	GD_FLG_ENV_INDEX_OK = 0x20000000,
 };
 
 #endif /* __ASSEMBLY__ */
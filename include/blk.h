@@ -239,6 +239,24 @@ struct blk_ops {
 	unsigned long (*erase)(struct udevice *dev, lbaint_t start,
 			       lbaint_t blkcnt);
 
+	/**
+	 * zero() - set a section of a block device to zero (optional)
+	 *
+	 * Unlike erase(), the blocks must read back as zero afterwards. This
+	 * lets large zero-filled regions be written without transferring the
+	 * data, e.g. with a write-zeroes command or an erase on a device
+	 * whose erased state is zero.
+	 *
+	 * @dev:	Device to update
+	 * @start:	Start block number to zero (0=first)
+	 * @blkcnt:	Number of blocks to zero
+	 * @return number of blocks zeroed, or -ve error number (see the
+	 * IS_ERR_VALUE() macro). -EOPNOTSUPP means that the device cannot
+	 * zero this range, so the caller should write zeroes instead
+	 */
+	unsigned long (*zero)(struct udevice *dev, lbaint_t start,
+			      lbaint_t blkcnt);
+
 	/**
 	 * select_hwpart() - select a particular hardware partition
 	 *
@@ -291,6 +309,7 @@ unsigned long blk_dwrite(struct blk_desc *block_dev, lbaint_t start,
 			 lbaint_t blkcnt, const void *buffer);
 unsigned long blk_derase(struct blk_desc *block_dev, lbaint_t start,
 			 lbaint_t blkcnt);
+long blk_dzero(struct blk_desc *block_dev, lbaint_t start, lbaint_t blkcnt);
 
 #endif /* BLK */
 
@@ -331,6 +350,21 @@ long blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
  */
 long blk_erase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt);
 
+/**
+ * blk_zero() - Set part of a block device to zero
+ *
+ * This is only possible if the device can do it without being sent the
+ * data, so callers must be prepared to write zeroes themselves
+ *
+ * @dev: Device to update
+ * @start: Start block to zero
+ * @blkcnt: Number of blocks to zero
+ * @return number of blocks zeroed (which may be less than @blkcnt),
+ * -ENOSYS or -EOPNOTSUPP if the device cannot zero this range, or other -ve
+ * on error. This never returns 0 unless @blkcnt is 0
+ */
+long blk_zero(struct udevice *dev, lbaint_t start, lbaint_t blkcnt);
+
 /**
  * blk_find_device() - Find a block device
  *
@@ -576,6 +610,12 @@ static inline ulong blk_derase(struct blk_desc *block_dev, lbaint_t start,
 	return block_dev->block_erase(block_dev, start, blkcnt);
 }
 
+static inline long blk_dzero(struct blk_desc *block_dev, lbaint_t start,
+			     lbaint_t blkcnt)
+{
+	return -ENOSYS;
+}
+
 /**
  * struct blk_driver - Driver for block interface types
  *
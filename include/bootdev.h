@@ -70,6 +70,20 @@ struct bootdev_hunter;
  */
 typedef int (*bootdev_hunter_func)(struct bootdev_hunter *info, bool show);
 
+/**
+ * bootdev_hunter_start_func - function to start hunting in the background
+ *
+ * This should start any slow operations needed to hunt for bootdevs, such as
+ * powering up a bus, without waiting for them to finish. The hunter's hunt()
+ * function is called later to complete the hunt.
+ *
+ * @info: Info structure describing this hunter
+ * @show: true to show information from the hunter
+ * Returns: 0 if OK, -ENOENT on device not found, otherwise -ve on error
+ */
+typedef int (*bootdev_hunter_start_func)(struct bootdev_hunter *info,
+					 bool show);
+
 /**
  * struct bootdev_hunter - information about how to hunt for bootdevs
  *
@@ -77,6 +91,8 @@ typedef int (*bootdev_hunter_func)(struct bootdev_hunter *info, bool show);
  * @uclass: Uclass ID for the media associated with this bootdev
  * @drv: bootdev driver for the things found by this hunter
  * @hunt: Function to call to hunt for bootdevs of this type (NULL if none)
+ * @start: Function to call to start hunting in the background, or NULL if the
+ *	hunter cannot do this. This is only used with CONFIG_BOOTSTD_HUNT_ASYNC
  *
  * Some bootdevs are not visible until other devices are enumerated. For
  * example, USB bootdevs only appear when the USB bus is enumerated.
@@ -86,13 +102,19 @@ typedef int (*bootdev_hunter_func)(struct bootdev_hunter *info, bool show);
  * priority order, so that the fastest bootdevs are discovered first.
  *
  * This struct holds information about the bootdev so we can determine the probe
- * order and how to hunt for bootdevs of this type
+ * order and how to hunt for bootdevs of this type.
+ *
+ * Slow hunters can provide a start() function, so that all of them can wait
+ * for their hardware at the same time. The bootdevs are still used in priority
+ * order, but the time taken to find a slow bootdev then overlaps with the time
+ * spent on the faster ones.
  */
 struct bootdev_hunter {
 	enum bootdev_prio_t prio;
 	enum uclass_id uclass;
 	struct driver *drv;
 	bootdev_hunter_func hunt;
+	bootdev_hunter_start_func start;
 };
 
 /* declare a new bootdev hunter */
@@ -321,6 +343,18 @@ int bootdev_hunt(const char *spec, bool show);
  */
 int bootdev_hunt_prio(enum bootdev_prio_t prio, bool show);
 
+/**
+ * bootdev_hunt_start_all() - Start all hunters which can run in the background
+ *
+ * This calls the start() function of each hunter which has one and has not
+ * been used or started yet. A hunter which fails to start is left to be
+ * hunted in the normal way.
+ *
+ * @show: true to show each hunter as it is started
+ * Returns: 0 if OK, -ve on error
+ */
+int bootdev_hunt_start_all(bool show);
+
 /**
  * bootdev_unhunt() - Mark a device as needing to be hunted again
  *
@@ -20,6 +20,7 @@
 enum bootstage_flags {
 	BOOTSTAGEF_ERROR	= 1 << 0,	/* Error record */
 	BOOTSTAGEF_ALLOC	= 1 << 1,	/* Allocate an id */
+	BOOTSTAGEF_COUNT	= 1 << 2,	/* Counter, not a time */
 };
 
 /* bootstate sub-IDs used for kernel and ramdisk ranges */
@@ -213,6 +214,10 @@ enum bootstage_id {
 	BOOTSTAGE_ID_ACCUM_FSP_M,
 	BOOTSTAGE_ID_ACCUM_FSP_S,
 	BOOTSTAGE_ID_ACCUM_MMAP_SPI,
+	BOOTSTAGE_ID_ACCUM_DM_BIND,
+	BOOTSTAGE_ID_ACCUM_OF_LIVE_LOAD,
+	BOOTSTAGE_ID_COUNT_FS_MOUNT_HIT,
+	BOOTSTAGE_ID_COUNT_FS_MOUNT_MISS,
 
 	/* a few spare for the user, from here */
 	BOOTSTAGE_ID_USER,
@@ -335,6 +340,28 @@ uint32_t bootstage_start(enum bootstage_id id, const char *name);
  */
 uint32_t bootstage_accum(enum bootstage_id id);
 
+/**
+ * bootstage_count() - Count an event
+ *
+ * This turns the given id into a counter, which records how many times
+ * something has happened rather than a time. Counters are shown separately
+ * in the report.
+ *
+ * @id: Bootstage id to count against
+ * @name: Textual name to display for this id in the report (maybe NULL)
+ * Return: new value of the counter, or 0 if there is no space for it
+ */
+ulong bootstage_count(enum bootstage_id id, const char *name);
+
+/**
+ * bootstage_get_count() - Get the value of a counter
+ *
+ * @id: Bootstage id of the counter
+ * Return: number of times bootstage_count() has been called for @id, or 0
+ *	if never
+ */
+ulong bootstage_get_count(enum bootstage_id id);
+
 /* Print a report about boot time */
 void bootstage_report(void);
 
@@ -434,6 +461,16 @@ static inline uint32_t bootstage_accum(enum bootstage_id id)
 	return 0;
 }
 
+static inline ulong bootstage_count(enum bootstage_id id, const char *name)
+{
+	return 0;
+}
+
+static inline ulong bootstage_get_count(enum bootstage_id id)
+{
+	return 0;
+}
+
 static inline int bootstage_stash(void *base, int size)
 {
 	return 0;	/* Pretend to succeed */
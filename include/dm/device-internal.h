@@ -192,6 +192,48 @@ int device_of_to_plat(struct udevice *dev);
  */
 int device_probe(struct udevice *dev);
 
+/**
+ * device_probe_async() - Probe a device, without waiting for it to be ready
+ *
+ * This is the same as device_probe() except that a driver with
+ * DM_FLAG_PROBE_ASYNC is left to complete its probe in the background,
+ * polled by a cyclic function. The device is joined (i.e. its probe is
+ * completed) by the next call to device_probe(), so any user which obtains
+ * the device through the normal uclass functions sees a fully probed device.
+ *
+ * If CONFIG_DM_PROBE_ASYNC is not enabled, this is the same as
+ * device_probe()
+ *
+ * @dev: Pointer to device to probe
+ * Return: 0 if OK (including if the probe is still pending), -ve on error
+ */
+int device_probe_async(struct udevice *dev);
+
+/**
+ * device_probe_complete() - Try to complete a pending probe
+ *
+ * Calls the driver's probe_complete() method once. If this indicates that the
+ * device is ready, the probe is finished, as with device_probe()
+ *
+ * @dev: Device with DM_FLAG_PROBE_PENDING set
+ * Return: 0 if the probe is complete (or was not pending), -EAGAIN if the
+ *	device is not ready yet, other -ve on error, in which case the probe is
+ *	undone
+ */
+int device_probe_complete(struct udevice *dev);
+
+/**
+ * device_probe_join() - Wait for a pending probe to complete
+ *
+ * Removes the device from the queue, if present, then polls it until its
+ * probe completes, running cyclic functions (and so other pending probes)
+ * in the meantime
+ *
+ * @dev: Device with DM_FLAG_PROBE_PENDING set
+ * Return: 0 if OK, -ve if the probe failed
+ */
+int device_probe_join(struct udevice *dev);
+
 /**
  * device_remove() - Remove a device, de-activating it
  *
@@ -437,4 +479,124 @@ static inline int device_notify(const struct udevice *dev, enum event_t type)
 	return 0;
 #endif
 }
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+/**
+ * dev_ofnode_index_init() - Set up the index of devices by node and phandle
+ *
+ * This is called by dm_init() to start with an empty index. The table is
+ * allocated on first use and then reused, so that it does not show up as a
+ * leak in tests which restart driver model.
+ *
+ * Return: 0 if OK, -ENOMEM if out of memory (lookups then walk the devices)
+ */
+int dev_ofnode_index_init(void);
+
+/**
+ * dev_ofnode_index_add() - Add a device to the node index
+ *
+ * This is called when a device is added to its uclass. Devices without a
+ * valid node are not indexed.
+ *
+ * @dev: Device to add
+ */
+void dev_ofnode_index_add(struct udevice *dev);
+
+/**
+ * dev_ofnode_index_del() - Remove a device from the node index
+ *
+ * This does nothing if the device is not in the index
+ *
+ * @dev: Device to remove
+ */
+void dev_ofnode_index_del(struct udevice *dev);
+
+/**
+ * dev_ofnode_index_find() - Find the device for a node using the index
+ *
+ * @node: Node to look up
+ * @id: Uclass to look in, or UCLASS_INVALID to allow any uclass
+ * @devp: Returns the device found
+ * Return: 0 if found, -ENODEV if there is no such device, -EAGAIN if more
+ *	than one device matches (so the caller must search in order), -ENOSYS
+ *	if the index is not available
+ */
+int dev_ofnode_index_find(ofnode node, enum uclass_id id,
+			  struct udevice **devp);
+
+/**
+ * dev_phandle_index_find() - Find the device for a phandle using the index
+ *
+ * @phandle: Phandle to look up
+ * @id: Uclass to look in, or UCLASS_INVALID to allow any uclass
+ * @devp: Returns the device found
+ * Return: 0 if found, -ENODEV if there is no such device, -EAGAIN if more
+ *	than one device matches (so the caller must search in order), -ENOSYS
+ *	if the index is not available
+ */
+int dev_phandle_index_find(uint phandle, enum uclass_id id,
+			   struct udevice **devp);
+#else
+static inline int dev_ofnode_index_init(void)
+{
+	return 0;
+}
+
+static inline void dev_ofnode_index_add(struct udevice *dev) {}
+static inline void dev_ofnode_index_del(struct udevice *dev) {}
+
+static inline int dev_ofnode_index_find(ofnode node, enum uclass_id id,
+					struct udevice **devp)
+{
+	return -ENOSYS;
+}
+
+static inline int dev_phandle_index_find(uint phandle, enum uclass_id id,
+					 struct udevice **devp)
+{
+	return -ENOSYS;
+}
+#endif
+
+#if CONFIG_IS_ENABLED(DM_PROBE_ASYNC)
+/**
+ * device_probe_queue() - Add a device to the pending-probe queue
+ *
+ * The device is polled in the background until its probe is complete. This is
+ * only possible after relocation, since the queue does not survive it.
+ *
+ * @dev: Device with DM_FLAG_PROBE_PENDING set
+ * Return: 0 if OK, -EPERM if it is too early to queue devices, -ENOMEM if out
+ *	of memory
+ */
+int device_probe_queue(struct udevice *dev);
+
+/**
+ * device_probe_dequeue() - Remove a device from the pending-probe queue
+ *
+ * This does nothing if the device is not in the queue
+ *
+ * @dev: Device to remove
+ */
+void device_probe_dequeue(struct udevice *dev);
+
+/**
+ * device_probe_cancel() - Cancel a pending probe
+ *
+ * This is used when a device is removed before its probe has completed. The
+ * device is dropped from the queue and DM_FLAG_PROBE_PENDING is cleared.
+ *
+ * @dev: Device to cancel
+ */
+void device_probe_cancel(struct udevice *dev);
+#else
+static inline int device_probe_queue(struct udevice *dev)
+{
+	return -ENOSYS;
+}
+
+static inline void device_probe_dequeue(struct udevice *dev) {}
+
+static inline void device_probe_cancel(struct udevice *dev) {}
+#endif
+
 #endif
@@ -84,6 +84,15 @@ struct driver_info;
 /* Device must be probed after it was bound */
 #define DM_FLAG_PROBE_AFTER_BIND	(1 << 15)
 
+/*
+ * Driver probes in two phases: probe() starts the hardware and
+ * probe_complete() is polled until it is ready. See device_probe_async()
+ */
+#define DM_FLAG_PROBE_ASYNC		(1 << 16)
+
+/* Device probe has started but probe_complete() has not yet succeeded */
+#define DM_FLAG_PROBE_PENDING		(1 << 17)
+
 /*
  * One or multiple of these flags are passed to device_remove() so that
  * a selective device removal as specified by the remove-stage and the
@@ -159,6 +168,10 @@ enum {
  * (do not access outside driver model)
  * @node_: Reference to device tree node for this device (do not access outside
  *	driver model)
+ * @ofnode_hnode_: Links devices with the same @node_ hash in the node index
+ *	(do not access outside driver model)
+ * @phandle_hnode_: Links devices with the same phandle hash in the node index
+ *	(do not access outside driver model)
  * @devres_head: List of memory allocations associated with this device.
  *		When CONFIG_DEVRES is enabled, devm_kmalloc() and friends will
  *		add to this list. Memory so-allocated will be freed
@@ -189,6 +202,10 @@ struct udevice {
 #if CONFIG_IS_ENABLED(OF_REAL)
 	ofnode node_;
 #endif
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+	struct hlist_node ofnode_hnode_;
+	struct hlist_node phandle_hnode_;
+#endif
 #if CONFIG_IS_ENABLED(DEVRES)
 	struct list_head devres_head;
 #endif
@@ -266,8 +283,13 @@ static inline __attribute_const__ ofnode dev_ofnode(const struct udevice *dev)
 #endif
 }
 
-/* Returns non-zero if the device is active (probed and not removed) */
-#define device_active(dev)	(dev_get_flags(dev) & DM_FLAG_ACTIVATED)
+/*
+ * Returns non-zero if the device is active (probed and not removed). A device
+ * whose probe is still pending is not active yet.
+ */
+#define device_active(dev)	\
+	((dev_get_flags(dev) & (DM_FLAG_ACTIVATED | DM_FLAG_PROBE_PENDING)) == \
+	 DM_FLAG_ACTIVATED)
 
 #if CONFIG_IS_ENABLED(DM_DMA)
 #define dev_set_dma_offset(_dev, _offset)	_dev->dma_offset = _offset
@@ -295,9 +317,21 @@ static inline __attribute_const__ bool dev_has_ofnode(const struct udevice *dev)
 #endif
 }
 
+/**
+ * dev_ofnode_index_update() - Change a device's node, updating the node index
+ *
+ * This is used by dev_set_ofnode() with CONFIG_DM_OFNODE_INDEX
+ *
+ * @dev:	device to update
+ * @node:	new node for the device
+ */
+void dev_ofnode_index_update(struct udevice *dev, ofnode node);
+
 static inline void dev_set_ofnode(struct udevice *dev, ofnode node)
 {
-#if CONFIG_IS_ENABLED(OF_REAL)
+#if CONFIG_IS_ENABLED(DM_OFNODE_INDEX)
+	dev_ofnode_index_update(dev, node);
+#elif CONFIG_IS_ENABLED(OF_REAL)
 	dev->node_ = node;
 #endif
 }
@@ -342,6 +376,10 @@ struct udevice_id {
  * for each.
  * @bind: Called to bind a device to its driver
  * @probe: Called to probe a device, i.e. activate it
+ * @probe_complete: Called to finish probing a device with
+ * DM_FLAG_PROBE_ASYNC. This returns -EAGAIN if the device is not ready yet,
+ * 0 when it is ready, or another -ve error if the probe failed. It is called
+ * repeatedly after @probe until it returns something other than -EAGAIN
  * @remove: Called to remove a device, i.e. de-activate it
  * @unbind: Called to unbind a device from its driver
  * @of_to_plat: Called before probe to decode device tree data
@@ -377,6 +415,7 @@ struct driver {
 	const struct udevice_id *of_match;
 	int (*bind)(struct udevice *dev);
 	int (*probe)(struct udevice *dev);
+	int (*probe_complete)(struct udevice *dev);
 	int (*remove)(struct udevice *dev);
 	int (*unbind)(struct udevice *dev);
 	int (*of_to_plat)(struct udevice *dev);
@@ -23,6 +23,20 @@
  */
 struct driver *lists_driver_lookup_name(const char *name);
 
+/**
+ * lists_driver_lookup_compat() - Find the driver for a compatible string
+ *
+ * This returns the first driver (in linker-list order) with an of_match
+ * entry for @compat. With CONFIG_DM_COMPAT_INDEX this uses a hash index of
+ * all compatible strings, built on first use.
+ *
+ * @compat: Compatible string to look up
+ * @idp: Returns the of_match entry which matched
+ * Return: pointer to driver, or NULL if not found
+ */
+struct driver *lists_driver_lookup_compat(const char *compat,
+					  const struct udevice_id **idp);
+
 /**
  * lists_uclass_lookup() - Return uclass_driver based on ID of the class
  *
@@ -49,6 +49,12 @@ struct property {
  * @parent: Pointer to parent node, or NULL if this is the root node
  * @child: Pointer to head of child node list, or NULL if no children
  * @sibling: Pointer to the next sibling node, or NULL if this is the last
+ * @lazy_blob: Flat tree holding the properties of this node, if they have not
+ *	been loaded yet (see CONFIG_OF_LIVE_LAZY), else NULL. Use
+ *	of_node_props() to access @properties
+ * @lazy_offset: Offset of this node in @lazy_blob
+ * @lazy_props: Memory holding the properties, once they have been loaded from
+ *	@lazy_blob. This is freed by of_live_free()
  */
 struct device_node {
 	const char *name;
@@ -60,6 +66,11 @@ struct device_node {
 	struct device_node *parent;
 	struct device_node *child;
 	struct device_node *sibling;
+#if CONFIG_IS_ENABLED(OF_LIVE_LAZY)
+	const void *lazy_blob;
+	int lazy_offset;
+	void *lazy_props;
+#endif
 };
 
 #define BAD_OF_ROOT	0xdead11e3
@@ -17,7 +17,9 @@
 #ifndef _DM_OF_ACCESS_H
 #define _DM_OF_ACCESS_H
 
+#include <of_live.h>
 #include <dm/of.h>
+#include <linux/err.h>
 
 /**
  * of_find_all_nodes - Get next node in global list
@@ -33,6 +35,30 @@ struct device_node *of_find_all_nodes(struct device_node *prev);
 	for (dn = of_find_all_nodes(from); dn; dn = of_find_all_nodes(dn))
 #define for_each_of_allnodes(dn) for_each_of_allnodes_from(NULL, dn)
 
+/**
+ * of_node_props() - Get the list of properties for a node
+ *
+ * With CONFIG_OF_LIVE_LAZY the properties are loaded from the flat tree on
+ * first access, so this must be used instead of accessing np->properties
+ * directly
+ *
+ * @np: Node to check
+ * Return: Pointer to the first property, NULL if none, or ERR_PTR(-ENOMEM) if
+ *	the properties could not be loaded
+ */
+static inline struct property *of_node_props(const struct device_node *np)
+{
+#if CONFIG_IS_ENABLED(OF_LIVE_LAZY)
+	if (np->lazy_blob) {
+		int ret = of_live_load_props((struct device_node *)np);
+
+		if (ret)
+			return ERR_PTR(ret);
+	}
+#endif
+	return np->properties;
+}
+
 /* Dummy functions to mirror Linux. These are not used in U-Boot */
 #define of_node_get(x) (x)
 static inline void of_node_put(const struct device_node *np) { }
@@ -110,7 +136,8 @@ const void *of_get_property(const struct device_node *np, const char *name,
  * and read all the property with of_get_next_property_by_prop().
  *
  * @np: Pointer to device node
- * Return: pointer to property or NULL if not found
+ * Return: pointer to property, NULL if not found, or ERR_PTR(-ENOMEM) if the
+ *	properties could not be loaded
  */
 const struct property *of_get_first_property(const struct device_node *np);
 
@@ -171,6 +171,21 @@ int dm_remove_devices_flags(uint flags);
 static inline int dm_remove_devices_flags(uint flags) { return 0; }
 #endif
 
+#if CONFIG_IS_ENABLED(DM_PROBE_ASYNC)
+/**
+ * dm_probe_join_all() - Wait for all pending probes to complete
+ *
+ * This completes the probe of every device started with device_probe_async()
+ * which is still pending. It should be called before anything which relies
+ * on all devices being quiescent, e.g. booting an OS.
+ *
+ * Return: 0 if OK, or the first error from a failed probe
+ */
+int dm_probe_join_all(void);
+#else
+static inline int dm_probe_join_all(void) { return 0; }
+#endif
+
 /**
  * dm_get_stats() - Get some stats for driver mode
  *
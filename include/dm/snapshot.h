@@ -0,0 +1,78 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Snapshot of bound devices, passed from one phase to the next
+ *
+ * Each phase of U-Boot binds devices from the devicetree by matching
+ * compatible strings against the drivers it contains. A phase can record which
+ * driver each node was bound to, so that the next phase (with the same set of
+ * drivers) can bind those nodes without matching again.
+ */
+
+#ifndef __DM_SNAPSHOT_H
+#define __DM_SNAPSHOT_H
+
+#include <dm/ofnode.h>
+
+struct driver;
+struct udevice_id;
+
+#if CONFIG_IS_ENABLED(DM_SNAPSHOT)
+/**
+ * dm_snapshot_begin() - Start using the snapshot from the previous phase
+ *
+ * This checks that the snapshot in the bloblist was written by a phase with
+ * the same drivers and devicetree, and if so makes it available to
+ * dm_snapshot_lookup()
+ *
+ * Return: 0 if OK, -ENOENT if there is no snapshot, -ESTALE if it does not
+ *	match this phase
+ */
+int dm_snapshot_begin(void);
+
+/**
+ * dm_snapshot_end() - Stop using the snapshot from the previous phase
+ */
+void dm_snapshot_end(void);
+
+/**
+ * dm_snapshot_lookup() - Look up the driver for a node in the snapshot
+ *
+ * @node: Node to look up
+ * @drvp: Returns the driver which was bound to the node
+ * @idp: Returns the matching entry in the driver's of_match table
+ * Return: 0 if found, -ENOENT if not
+ */
+int dm_snapshot_lookup(ofnode node, struct driver **drvp,
+		       const struct udevice_id **idp);
+
+/**
+ * dm_snapshot_write() - Write a snapshot of the bound devices
+ *
+ * This records the driver for each device bound from the flat devicetree,
+ * replacing any existing snapshot in the bloblist
+ *
+ * Return: 0 if OK, -ENOSPC if there is no space in the bloblist, -EPERM if a
+ *	live tree is in use
+ */
+int dm_snapshot_write(void);
+#else
+static inline int dm_snapshot_begin(void)
+{
+	return -ENOENT;
+}
+
+static inline void dm_snapshot_end(void) {}
+
+static inline int dm_snapshot_lookup(ofnode node, struct driver **drvp,
+				     const struct udevice_id **idp)
+{
+	return -ENOENT;
+}
+
+static inline int dm_snapshot_write(void)
+{
+	return 0;
+}
+#endif
+
+#endif
@@ -331,6 +331,30 @@ int dma_get_device(u32 transfer_type, struct udevice **devp);
 	     transferred and on failure return error code.
  */
 int dma_memcpy(void *dst, void *src, size_t len);
+
+#if CONFIG_IS_ENABLED(DMA_MEMCPY_OFFLOAD)
+/**
+ * dma_memcpy_try() - Try to copy a large region of memory using DMA
+ *
+ * This is used for copies which may be large enough to benefit from DMA. The
+ * copy is only done if it is at least CONFIG_DMA_MEMCPY_OFFLOAD_MIN bytes, the
+ * regions do not overlap and @dst and @src have the same alignment within a
+ * cache line. Any partial cache lines at either end are copied by the CPU.
+ *
+ * @dst: Destination pointer
+ * @src: Source pointer
+ * @len: Number of bytes to copy
+ * Return: 0 if copied, -EINVAL if the copy is not suitable for DMA, other -ve
+ *	value if DMA failed. If non-zero, nothing was copied, so the caller
+ *	must do the copy itself
+ */
+int dma_memcpy_try(void *dst, const void *src, size_t len);
+#else
+static inline int dma_memcpy_try(void *dst, const void *src, size_t len)
+{
+	return -ENOSYS;
+}
+#endif
 #else
 static inline int dma_get_device(u32 transfer_type, struct udevice **devp)
 {
@@ -341,5 +365,10 @@ static inline int dma_memcpy(void *dst, void *src, size_t len)
 {
 	return -ENOSYS;
 }
+
+static inline int dma_memcpy_try(void *dst, const void *src, size_t len)
+{
+	return -ENOSYS;
+}
 #endif /* CONFIG_DMA */
 #endif	/* _DMA_H_ */
@@ -0,0 +1,28 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Index of the default environment
+ *
+ * The index is generated at build time by 'printinitialenv -i', into
+ * include/generated/env_index.h, so that variables can be found in the
+ * default environment without scanning it. This header is shared by that
+ * host tool and U-Boot, so must not use U-Boot types.
+ */
+
+#ifndef __ENV_INDEX_H
+#define __ENV_INDEX_H
+
+#include <u-boot/fnv.h>
+
+/**
+ * env_index_hash() - Hash a variable name for the default-environment index
+ *
+ * @name: Variable name, which need not be nul-terminated
+ * @len: Length of @name in bytes
+ * Return: hash value
+ */
+static inline unsigned int env_index_hash(const char *name, unsigned int len)
+{
+	return fnv1a(name, len);
+}
+
+#endif
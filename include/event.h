@@ -337,6 +337,33 @@ int event_register(const char *id, enum event_t type, event_handler_t func,
 /** event_show_spy_list( - Show a list of event spies */
 void event_show_spy_list(void);
 
+/**
+ * struct event_stats - statistics for an event type
+ *
+ * @count: Number of times the event was sent
+ * @time_us: Total time spent in spies for this event, in microseconds. Time
+ *	is only recorded once a timer is available
+ * @max_us: Longest time spent handling a single event, in microseconds
+ */
+struct event_stats {
+	uint count;
+	ulong time_us;
+	ulong max_us;
+};
+
+/**
+ * event_get_stats() - Get the statistics for an event type
+ *
+ * This is only available with CONFIG_EVENT_STATS
+ *
+ * @type: Event type
+ * Return: statistics for that type, or NULL if not available
+ */
+const struct event_stats *event_get_stats(enum event_t type);
+
+/** event_show_stats() - Show statistics for each event type */
+void event_show_stats(void);
+
 /**
  * event_type_name() - Get the name of an event type
  *
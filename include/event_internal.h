@@ -28,8 +28,25 @@ struct event_spy {
 	void *ctx;
 };
 
+/**
+ * struct event_state - state of the event subsystem, held in global_data
+ *
+ * @spy_head: List of dynamic spies for each event type
+ * @static_first: Index of the first static spy for each event type
+ * @static_end: Index after the last static spy for each event type
+ * @static_ready: true once @static_first and @static_end are set up
+ * @stats: Statistics for each event type
+ */
 struct event_state {
-	struct list_head spy_head;
+#if CONFIG_IS_ENABLED(EVENT_DYNAMIC)
+	struct list_head spy_head[EVT_COUNT];
+#endif
+	u16 static_first[EVT_COUNT];
+	u16 static_end[EVT_COUNT];
+	bool static_ready;
+#if CONFIG_IS_ENABLED(EVENT_STATS)
+	struct event_stats stats[EVT_COUNT];
+#endif
 };
 
 #endif
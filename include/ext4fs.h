@@ -198,6 +198,10 @@ int ext4fs_create_link(const char *target, const char *fname);
 struct ext_filesystem *get_fs(void);
 int ext4fs_open(const char *filename, loff_t *len);
 int ext4fs_read(char *buf, loff_t offset, loff_t len, loff_t *actread);
+int ext4fs_open_file(const char *filename, void **privp, loff_t *sizep);
+int ext4fs_pread(void *priv, void *buf, loff_t offset, loff_t len,
+		 loff_t *actread);
+void ext4fs_release_file(void *priv);
 int ext4fs_mount(void);
 void ext4fs_close(void);
 void ext4fs_reinit_global(void);
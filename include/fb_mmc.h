@@ -8,6 +8,7 @@
 
 struct blk_desc;
 struct disk_partition;
+struct sparse_stream;
 
 /**
  * fastboot_mmc_get_part_info() - Lookup eMMC partion by name
@@ -39,4 +40,22 @@ void fastboot_mmc_flash_write(const char *cmd, void *download_buffer,
  * @response: Pointer to fastboot response buffer
  */
 void fastboot_mmc_erase(const char *cmd, char *response);
+
+/**
+ * fastboot_mmc_stream_start() - Start writing an image to eMMC as it arrives
+ *
+ * The image may be sparse or raw. It is written by passing the data to
+ * sparse_stream_write() and then calling sparse_stream_finish()
+ *
+ * @cmd: Named partition to write image to
+ * @ss: Stream to set up
+ * @buf: Buffer to collect the data in
+ * @buf_size: Size of @buf in bytes
+ * @image_size: Size of the image in bytes
+ * @response: Pointer to fastboot response buffer
+ * Return: 0 if OK, -ve on error
+ */
+int fastboot_mmc_stream_start(const char *cmd, struct sparse_stream *ss,
+			      void *buf, size_t buf_size, u32 image_size,
+			      char *response);
 #endif
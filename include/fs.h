@@ -87,9 +87,29 @@ int fs_set_blk_dev_with_part(struct blk_desc *desc, int part);
  * Many file functions implicitly call fs_close(), e.g. fs_closedir(),
  * fs_exist(), fs_ln(), fs_ls(), fs_mkdir(), fs_read(), fs_size(), fs_write(),
  * fs_unlink().
+ *
+ * With FS_MOUNT_CACHE the filesystem may be left mounted, so that it can be
+ * used again by the next fs_set_blk_dev() for the same partition.
  */
 void fs_close(void);
 
+#if CONFIG_IS_ENABLED(FS_MOUNT_CACHE)
+/**
+ * fs_cache_invalidate() - Drop the mounted filesystem of a block device
+ *
+ * This must be called when a block device is written, changed or removed
+ * other than through the filesystem layer, and before using a filesystem
+ * driver directly. If a filesystem operation is in progress, the filesystem
+ * is closed by the next fs_close().
+ *
+ * @desc: Block device which has changed, or NULL to drop the mounted
+ *	filesystem whatever its device
+ */
+void fs_cache_invalidate(struct blk_desc *desc);
+#else
+static inline void fs_cache_invalidate(struct blk_desc *desc) {}
+#endif
+
 /**
  * fs_get_type() - Get type of current filesystem
  *
@@ -165,6 +185,79 @@ int fs_read(const char *filename, ulong addr, loff_t offset, loff_t len,
 int fs_write(const char *filename, ulong addr, loff_t offset, loff_t len,
 	     loff_t *actwrite);
 
+/**
+ * struct fs_file - A file opened with fs_open()
+ *
+ * Apart from @size, this should be treated as opaque to the user of the fs
+ * layer
+ *
+ * @size: Size of the file in bytes
+ * @desc: Block device holding the filesystem, or NULL if none
+ * @part: Partition number on @desc
+ * @fstype: Filesystem type (FS_TYPE_...)
+ * @mount_seq: Mount sequence number when the filesystem was last mounted for
+ *	this file. If it has changed, the filesystem must be mounted again
+ * @priv: Filesystem-specific state of the open file, or NULL if none
+ * @path: Path of the file
+ */
+struct fs_file {
+	loff_t size;
+	struct blk_desc *desc;
+	int part;
+	int fstype;
+	uint mount_seq;
+	void *priv;
+	char path[];
+};
+
+/**
+ * fs_open() - Open a file for reading in pieces
+ *
+ * This opens a file on the partition previously set by fs_set_blk_dev(), which
+ * is left mounted so that the file can be read with fs_pread() without
+ * mounting the filesystem and looking up the path again. Where the filesystem
+ * supports it, the file's inode or directory entry is kept too.
+ *
+ * Other filesystem functions can be used while the file is open. If they
+ * close the filesystem, it is mounted again on the next fs_pread().
+ *
+ * On error, the filesystem is closed, as with fs_read()
+ *
+ * @filename: Full path of the file to open
+ * @filep: Returns the open file, which must be closed with fs_closefile()
+ * Return: 0 if OK, -ENODEV if no filesystem is set, -ENOMEM if out of memory,
+ *	-ENOENT if the file does not exist, other -ve value on other error
+ */
+int fs_open(const char *filename, struct fs_file **filep);
+
+/**
+ * fs_pread() - Read part of a file opened with fs_open()
+ *
+ * Unlike fs_read(), a @len of 0 reads nothing. Reading stops at the end of
+ * the file.
+ *
+ * @file: File to read from
+ * @buf: Buffer to read into
+ * @offset: Offset in the file from where to start reading
+ * @len: Maximum number of bytes to read
+ * @actread: Returns the actual number of bytes read, which is 0 if @offset is
+ *	at or beyond the end of the file
+ * Return: 0 if OK, -ESTALE if the filesystem has changed type, -EIO on read
+ *	error, other -ve value if the file could not be opened again
+ */
+int fs_pread(struct fs_file *file, void *buf, loff_t offset, loff_t len,
+	     loff_t *actread);
+
+/**
+ * fs_closefile() - Close a file opened with fs_open()
+ *
+ * This also closes the filesystem, if it is still mounted for the file. Note
+ * that fs_close() does something different: it closes the filesystem.
+ *
+ * @file: File to close, or NULL to do nothing
+ */
+void fs_closefile(struct fs_file *file);
+
 /*
  * Directory entry types, matches the subset of DT_x in posix readdir()
  * which apply to u-boot.
@@ -26,6 +26,15 @@ struct sparse_storage {
 				 lbaint_t blk,
 				 lbaint_t blkcnt);
 
+	/*
+	 * Optional: set blocks to zero without sending the data, returning
+	 * the number of blocks zeroed. If this does not zero them all, the
+	 * zeroes are written instead
+	 */
+	lbaint_t	(*zero)(struct sparse_storage *info,
+				lbaint_t blk,
+				lbaint_t blkcnt);
+
 	void		(*mssg)(const char *str, char *response);
 };
 
@@ -42,3 +51,135 @@ static inline int is_sparse_image(void *buf)
 
 int write_sparse_image(struct sparse_storage *info, const char *part_name,
 		       void *data, char *response);
+
+/**
+ * enum sparse_stream_state - What a sparse stream expects to receive next
+ *
+ * @SPARSE_STREAM_FILE_HDR: Sparse-image header, or the start of a raw image
+ * @SPARSE_STREAM_CHUNK_HDR: Chunk header
+ * @SPARSE_STREAM_FILL_VAL: Fill value of a FILL chunk
+ * @SPARSE_STREAM_DATA: Data of a RAW chunk, or a raw image
+ * @SPARSE_STREAM_SKIP: Bytes to be ignored
+ * @SPARSE_STREAM_DONE: All chunks have been received
+ * @SPARSE_STREAM_ERROR: An error occurred, so nothing more is written
+ */
+enum sparse_stream_state {
+	SPARSE_STREAM_FILE_HDR,
+	SPARSE_STREAM_CHUNK_HDR,
+	SPARSE_STREAM_FILL_VAL,
+	SPARSE_STREAM_DATA,
+	SPARSE_STREAM_SKIP,
+	SPARSE_STREAM_DONE,
+	SPARSE_STREAM_ERROR,
+};
+
+/**
+ * struct sparse_stream - An image being written to storage as it arrives
+ *
+ * The image may be a sparse image or a raw one. Data is collected in two
+ * buffers in turn: when one is full it becomes pending and is written by
+ * sparse_stream_flush(), while the other collects the data which follows.
+ *
+ * The storage's write() method must write exactly the number of blocks asked
+ * for, since later chunks may arrive before earlier ones are written
+ *
+ * @info: Storage to write to
+ * @buf: The two buffers, each @buf_size bytes
+ * @buf_size: Size of each buffer in bytes, a multiple of the block size
+ * @cur: Index of the buffer being filled
+ * @fill: Number of bytes in the buffer being filled
+ * @buf_start: Block at which the buffer being filled is to be written
+ * @next_blk: Block at which the next buffer is to be written, if it continues
+ *	the data in the current one
+ * @pending_start: Block at which the pending buffer is to be written
+ * @pending_blks: Number of blocks in the pending buffer, 0 if none
+ * @state: What is expected next
+ * @image_size: Size of the whole image in bytes
+ * @hdr: Header being collected
+ * @hdr_len: Number of bytes of @hdr collected so far
+ * @hdr_size: Number of bytes of @hdr expected, or to skip for
+ *	SPARSE_STREAM_SKIP
+ * @blk: Block at which the next chunk starts
+ * @chunk_left: Number of data bytes still to come in the current chunk
+ * @chunks_left: Number of chunks still to come
+ * @total_blocks: Number of sparse blocks covered by the chunks so far
+ * @bytes_written: Number of bytes written or filled so far
+ * @sparse_hdr: Header of the sparse image
+ */
+struct sparse_stream {
+	struct sparse_storage *info;
+	void *buf[2];
+	size_t buf_size;
+	int cur;
+	size_t fill;
+	lbaint_t buf_start;
+	lbaint_t next_blk;
+	lbaint_t pending_start;
+	lbaint_t pending_blks;
+	enum sparse_stream_state state;
+	u64 image_size;
+	union {
+		sparse_header_t file;
+		chunk_header_t chunk;
+		u32 fill_val;
+	} hdr;
+	uint hdr_len;
+	uint hdr_size;
+	lbaint_t blk;
+	u64 chunk_left;
+	uint chunks_left;
+	u32 total_blocks;
+	u64 bytes_written;
+	sparse_header_t sparse_hdr;
+};
+
+/**
+ * sparse_stream_start() - Start writing an image as it arrives
+ *
+ * @ss: Stream to set up
+ * @info: Storage to write to, which must remain valid until the stream is
+ *	finished
+ * @buf: Buffer to use, aligned for DMA. This is split into two
+ * @buf_size: Size of @buf in bytes, at least two blocks
+ * @image_size: Total size of the image which will be written, in bytes
+ * Return: 0 if OK, -EINVAL if @buf_size is too small
+ */
+int sparse_stream_start(struct sparse_stream *ss, struct sparse_storage *info,
+			void *buf, size_t buf_size, u64 image_size);
+
+/**
+ * sparse_stream_write() - Handle the next part of an image
+ *
+ * This parses any headers, writes FILL chunks and collects RAW data in the
+ * stream's buffers. A full buffer is left pending, to be written by a later
+ * call to sparse_stream_flush(), so that the caller can start receiving more
+ * data first.
+ *
+ * @ss: Stream to write to
+ * @data: Data received
+ * @len: Number of bytes in @data
+ * @response: Buffer for a message to the host on error
+ * Return: 0 if OK, -ve on error
+ */
+int sparse_stream_write(struct sparse_stream *ss, const void *data,
+			size_t len, char *response);
+
+/**
+ * sparse_stream_flush() - Write the pending buffer, if any, to storage
+ *
+ * @ss: Stream to flush
+ * @response: Buffer for a message to the host on error
+ * Return: 0 if OK, -EIO on error
+ */
+int sparse_stream_flush(struct sparse_stream *ss, char *response);
+
+/**
+ * sparse_stream_finish() - Write the rest of an image and check it
+ *
+ * @ss: Stream to finish
+ * @part_name: Name of the partition being written, for messages
+ * @response: Buffer for a message to the host on error
+ * Return: 0 if OK, -ve on error
+ */
+int sparse_stream_finish(struct sparse_stream *ss, const char *part_name,
+			 char *response);
@@ -8,6 +8,7 @@
 
 #include <asm/types.h>
 #include <event.h>
+#include <linux/bitops.h>
 
 _Static_assert(EVT_COUNT < 256, "Can only support 256 event types with 8 bits");
 
@@ -24,6 +25,45 @@ typedef int (*init_fnc_t)(void);
 
 #define INITCALL_EVENT(_type)	(void *)((_type) | INITCALL_IS_EVENT)
 
+/* Flags for struct initcall_stat */
+enum {
+	INITCALL_STATF_EVENT	= BIT(0),	/* @addr is an event type */
+	INITCALL_STATF_FAILED	= BIT(1),	/* initcall returned an error */
+};
+
+/**
+ * struct initcall_stat - Time taken by an initcall
+ *
+ * @addr: Address of the function, before relocation (so that it can be found
+ *	in u-boot.map), or the event type if INITCALL_STATF_EVENT is set
+ * @time_us: Time taken in microseconds
+ * @phase: Phase in which the initcall ran (enum xpl_phase_t)
+ * @flags: Flags (INITCALL_STATF_...)
+ */
+struct initcall_stat {
+	ulong addr;
+	u32 time_us;
+	u8 phase;
+	u8 flags;
+};
+
+/**
+ * struct initcall_stats - Table of initcall timings
+ *
+ * This is held in global_data so that it is available from the first
+ * initcall and survives relocation
+ *
+ * @count: Number of initcalls run, which may be more than the number of
+ *	entries in @stat
+ * @stat: Time taken by each initcall, in the order they were run
+ */
+struct initcall_stats {
+	uint count;
+#ifdef CONFIG_INITCALL_STATS_COUNT
+	struct initcall_stat stat[CONFIG_INITCALL_STATS_COUNT];
+#endif
+};
+
 /**
  * initcall_run_list() - Run through a list of function calls
  *
@@ -35,4 +75,24 @@ typedef int (*init_fnc_t)(void);
  */
 int initcall_run_list(const init_fnc_t init_sequence[]);
 
+/**
+ * initcall_stat_name() - Get a printable name for an initcall
+ *
+ * @stat: Initcall to check
+ * @buf: Buffer to hold the name
+ * @size: Size of @buf
+ * Return: @buf
+ */
+const char *initcall_stat_name(const struct initcall_stat *stat, char *buf,
+			       int size);
+
+/**
+ * initcall_show_stats() - Show the time taken by each initcall
+ *
+ * @sort: true to show the slowest initcalls first, false to show them in the
+ *	order they were run
+ * Return: 0 if OK, -ENOMEM if out of memory
+ */
+int initcall_show_stats(bool sort);
+
 #endif
@@ -75,6 +75,7 @@ struct bd_info;
 #define MMC_MODE_SPI		BIT(27)
 
 #define SD_DATA_4BIT	0x00040000
+#define SD_DATA_STAT_AFTER_ERASE	0x00800000
 
 #define IS_SD(x)	((x)->version & SD_VERSION_SD)
 #define IS_MMC(x)	((x)->version & MMC_VERSION_MMC)
@@ -223,6 +224,7 @@ static inline bool mmc_is_tuning_cmd(uint cmdidx)
 #define EXT_CSD_ERASE_GROUP_DEF		175	/* R/W */
 #define EXT_CSD_BOOT_BUS_WIDTH		177
 #define EXT_CSD_PART_CONF		179	/* R/W */
+#define EXT_CSD_ERASED_MEM_CONT		181	/* RO */
 #define EXT_CSD_BUS_WIDTH		183	/* R/W */
 #define EXT_CSD_STROBE_SUPPORT		184	/* R/W */
 #define EXT_CSD_HS_TIMING		185	/* R/W */
@@ -512,6 +514,27 @@ struct dm_mmc_ops {
 	 * @return 0 if OK, -ve on error
 	 */
 	int (*execute_tuning)(struct udevice *dev, uint opcode);
+
+	/**
+	 * get_tuning() - Read back the result of the last tuning
+	 *
+	 * This is used to record the tuning result so that a later boot phase
+	 * can restore it with set_tuning() instead of tuning again.
+	 *
+	 * @dev:	Device to check
+	 * @tap:	Returns the controller-specific tuning value
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*get_tuning)(struct udevice *dev, u32 *tap);
+
+	/**
+	 * set_tuning() - Apply a tuning result obtained by get_tuning()
+	 *
+	 * @dev:	Device to update
+	 * @tap:	Controller-specific tuning value
+	 * @return 0 if OK, -ve on error
+	 */
+	int (*set_tuning)(struct udevice *dev, u32 tap);
 #endif
 
 	/**
@@ -569,6 +592,8 @@ int mmc_set_ios(struct mmc *mmc);
 int mmc_getcd(struct mmc *mmc);
 int mmc_getwp(struct mmc *mmc);
 int mmc_execute_tuning(struct mmc *mmc, uint opcode);
+int mmc_get_tuning(struct mmc *mmc, u32 *tap);
+int mmc_set_tuning(struct mmc *mmc, u32 tap);
 int mmc_wait_dat0(struct mmc *mmc, int state, int timeout_us);
 int mmc_set_enhanced_strobe(struct mmc *mmc);
 int mmc_host_power_cycle(struct mmc *mmc);
@@ -711,6 +736,7 @@ struct mmc {
 	uint legacy_speed; /* speed for the legacy mode provided by the card */
 	uint read_bl_len;
 	bool can_trim;
+	bool erased_zero;	/* erased blocks read back as zero */
 #if CONFIG_IS_ENABLED(MMC_WRITE)
 	uint write_bl_len;
 	uint erase_grp_size;	/* in 512-byte sectors */
@@ -736,6 +762,9 @@ struct mmc {
 	char op_cond_pending;	/* 1 if we are waiting on an op_cond command */
 	char init_in_progress;	/* 1 if we have done mmc_start_init() */
 	char preinit;		/* start init as early as possible */
+	char async_init;	/* 1 if the op_cond wait is polled in the background */
+	char sd_op_cond_pending; /* 1 if we are waiting for an SD card to power up */
+	ulong op_cond_start;	/* time when the background op_cond wait started */
 	int ddr_mode;
 #if CONFIG_IS_ENABLED(DM_MMC)
 	struct udevice *dev;	/* Device for this MMC controller */
@@ -760,6 +789,9 @@ struct mmc {
 	enum bus_mode user_speed_mode; /* input speed mode from user */
 
 	CONFIG_IS_ENABLED(CYCLIC, (struct cyclic_info cyclic));
+#if CONFIG_IS_ENABLED(MMC_INIT_ASYNC)
+	struct cyclic_info init_cyclic;	/* polls the card while it powers up */
+#endif
 };
 
 #if CONFIG_IS_ENABLED(DM_MMC)
@@ -768,6 +800,55 @@ struct mmc {
 #define mmc_to_dev(_mmc)	NULL
 #endif
 
+/* Maximum number of cards recorded in the BLOBLISTT_U_BOOT_MMC blob */
+#define MMC_HANDOFF_MAX_CARDS	2
+
+/**
+ * struct mmc_handoff_card - bus setup negotiated with an eMMC card
+ *
+ * This records the outcome of mmc_select_mode_and_width() so that a later boot
+ * phase (or a later 'mmc rescan') can go straight to the same mode and restore
+ * the tuning result, rather than trying each mode in turn and tuning again.
+ *
+ * @cid:	Card identification register, used to check that the same card
+ *		is present
+ * @mode:	Selected bus mode (enum bus_mode)
+ * @bus_width:	Bus width in bits (1, 4 or 8)
+ * @has_tuning:	1 if @tuning holds a valid tuning result
+ * @has_ext_csd: 1 if @ext_csd holds a valid snapshot of the EXT_CSD register
+ * @spare:	Spare space (for future use)
+ * @tuning:	Controller-specific tuning value, see get_tuning() in
+ *		struct dm_mmc_ops
+ * @ext_csd:	Snapshot of the card's EXT_CSD register, kept up to date with
+ *		changes made by mmc_switch()
+ */
+struct mmc_handoff_card {
+	u32 cid[4];
+	u8 mode;
+	u8 bus_width;
+	u8 has_tuning;
+	u8 has_ext_csd;
+	u32 spare;
+	u32 tuning;
+	u8 ext_csd[MMC_MAX_BLOCK_LEN];
+};
+
+/**
+ * struct mmc_handoff - eMMC bus setup passed between boot phases
+ *
+ * This is stored in the bloblist with tag BLOBLISTT_U_BOOT_MMC
+ *
+ * @count:	Number of valid entries in @card
+ * @spare:	Spare space (for future use)
+ * @card:	Information about each card, indexed in the order the cards
+ *		were first set up
+ */
+struct mmc_handoff {
+	u32 count;
+	u32 spare;
+	struct mmc_handoff_card card[MMC_HANDOFF_MAX_CARDS];
+};
+
 struct mmc_hwpart_conf {
 	struct {
 		uint enh_start;	/* in 512-byte sectors */
@@ -953,6 +1034,44 @@ int mmc_get_op_cond(struct mmc *mmc, bool quiet);
  */
 int mmc_start_init(struct mmc *mmc);
 
+/**
+ * mmc_start_init_async() - Start device initialization in the background
+ *
+ * This is like mmc_start_init() but it does not wait for the card to power up,
+ * which can take hundreds of milliseconds. Instead, a cyclic function polls the
+ * card until it is ready, so that several cards can power up at once. A later
+ * mmc_init() waits for anything that is still outstanding and completes the
+ * initialization.
+ *
+ * @mmc:	MMC device
+ * Return: 0 if OK (or already done), -ve on error
+ */
+int mmc_start_init_async(struct mmc *mmc);
+
+/**
+ * mmc_poll_op_cond() - Check whether a card has finished powering up
+ *
+ * This sends a single op_cond command to a card set up by
+ * mmc_start_init_async() and does not wait. If an SD card fails to power up,
+ * this does not try the full power-up sequence, since it may be called from
+ * a cyclic function. That is left to mmc_init().
+ *
+ * @mmc:	MMC device
+ * Return: 0 if the card is ready, -EAGAIN if it is still busy, other -ve on
+ *	error
+ */
+int mmc_poll_op_cond(struct mmc *mmc);
+
+/**
+ * mmc_start_init_all() - Start initialization of all MMC devices
+ *
+ * This probes each MMC controller and calls mmc_start_init_async() for it,
+ * so that the cards power up concurrently
+ *
+ * Return: 0 if OK, -ve on error
+ */
+int mmc_start_init_all(void);
+
 /**
  * Set preinit flag of mmc device.
  *
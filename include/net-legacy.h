@@ -73,6 +73,22 @@ struct udevice *eth_get_dev_by_name(const char *devname);
 int eth_init_state_only(void); /* Set active state */
 void eth_halt_state_only(void); /* Set passive state */
 
+/**
+ * net_hold_link() - Keep the network device running between transfers
+ *
+ * Normally net_loop() starts the network device before each transfer and
+ * stops it afterwards, which can mean waiting for the PHY to negotiate the
+ * link every time. While the link is held, a transfer which succeeds, or which
+ * fails once net_start_again() runs out of retries, leaves the device running
+ * for the next one. TFTP also keeps the server's MAC address, so that a series
+ * of files can be fetched without this overhead. A retry still restarts the
+ * device, since it may move to another one. Releasing the hold stops the
+ * device.
+ *
+ * @hold: true to hold the link, false to release it
+ */
+void net_hold_link(bool hold);
+
 /**
  * eth_env_set_enetaddr_by_index() - set the MAC address environment variable
  *
@@ -301,6 +317,7 @@ extern ushort		net_our_vlan;		/* Our VLAN */
 extern ushort		net_native_vlan;	/* Our Native VLAN */
 
 extern int		net_restart_wrap;	/* Tried all network devices */
+extern bool		net_link_held;		/* See net_hold_link() */
 
 enum proto_t {
 	BOOTP, RARP, ARP, TFTPGET, DHCP, DHCP6, PING, PING6, DNS, NFS, CDP,
@@ -38,4 +38,8 @@ int do_dns(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[]);
 int do_ping(struct cmd_tbl *cmdtp, int flag, int argc, char *const argv[]);
 int do_wget(struct cmd_tbl *cmdtp, int flag, int argc, char * const argv[]);
 
+static inline void net_hold_link(bool hold)
+{
+}
+
 #endif /* __NET_LWIP_H__ */
@@ -9,9 +9,26 @@
 #ifndef _OF_LIVE_H
 #define _OF_LIVE_H
 
+#include <linux/types.h>
+
 struct abuf;
 struct device_node;
 
+/**
+ * struct of_live_stats - Information about the live tree
+ *
+ * @tree_size: Bytes allocated by of_live_build() for the tree structure
+ * @lazy: true if properties are loaded on demand (CONFIG_OF_LIVE_LAZY)
+ * @nodes_loaded: Number of nodes whose properties have been loaded on demand
+ * @props_size: Bytes allocated for properties loaded on demand
+ */
+struct of_live_stats {
+	ulong tree_size;
+	bool lazy;
+	uint nodes_loaded;
+	ulong props_size;
+};
+
 /**
  * of_live_build() - build a live (hierarchical) tree from a flat DT
  *
@@ -37,6 +54,38 @@ int of_live_build(const void *fdt_blob, struct device_node **rootp);
  */
 int unflatten_device_tree(const void *blob, struct device_node **mynodes);
 
+/**
+ * unflatten_device_tree_lazy() - create a tree of nodes without properties
+ *
+ * This is like unflatten_device_tree() but the properties of each node are
+ * left in @blob, to be loaded by of_live_load_props() on first access.
+ * Properties loaded this way are not freed by of_live_free().
+ *
+ * @blob: The blob to expand. This must remain valid, and must not be changed,
+ *	while the tree is in use
+ * @mynodes: The device_node tree created by the call
+ * Return: 0 if OK, -ve on error
+ */
+int unflatten_device_tree_lazy(const void *blob, struct device_node **mynodes);
+
+/**
+ * of_live_load_props() - Load the properties of a node from the flat tree
+ *
+ * This does nothing if the properties are already present. It is normally
+ * called by of_node_props()
+ *
+ * @np: Node to update
+ * Return: 0 if OK, -ENOMEM if out of memory
+ */
+int of_live_load_props(struct device_node *np);
+
+/**
+ * of_live_get_stats() - Get information about the live tree
+ *
+ * @stats: Returns the information
+ */
+void of_live_get_stats(struct of_live_stats *stats);
+
 /**
  * of_live_free() - Dispose of a livetree
  *
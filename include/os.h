@@ -152,6 +152,27 @@ void os_set_alarm_handler(void (*handler)(int));
  */
 void os_raise_sigalrm(void);
 
+/**
+ * os_profile_start() - start a timer for the sampling profiler
+ *
+ * This uses SIGPROF, which is raised each time U-Boot has used @period_us of
+ * CPU time. The SA_RESTART flag is used so that system calls are not
+ * interrupted.
+ *
+ * @period_us:	sampling period in microseconds
+ * @handler:	function to call from the signal handler, with the interrupted
+ *		program counter and the return address of the interrupted
+ *		function (0 if not known)
+ * Return:	0 if OK, -ve on error
+ */
+int os_profile_start(unsigned long period_us,
+		     void (*handler)(unsigned long pc, unsigned long caller));
+
+/**
+ * os_profile_stop() - stop the timer for the sampling profiler
+ */
+void os_profile_stop(void);
+
 /**
  * os_tty_raw() - put tty into raw mode to mimic serial console better
  *
@@ -314,6 +314,19 @@ int blk_get_device_part_str(const char *ifname, const char *dev_part_str,
 int part_get_info_by_name(struct blk_desc *desc, const char *name,
 			  struct disk_partition *info);
 
+/**
+ * part_get_info_by_uuid() - Search for a partition by its UUID
+ *
+ * @desc:	block device descriptor
+ * @uuid:	UUID string of the partition (not case-sensitive)
+ * @info:	returns the disk partition info
+ *
+ * Return: the partition number on match (starting on 1), -ENOENT on no match,
+ * -ENOSYS if partition UUIDs are not supported, otherwise error
+ */
+int part_get_info_by_uuid(struct blk_desc *desc, const char *uuid,
+			  struct disk_partition *info);
+
 /**
  * part_get_info_by_dev_and_name_or_num() - Get partition info from dev number
  *					    and part name, or dev number and
@@ -385,6 +398,13 @@ static inline int part_get_info_by_name(struct blk_desc *desc, const char *name,
 	return -ENOENT;
 }
 
+static inline int part_get_info_by_uuid(struct blk_desc *desc,
+					const char *uuid,
+					struct disk_partition *info)
+{
+	return -ENOENT;
+}
+
 static inline int
 part_get_info_by_dev_and_name_or_num(const char *dev_iface,
 				     const char *dev_part_str,
@@ -435,6 +455,17 @@ ulong disk_blk_write(struct udevice *dev, lbaint_t start, lbaint_t blkcnt,
  */
 ulong disk_blk_erase(struct udevice *dev, lbaint_t start, lbaint_t blkcnt);
 
+/**
+ * disk_blk_zero() - set a section of a disk partition to zero
+ *
+ * @dev:	Device to update (UCLASS_PARTITION)
+ * @start:	Start block number to zero in the partition (0=first)
+ * @blkcnt:	Number of blocks to zero
+ * Return:	number of blocks zeroed, or -ve error number (see the
+ * IS_ERR_VALUE() macro
+ */
+ulong disk_blk_zero(struct udevice *dev, lbaint_t start, lbaint_t blkcnt);
+
 /*
  * We don't support printing partition information in SPL and only support
  * getting partition information in a few cases.
@@ -488,6 +519,32 @@ struct part_driver {
 	 * -ve if not
 	 */
 	int (*test)(struct blk_desc *desc);
+
+	/**
+	 * @find_by_name:	Find a partition by name (optional)
+	 *
+	 * If this is not provided, get_info() is called for each partition
+	 *
+	 * @find_by_name.desc:	Block device descriptor
+	 * @find_by_name.name:	Partition name to look for
+	 * @find_by_name.Return:
+	 * partition number (1 = first) if found, -ENOENT if not, other -ve on
+	 * error
+	 */
+	int (*find_by_name)(struct blk_desc *desc, const char *name);
+
+	/**
+	 * @find_by_uuid:	Find a partition by UUID (optional)
+	 *
+	 * If this is not provided, get_info() is called for each partition
+	 *
+	 * @find_by_uuid.desc:	Block device descriptor
+	 * @find_by_uuid.uuid:	Partition UUID string to look for
+	 * @find_by_uuid.Return:
+	 * partition number (1 = first) if found, -ENOENT if not, other -ve on
+	 * error
+	 */
+	int (*find_by_uuid)(struct blk_desc *desc, const char *uuid);
 };
 
 /* Declare a new U-Boot partition 'driver' */
@@ -496,6 +553,19 @@ struct part_driver {
 
 #include <part_efi.h>
 
+#if CONFIG_IS_ENABLED(PARTITION_GPT_CACHE)
+/**
+ * gpt_cache_invalidate() - Discard the cached GPT of a block device
+ *
+ * This must be called when the contents of the device may have changed
+ *
+ * @desc:	block device descriptor, or NULL for all devices
+ */
+void gpt_cache_invalidate(struct blk_desc *desc);
+#else
+static inline void gpt_cache_invalidate(struct blk_desc *desc) {}
+#endif
+
 #if CONFIG_IS_ENABLED(EFI_PARTITION)
 /* disk/part_efi.c */
 /**
@@ -0,0 +1,81 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * Sampling profiler
+ *
+ * Unlike function tracing (see trace.h), this does not need U-Boot to be built
+ * with instrumentation. A periodic interrupt records the program counter and
+ * caller, so that the time spent in each function can be estimated with very
+ * little effect on how fast U-Boot runs.
+ */
+
+#ifndef __PROFILE_H
+#define __PROFILE_H
+
+#include <linux/types.h>
+
+/**
+ * profile_start() - Start collecting samples
+ *
+ * Any samples from a previous run are discarded
+ *
+ * @period_us: Sampling period in microseconds
+ * Return: 0 if OK, -EALREADY if already running, -EINVAL if @period_us is
+ *	zero, -ENOMEM if there is no memory for the samples, -ENOSYS if the
+ *	architecture has no support, other -ve value on other error
+ */
+int profile_start(ulong period_us);
+
+/**
+ * profile_stop() - Stop collecting samples
+ *
+ * The samples remain available to profile_list_samples()
+ *
+ * Return: 0 if OK, -EALREADY if not running
+ */
+int profile_stop(void);
+
+/**
+ * profile_sample() - Record a sample
+ *
+ * This is called by the architecture on each timer interrupt, so must not
+ * call any functions which may not be used from an interrupt handler
+ *
+ * @pc: Program counter which was interrupted
+ * @caller: Return address of the interrupted function, or 0 if not known
+ */
+void profile_sample(ulong pc, ulong caller);
+
+/**
+ * profile_list_samples() - Write the samples into a buffer
+ *
+ * This writes a struct trace_output_hdr followed by a struct trace_sample for
+ * each sample, oldest first, in a form which can be read by proftool
+ *
+ * @buff: Buffer to write into
+ * @buff_size: Size of buffer
+ * @needed: Returns the number of bytes used / needed
+ * Return: 0 if OK, -ENOSPC if the buffer is too small
+ */
+int profile_list_samples(void *buff, size_t buff_size, size_t *needed);
+
+/**
+ * profile_print_stats() - Print information about the samples collected
+ */
+void profile_print_stats(void);
+
+/**
+ * arch_profile_start() - Start the periodic sampling interrupt
+ *
+ * The architecture should call profile_sample() on each interrupt
+ *
+ * @period_us: Sampling period in microseconds
+ * Return: 0 if OK, -ENOSYS if not supported, other -ve value on error
+ */
+int arch_profile_start(ulong period_us);
+
+/**
+ * arch_profile_stop() - Stop the periodic sampling interrupt
+ */
+void arch_profile_stop(void);
+
+#endif
@@ -98,6 +98,7 @@ typedef int (*pxe_getfile_func)(struct pxe_context *ctx, const char *file_path,
  * @use_ipv6: TRUE : use IPv6 addressing, FALSE : use IPv4 addressing
  * @use_fallback: TRUE : use "fallback" option as default, FALSE : use
  *	"default" option as default
+ * @fetching: true if fetch_batch() has been called to start a batch of reads
  */
 struct pxe_context {
 	struct cmd_tbl *cmdtp;
@@ -113,12 +114,26 @@ struct pxe_context {
 	 */
 	pxe_getfile_func getfile;
 
+	/**
+	 * fetch_batch() - start or end a batch of reads (optional)
+	 *
+	 * This is called before the files for a label (kernel, initrd, FDT
+	 * and overlays) are read and again once they have all been read. It
+	 * allows the transport to stay ready between the files, e.g. by
+	 * keeping the network link up, instead of setting up for each one.
+	 *
+	 * @ctx: PXE context
+	 * @start: true to start a batch, false to end it
+	 */
+	void (*fetch_batch)(struct pxe_context *ctx, bool start);
+
 	void *userdata;
 	bool allow_abs_path;
 	char *bootdir;
 	ulong pxe_file_size;
 	bool use_ipv6;
 	bool use_fallback;
+	bool fetching;
 };
 
 /**
@@ -47,6 +47,10 @@ struct hsearch_data {
 	struct env_entry_node *table;
 	unsigned int size;
 	unsigned int filled;
+	/* Number of deleted entries, which still lengthen probe chains */
+	unsigned int deleted;
+	/* Non-zero while a callback runs, when the table must not move */
+	unsigned int busy;
 /*
  * Callback function which will check whether the given change for variable
  * "item" to "newval" may be applied or not, and possibly apply such change.
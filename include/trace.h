@@ -34,6 +34,7 @@ enum {
 enum trace_chunk_type {
 	TRACE_CHUNK_FUNCS,
 	TRACE_CHUNK_CALLS,
+	TRACE_CHUNK_SAMPLES,
 };
 
 /* A trace record for a function, as written to the profile output file */
@@ -89,6 +90,15 @@ struct trace_call {
 
 int trace_list_calls(void *buff, size_t buff_size, size_t *needed);
 
+/* Value of trace_sample.caller when the caller is not known */
+#define TRACE_SAMPLE_NO_CALLER	0xffffffff
+
+/* A sample from the profiler, see profile.h */
+struct trace_sample {
+	uint32_t pc;		/* Offset of the interrupted instruction */
+	uint32_t caller;	/* Offset of the return address, if known */
+};
+
 /**
  * Turn function tracing on and off
  *
@@ -0,0 +1,48 @@
+/* SPDX-License-Identifier: GPL-2.0+ */
+/*
+ * FNV-1a hash, used for the small hash tables in U-Boot
+ *
+ * This is shared with host tools, so must not use U-Boot types.
+ */
+
+#ifndef _UBOOT_FNV_H
+#define _UBOOT_FNV_H
+
+/* Starting value for fnv1a_update() */
+#define FNV1A_INIT	2166136261U
+
+/**
+ * fnv1a_update() - Add some bytes to an FNV-1a hash
+ *
+ * FNV-1a is not a cryptographic hash, but it is quick and spreads short
+ * strings well, so suits hash tables indexed by a name
+ *
+ * @hash: Hash so far, FNV1A_INIT to start a new one
+ * @buf: Bytes to add, which need not be nul-terminated
+ * @len: Number of bytes in @buf
+ * Return: updated hash value
+ */
+static inline unsigned int fnv1a_update(unsigned int hash, const void *buf,
+					unsigned int len)
+{
+	const unsigned char *p = buf;
+
+	while (len--)
+		hash = (hash ^ *p++) * 16777619U;
+
+	return hash;
+}
+
+/**
+ * fnv1a() - Calculate the FNV-1a hash of some bytes
+ *
+ * @buf: Bytes to hash, which need not be nul-terminated
+ * @len: Number of bytes in @buf
+ * Return: hash value
+ */
+static inline unsigned int fnv1a(const void *buf, unsigned int len)
+{
+	return fnv1a_update(FNV1A_INIT, buf, len);
+}
+
+#endif
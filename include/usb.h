@@ -263,6 +263,33 @@ int usb_host_eth_scan(int mode);
  */
 int usb_init(void);
 
+/**
+ * usb_init_start() - Start bringing up USB in the background
+ *
+ * This probes the controllers and powers up the ports of their root hubs, but
+ * does not wait for devices to appear. A later call to usb_init() scans the
+ * ports, by which time their power-good and debounce delays have often
+ * expired. USB is not usable (usb_started is false) until then.
+ *
+ * Returns: 0 if OK or already started, -ENOENT if there are no USB
+ *	controllers, -ENOSYS if not supported (needs CONFIG_USB_SCAN_PARALLEL)
+ */
+int usb_init_start(void);
+
+/**
+ * usb_init_abort() - Drop a scan started by usb_init_start()
+ *
+ * This does nothing if usb_init_start() has not been called, or usb_init() has
+ * already finished its scan. It is used by usb_stop() and by the test
+ * framework, since the queued ports refer to devices which are about to go
+ * away.
+ */
+#if IS_ENABLED(CONFIG_USB_SCAN_PARALLEL)
+void usb_init_abort(void);
+#else
+static inline void usb_init_abort(void) {}
+#endif
+
 int usb_stop(void); /* stop the USB Controller */
 int usb_detect_change(void); /* detect if a USB device has been (un)plugged */
 
@@ -843,6 +870,35 @@ bool usb_hub_is_root_hub(struct udevice *hub);
  */
 int usb_hub_scan(struct udevice *hub);
 
+/**
+ * usb_hub_scan_begin() - Start queueing hub ports for a combined scan
+ *
+ * After this call, hubs which are configured (including root hubs) power up
+ * their ports and add them to the scan list, but the ports are not scanned.
+ * This allows the power-good and debounce delays of all hubs on all
+ * controllers to run at the same time. Call usb_hub_scan_complete() to scan
+ * the queued ports.
+ */
+void usb_hub_scan_begin(void);
+
+/**
+ * usb_hub_scan_complete() - Scan all ports queued since usb_hub_scan_begin()
+ *
+ * Ports are polled in turn as their delays expire, so a device found on one
+ * hub is enumerated while other hubs are still waiting. Hubs found during
+ * the scan have their ports added to the same list.
+ *
+ * Return: 0 if OK, -ve on error
+ */
+int usb_hub_scan_complete(void);
+
+/**
+ * usb_hub_scan_abort() - Drop all ports queued since usb_hub_scan_begin()
+ *
+ * This is used when USB is stopped before the queued ports are scanned
+ */
+void usb_hub_scan_abort(void);
+
 /**
  * usb_scan_device() - Scan a device on a bus
  *
@@ -34,6 +34,9 @@ struct file_handle {
 	int isdir;
 	u64 open_mode;
 
+	/* for reading a file: */
+	struct fs_file *file;
+
 	/* for reading a directory: */
 	struct fs_dir_stream *dirs;
 	struct fs_dirent *dent;
@@ -365,6 +368,7 @@ out:
 
 static efi_status_t file_close(struct file_handle *fh)
 {
+	fs_closefile(fh->file);
 	fs_closedir(fh->dirs);
 	free(fh);
 	return EFI_SUCCESS;
@@ -460,25 +464,26 @@ static efi_status_t file_read(struct file_handle *fh, u64 *buffer_size,
 {
 	loff_t actread;
 	efi_status_t ret;
-	loff_t file_size;
 
 	if (!buffer) {
 		ret = EFI_INVALID_PARAMETER;
 		return ret;
 	}
 
-	ret = efi_get_file_size(fh, &file_size);
-	if (ret != EFI_SUCCESS)
-		return ret;
-	if (file_size < fh->offset) {
+	/*
+	 * Keep the file open, so that reading it in pieces does not need the
+	 * filesystem to be mounted and the path looked up each time
+	 */
+	if (!fh->file) {
+		if (set_blk_dev(fh) || fs_open(fh->path, &fh->file))
+			return EFI_DEVICE_ERROR;
+	}
+	if (fh->file->size < fh->offset) {
 		ret = EFI_DEVICE_ERROR;
 		return ret;
 	}
 
-	if (set_blk_dev(fh))
-		return EFI_DEVICE_ERROR;
-	if (fs_read(fh->path, map_to_sysmem(buffer), fh->offset,
-		    *buffer_size, &actread))
+	if (fs_pread(fh->file, buffer, fh->offset, *buffer_size, &actread))
 		return EFI_DEVICE_ERROR;
 
 	*buffer_size = actread;
@@ -675,6 +680,10 @@ static efi_status_t efi_file_write_int(struct efi_file_handle *this,
 	if (!*buffer_size)
 		goto out;
 
+	/* The size of the file may change, so drop it if open for reading */
+	fs_closefile(fh->file);
+	fh->file = NULL;
+
 	if (set_blk_dev(fh)) {
 		ret = EFI_DEVICE_ERROR;
 		goto out;
@@ -66,6 +66,9 @@ unsigned long bootelf(unsigned long addr, Bootelf_flags flags,
 		argv = args;
 	}
 
+	/* Don't leave any output in the console buffers */
+	flush();
+
 	return bootelf_exec((void *)entry_addr, argc, argv);
 }
 
@@ -113,6 +113,7 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 
 	htab->size = nel;
 	htab->filled = 0;
+	htab->deleted = 0;
 
 	/* allocate memory and zero out */
 	htab->table = (struct env_entry_node *)calloc(htab->size + 1,
@@ -126,6 +127,99 @@ int hcreate_r(size_t nel, struct hsearch_data *htab)
 	return 1;
 }
 
+/*
+ * Compute the first hash value for a key: simply take the modulus but
+ * prevent zero.
+ */
+static unsigned int hhash(const char *key, unsigned int size)
+{
+	unsigned int len = strlen(key);
+	unsigned int hval;
+	unsigned int count;
+
+	/* Compute an value for the given string. Perhaps use a better method. */
+	hval = len;
+	count = len;
+	while (count-- > 0) {
+		hval <<= 4;
+		hval += key[count];
+	}
+
+	hval %= size;
+	if (hval == 0)
+		++hval;
+
+	return hval;
+}
+
+/*
+ * hresize()
+ */
+
+/*
+ * Move all entries into a new table with room for at least nel elements.
+ * The first hash value stored in each slot depends on the table size, so
+ * every key is hashed again. Deleted slots are dropped on the way, which
+ * also shortens the probe chains of a table which has seen many deletions.
+ * The keys and data are moved rather than copied, so pointers to them
+ * remain valid, but pointers to the entries themselves do not.
+ */
+static int hresize_r(struct hsearch_data *htab, size_t nel)
+{
+	struct hsearch_data new = { .table = NULL };
+	unsigned int i;
+
+	if (!hcreate_r(nel, &new))
+		return -ENOMEM;
+
+	for (i = 1; i <= htab->size; ++i) {
+		struct env_entry_node *node = &htab->table[i];
+		unsigned int hval, hval2, idx;
+
+		if (node->used <= 0)
+			continue;
+
+		hval = hhash(node->entry.key, new.size);
+		hval2 = 1 + hval % (new.size - 2);
+		for (idx = hval; new.table[idx].used;) {
+			if (idx <= hval2)
+				idx = new.size + idx - hval2;
+			else
+				idx -= hval2;
+		}
+		new.table[idx].used = hval;
+		new.table[idx].entry = node->entry;
+		++new.filled;
+	}
+	debug("hresize: %d entries, size %d -> %d\n", new.filled, htab->size,
+	      new.size);
+
+	free(htab->table);
+	htab->table = new.table;
+	htab->size = new.size;
+	htab->deleted = 0;
+
+	return 0;
+}
+
+/*
+ * Check whether the table should be resized before adding an entry. Keep
+ * the load (including deleted slots) below 3/4, so that probe chains stay
+ * short and there is always a free slot to end a search. When the table is
+ * mostly deleted slots it is rebuilt at the same size, otherwise the
+ * size is doubled.
+ */
+static bool hneed_resize(struct hsearch_data *htab, size_t *nelp)
+{
+	if (!IS_ENABLED(CONFIG_ENV_HASH_RESIZE) || htab->busy)
+		return false;
+	if ((htab->filled + htab->deleted + 1) * 4 <= htab->size * 3)
+		return false;
+	*nelp = max((size_t)htab->size, (size_t)(htab->filled + 1) * 2);
+
+	return true;
+}
+
 /*
  * hdestroy()
  */
@@ -158,6 +252,7 @@ void hdestroy_r(struct hsearch_data *htab)
 
 	/* the sign for an existing table is an value != NULL in htable */
 	htab->table = NULL;
+	htab->deleted = 0;
 }
 
 /*
@@ -217,13 +312,24 @@ int hmatch_r(const char *match, int last_idx, struct env_entry **retval,
 	return 0;
 }
 
+/*
+ * The callback may itself change the environment, so the table must not be
+ * resized under the caller, which still refers to its slot by index
+ */
 static int
-do_callback(const struct env_entry *e, const char *name, const char *value,
-	    enum env_op op, int flags)
+do_callback(struct hsearch_data *htab, const struct env_entry *e,
+	    const char *name, const char *value, enum env_op op, int flags)
 {
 #ifndef CONFIG_XPL_BUILD
-	if (e->callback)
-		return e->callback(name, value, op, flags);
+	int ret;
+
+	if (e->callback) {
+		htab->busy++;
+		ret = e->callback(name, value, op, flags);
+		htab->busy--;
+
+		return ret;
+	}
 #endif
 	return 0;
 }
@@ -253,7 +359,7 @@ static inline int _compare_and_overwrite_entry(struct env_entry item,
 			}
 
 			/* If there is a callback, call it */
-			if (do_callback(&htab->table[idx].entry, item.key,
+			if (do_callback(htab, &htab->table[idx].entry, item.key,
 					item.data, env_op_overwrite, flag)) {
 				debug("callback() rejected setting variable "
 					"%s, skipping it!\n", item.key);
@@ -282,27 +388,13 @@ int hsearch_r(struct env_entry item, enum env_action action,
 	      struct env_entry **retval, struct hsearch_data *htab, int flag)
 {
 	unsigned int hval;
-	unsigned int count;
-	unsigned int len = strlen(item.key);
 	unsigned int idx;
 	unsigned int first_deleted = 0;
+	size_t nel;
 	int ret;
 
-	/* Compute an value for the given string. Perhaps use a better method. */
-	hval = len;
-	count = len;
-	while (count-- > 0) {
-		hval <<= 4;
-		hval += item.key[count];
-	}
-
-	/*
-	 * First hash function:
-	 * simply take the modul but prevent zero.
-	 */
-	hval %= htab->size;
-	if (hval == 0)
-		++hval;
+	/* First hash function */
+	hval = hhash(item.key, htab->size);
 
 	/* The first index tried. */
 	idx = hval;
@@ -360,6 +452,14 @@ int hsearch_r(struct env_entry item, enum env_action action,
 
 	/* An empty bucket has been found. */
 	if (action == ENV_ENTER) {
+		/*
+		 * Grow the table if it is getting full, then look for a slot
+		 * in the new one. This cannot recurse again, since the new
+		 * table is at most half full.
+		 */
+		if (hneed_resize(htab, &nel) && !hresize_r(htab, nel))
+			return hsearch_r(item, action, retval, htab, flag);
+
 		/*
 		 * If table is full and another entry should be
 		 * entered return with error.
@@ -374,8 +474,10 @@ int hsearch_r(struct env_entry item, enum env_action action,
 		 * Create new entry;
 		 * create copies of item.key and item.data
 		 */
-		if (first_deleted)
+		if (first_deleted) {
 			idx = first_deleted;
+			--htab->deleted;
+		}
 
 		htab->table[idx].used = hval;
 		htab->table[idx].entry.key = strdup(item.key);
@@ -406,8 +508,8 @@ int hsearch_r(struct env_entry item, enum env_action action,
 		}
 
 		/* If there is a callback, call it */
-		if (do_callback(&htab->table[idx].entry, item.key, item.data,
-				env_op_create, flag)) {
+		if (do_callback(htab, &htab->table[idx].entry, item.key,
+				item.data, env_op_create, flag)) {
 			debug("callback() rejected setting variable "
 				"%s, skipping it!\n", item.key);
 			_hdelete(item.key, htab, &htab->table[idx].entry, idx);
@@ -447,6 +549,7 @@ static void _hdelete(const char *key, struct hsearch_data *htab,
 	htab->table[idx].used = USED_DELETED;
 
 	--htab->filled;
+	++htab->deleted;
 }
 
 int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
@@ -474,7 +577,7 @@ int hdelete_r(const char *key, struct hsearch_data *htab, int flag)
 	}
 
 	/* If there is a callback, call it */
-	if (do_callback(&htab->table[idx].entry, key, NULL,
+	if (do_callback(htab, &htab->table[idx].entry, key, NULL,
 			env_op_delete, flag)) {
 		debug("callback() rejected deleting variable "
 			"%s, skipping it!\n", key);
@@ -600,7 +703,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		 char **resp, size_t size,
 		 int argc, char *const argv[])
 {
-	struct env_entry *list[htab->size];
+	struct env_entry **list;
 	char *res, *p;
 	size_t totlen;
 	int i, n;
@@ -613,6 +716,13 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 
 	debug("EXPORT  table = %p, htab.size = %d, htab.filled = %d, size = %lu\n",
 	      htab, htab->size, htab->filled, (ulong)size);
+
+	/* The table may be large, so keep the list off the stack */
+	list = malloc((htab->filled + 1) * sizeof(*list));
+	if (!list) {
+		__set_errno(ENOMEM);
+		return (-1);
+	}
 	/*
 	 * Pass 1:
 	 * search used entries,
@@ -668,6 +778,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		if (size < totlen + 1) {	/* provided buffer too small */
 			printf("Env export buffer too small: %lu, but need %lu\n",
 			       (ulong)size, (ulong)totlen + 1);
+			free(list);
 			__set_errno(ENOMEM);
 			return (-1);
 		}
@@ -684,6 +795,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		/* no, allocate and clear one */
 		*resp = res = calloc(1, size);
 		if (res == NULL) {
+			free(list);
 			__set_errno(ENOMEM);
 			return (-1);
 		}
@@ -710,6 +822,7 @@ ssize_t hexport_r(struct hsearch_data *htab, const char sep, int flag,
 		*p++ = sep;
 	}
 	*p = '\0';		/* terminate result */
+	free(list);
 
 	return size;
 }
@@ -106,6 +106,77 @@ write_fail:
 	return -1;
 }
 
+static lbaint_t write_sparse_chunk_fill(struct sparse_storage *info,
+					lbaint_t blk, lbaint_t blkcnt,
+					uint32_t fill_val, char *response)
+{
+	int fill_buf_num_blks;
+	uint32_t *fill_buf;
+	lbaint_t start = blk;
+	lbaint_t blks;
+	int i;
+	int j;
+
+	/* Zeroes can often be written without sending them to the device */
+	if (!fill_val && info->zero && info->zero(info, blk, blkcnt) == blkcnt)
+		return blkcnt;
+
+	fill_buf_num_blks = CONFIG_IMAGE_SPARSE_FILLBUF_SIZE / info->blksz;
+	fill_buf = (uint32_t *)
+		   memalign(ARCH_DMA_MINALIGN,
+			    ROUNDUP(info->blksz * fill_buf_num_blks,
+				    ARCH_DMA_MINALIGN));
+	if (!fill_buf) {
+		info->mssg("Malloc failed for: CHUNK_TYPE_FILL", response);
+		return -ENOMEM;
+	}
+
+	for (i = 0; i < (info->blksz * fill_buf_num_blks / sizeof(fill_val));
+	     i++)
+		fill_buf[i] = fill_val;
+
+	for (i = 0; i < blkcnt;) {
+		j = blkcnt - i;
+		if (j > fill_buf_num_blks)
+			j = fill_buf_num_blks;
+		blks = info->write(info, blk, j, fill_buf);
+		/* blks might be > j (eg. NAND bad-blocks) */
+		if (blks < j) {
+			printf("%s: %s " LBAFU " [%d]\n", __func__,
+			       "Write failed, block #", blk, j);
+			info->mssg("flash write failure", response);
+			free(fill_buf);
+			return -EIO;
+		}
+		blk += blks;
+		i += j;
+	}
+	free(fill_buf);
+
+	return blk - start;
+}
+
+/**
+ * write_sparse_chunk_dont_care() - Skip over a DONT_CARE chunk
+ *
+ * With CONFIG_IMAGE_SPARSE_ZERO_DONT_CARE the blocks are zeroed if the
+ * storage can do it cheaply, so that stale data is discarded
+ *
+ * @info: Storage to write to
+ * @blk: First block of the chunk
+ * @blkcnt: Number of blocks in the chunk
+ * Return: number of blocks to skip on the storage
+ */
+static lbaint_t write_sparse_chunk_dont_care(struct sparse_storage *info,
+					     lbaint_t blk, lbaint_t blkcnt)
+{
+	/* The contents do not matter, so a failure here is not an error */
+	if (IS_ENABLED(CONFIG_IMAGE_SPARSE_ZERO_DONT_CARE) && info->zero)
+		info->zero(info, blk, blkcnt);
+
+	return info->reserve(info, blk, blkcnt);
+}
+
 int write_sparse_image(struct sparse_storage *info,
 		       const char *part_name, void *data, char *response)
 {
@@ -116,16 +187,10 @@ int write_sparse_image(struct sparse_storage *info,
 	unsigned int chunk;
 	unsigned int offset;
 	uint64_t chunk_data_sz;
-	uint32_t *fill_buf = NULL;
 	uint32_t fill_val;
 	sparse_header_t *sparse_header;
 	chunk_header_t *chunk_header;
 	uint32_t total_blocks = 0;
-	int fill_buf_num_blks;
-	int i;
-	int j;
-
-	fill_buf_num_blks = CONFIG_IMAGE_SPARSE_FILLBUF_SIZE / info->blksz;
 
 	/* Read and skip over sparse image header */
 	sparse_header = (sparse_header_t *)data;
@@ -227,26 +292,9 @@ int write_sparse_image(struct sparse_storage *info,
 				return -1;
 			}
 
-			fill_buf = (uint32_t *)
-				   memalign(ARCH_DMA_MINALIGN,
-					    ROUNDUP(
-						info->blksz * fill_buf_num_blks,
-						ARCH_DMA_MINALIGN));
-			if (!fill_buf) {
-				info->mssg("Malloc failed for: CHUNK_TYPE_FILL",
-					   response);
-				return -1;
-			}
-
 			fill_val = *(uint32_t *)data;
 			data = (char *)data + sizeof(uint32_t);
 
-			for (i = 0;
-			     i < (info->blksz * fill_buf_num_blks /
-				  sizeof(fill_val));
-			     i++)
-				fill_buf[i] = fill_val;
-
 			if (blk + blkcnt > info->start + info->size) {
 				printf(
 				    "%s: Request would exceed partition size!\n",
@@ -256,33 +304,19 @@ int write_sparse_image(struct sparse_storage *info,
 				return -1;
 			}
 
-			for (i = 0; i < blkcnt;) {
-				j = blkcnt - i;
-				if (j > fill_buf_num_blks)
-					j = fill_buf_num_blks;
-				blks = info->write(info, blk, j, fill_buf);
-				/* blks might be > j (eg. NAND bad-blocks) */
-				if (blks < j) {
-					printf("%s: %s " LBAFU " [%d]\n",
-					       __func__,
-					       "Write failed, block #",
-					       blk, j);
-					info->mssg("flash write failure",
-						   response);
-					free(fill_buf);
-					return -1;
-				}
-				blk += blks;
-				i += j;
-			}
+			blks = write_sparse_chunk_fill(info, blk, blkcnt,
+						       fill_val, response);
+			if (IS_ERR_VALUE(blks))
+				return -1;
+
+			blk += blks;
 			bytes_written += ((u64)blkcnt) * info->blksz;
 			total_blocks += DIV_ROUND_UP_ULL(chunk_data_sz,
 							 sparse_header->blk_sz);
-			free(fill_buf);
 			break;
 
 		case CHUNK_TYPE_DONT_CARE:
-			blk += info->reserve(info, blk, blkcnt);
+			blk += write_sparse_chunk_dont_care(info, blk, blkcnt);
 			total_blocks += chunk_header->chunk_sz;
 			break;
 
@@ -316,3 +350,361 @@ int write_sparse_image(struct sparse_storage *info,
 
 	return 0;
 }
+
+static int sparse_stream_fail(struct sparse_stream *ss, const char *msg,
+			      char *response)
+{
+	printf("%s: %s\n", __func__, msg);
+	ss->info->mssg(msg, response);
+	ss->state = SPARSE_STREAM_ERROR;
+
+	return -EINVAL;
+}
+
+/* Expect a header (or fill value) of @size bytes next */
+static void sparse_stream_expect(struct sparse_stream *ss,
+				 enum sparse_stream_state state, uint size)
+{
+	ss->state = state;
+	ss->hdr_len = 0;
+	ss->hdr_size = size;
+}
+
+static void sparse_stream_chunk_done(struct sparse_stream *ss)
+{
+	if (--ss->chunks_left)
+		sparse_stream_expect(ss, SPARSE_STREAM_CHUNK_HDR,
+				     ss->sparse_hdr.chunk_hdr_sz);
+	else
+		ss->state = SPARSE_STREAM_DONE;
+}
+
+int sparse_stream_start(struct sparse_stream *ss, struct sparse_storage *info,
+			void *buf, size_t buf_size, u64 image_size)
+{
+	memset(ss, '\0', sizeof(*ss));
+	if (!info->mssg)
+		info->mssg = default_log;
+	ss->info = info;
+	ss->buf_size = rounddown(buf_size / 2, info->blksz);
+	if (!ss->buf_size)
+		return -EINVAL;
+	ss->buf[0] = buf;
+	ss->buf[1] = buf + ss->buf_size;
+	ss->image_size = image_size;
+	ss->blk = info->start;
+	ss->next_blk = info->start;
+	sparse_stream_expect(ss, SPARSE_STREAM_FILE_HDR,
+			     min_t(u64, image_size, sizeof(sparse_header_t)));
+
+	return 0;
+}
+
+int sparse_stream_flush(struct sparse_stream *ss, char *response)
+{
+	lbaint_t blks;
+
+	if (!ss->pending_blks)
+		return 0;
+
+	blks = ss->info->write(ss->info, ss->pending_start, ss->pending_blks,
+			       ss->buf[!ss->cur]);
+	if (blks != ss->pending_blks) {
+		printf("%s: Write failed, block #" LBAFU " [" LBAFU "]\n",
+		       __func__, ss->pending_start, ss->pending_blks);
+		ss->pending_blks = 0;
+		return sparse_stream_fail(ss, "flash write failure", response);
+	}
+	ss->pending_blks = 0;
+
+	return 0;
+}
+
+/*
+ * Leave the buffer being filled pending, so it is written by the next flush,
+ * and start filling the other one
+ */
+static int sparse_stream_queue(struct sparse_stream *ss, char *response)
+{
+	lbaint_t blksz = ss->info->blksz;
+	size_t partial = ss->fill % blksz;
+	int ret;
+
+	if (!ss->fill)
+		return 0;
+	ret = sparse_stream_flush(ss, response);
+	if (ret)
+		return ret;
+
+	/* Only the end of a raw image can be a partial block */
+	if (partial) {
+		memset(ss->buf[ss->cur] + ss->fill, '\0', blksz - partial);
+		ss->fill += blksz - partial;
+	}
+	ss->pending_start = ss->buf_start;
+	ss->pending_blks = ss->fill / blksz;
+	ss->next_blk = ss->buf_start + ss->pending_blks;
+	ss->cur = !ss->cur;
+	ss->fill = 0;
+
+	return 0;
+}
+
+static int sparse_stream_data(struct sparse_stream *ss, const void *data,
+			      size_t len, char *response)
+{
+	size_t n;
+	int ret;
+
+	while (len) {
+		if (!ss->fill)
+			ss->buf_start = ss->next_blk;
+		n = min(len, ss->buf_size - ss->fill);
+		memcpy(ss->buf[ss->cur] + ss->fill, data, n);
+		ss->fill += n;
+		data += n;
+		len -= n;
+		if (ss->fill == ss->buf_size) {
+			ret = sparse_stream_queue(ss, response);
+			if (ret)
+				return ret;
+		}
+	}
+
+	return 0;
+}
+
+static int sparse_stream_file_hdr(struct sparse_stream *ss, char *response)
+{
+	sparse_header_t *hdr = &ss->hdr.file;
+	struct sparse_storage *info = ss->info;
+	uint offset;
+
+	if (ss->hdr_len < sizeof(*hdr) || !is_sparse_image(hdr)) {
+		/* Not a sparse image, so write it as it is */
+		if (DIV_ROUND_UP_ULL(ss->image_size, info->blksz) > info->size)
+			return sparse_stream_fail(ss, "too large for partition",
+						  response);
+		puts("Flashing Raw Image\n");
+		ss->chunk_left = ss->image_size - ss->hdr_len;
+		ss->state = ss->chunk_left ? SPARSE_STREAM_DATA :
+			SPARSE_STREAM_DONE;
+		ss->bytes_written = ss->image_size;
+		return sparse_stream_data(ss, hdr, ss->hdr_len, response);
+	}
+
+	/* Collect the rest of a header that is longer than we expected */
+	if (hdr->file_hdr_sz > ss->hdr_size) {
+		ss->hdr_size = hdr->file_hdr_sz;
+		return 0;
+	}
+	ss->sparse_hdr = *hdr;
+
+	div_u64_rem(hdr->blk_sz, info->blksz, &offset);
+	if (offset || !hdr->blk_sz) {
+		printf("%s: Sparse image block size issue [%u]\n", __func__,
+		       hdr->blk_sz);
+		return sparse_stream_fail(ss, "sparse image block size issue",
+					  response);
+	}
+	if (hdr->file_hdr_sz < sizeof(sparse_header_t) ||
+	    hdr->chunk_hdr_sz < sizeof(chunk_header_t))
+		return sparse_stream_fail(ss, "Bogus sparse header size",
+					  response);
+
+	puts("Flashing Sparse Image\n");
+	ss->chunks_left = hdr->total_chunks;
+	if (ss->chunks_left)
+		sparse_stream_expect(ss, SPARSE_STREAM_CHUNK_HDR,
+				     hdr->chunk_hdr_sz);
+	else
+		ss->state = SPARSE_STREAM_DONE;
+
+	return 0;
+}
+
+static int sparse_stream_chunk_hdr(struct sparse_stream *ss, char *response)
+{
+	chunk_header_t *chunk = &ss->hdr.chunk;
+	struct sparse_storage *info = ss->info;
+	u32 chunk_hdr_sz = ss->sparse_hdr.chunk_hdr_sz;
+	u64 chunk_data_sz;
+	lbaint_t blkcnt;
+	int ret;
+
+	chunk_data_sz = (u64)ss->sparse_hdr.blk_sz * chunk->chunk_sz;
+	blkcnt = DIV_ROUND_UP_ULL(chunk_data_sz, info->blksz);
+	switch (chunk->chunk_type) {
+	case CHUNK_TYPE_RAW:
+		if (chunk->total_sz != chunk_hdr_sz + chunk_data_sz)
+			return sparse_stream_fail(ss,
+				"Bogus chunk size for chunk type Raw",
+				response);
+		if (ss->blk + blkcnt > info->start + info->size)
+			return sparse_stream_fail(ss,
+				"Request would exceed partition size!",
+				response);
+
+		/* Start a new buffer unless this follows on from the last */
+		if (ss->fill && ss->buf_start + ss->fill / info->blksz !=
+		    ss->blk) {
+			ret = sparse_stream_queue(ss, response);
+			if (ret)
+				return ret;
+		}
+		ss->next_blk = ss->blk;
+		ss->blk += blkcnt;
+		ss->bytes_written += (u64)blkcnt * info->blksz;
+		ss->total_blocks += chunk->chunk_sz;
+		ss->chunk_left = chunk_data_sz;
+		if (ss->chunk_left)
+			ss->state = SPARSE_STREAM_DATA;
+		else
+			sparse_stream_chunk_done(ss);
+		break;
+
+	case CHUNK_TYPE_FILL:
+		if (chunk->total_sz != chunk_hdr_sz + sizeof(uint32_t))
+			return sparse_stream_fail(ss,
+				"Bogus chunk size for chunk type FILL",
+				response);
+		if (ss->blk + blkcnt > info->start + info->size)
+			return sparse_stream_fail(ss,
+				"Request would exceed partition size!",
+				response);
+
+		/* The header is overwritten by the fill value, so keep this */
+		ss->chunk_left = chunk_data_sz;
+		sparse_stream_expect(ss, SPARSE_STREAM_FILL_VAL,
+				     sizeof(uint32_t));
+		break;
+
+	case CHUNK_TYPE_DONT_CARE:
+		ss->blk += write_sparse_chunk_dont_care(info, ss->blk, blkcnt);
+		ss->total_blocks += chunk->chunk_sz;
+		sparse_stream_chunk_done(ss);
+		break;
+
+	case CHUNK_TYPE_CRC32:
+		if (chunk->total_sz != chunk_hdr_sz + sizeof(uint32_t))
+			return sparse_stream_fail(ss,
+				"Bogus chunk size for chunk type CRC32",
+				response);
+		ss->total_blocks += chunk->chunk_sz;
+		ss->state = SPARSE_STREAM_SKIP;
+		ss->chunk_left = sizeof(uint32_t);
+		break;
+
+	default:
+		printf("%s: Unknown chunk type: %x\n", __func__,
+		       chunk->chunk_type);
+		return sparse_stream_fail(ss, "Unknown chunk type", response);
+	}
+
+	return 0;
+}
+
+static int sparse_stream_fill(struct sparse_stream *ss, char *response)
+{
+	struct sparse_storage *info = ss->info;
+	lbaint_t blkcnt, blks;
+
+	blkcnt = DIV_ROUND_UP_ULL(ss->chunk_left, info->blksz);
+	blks = write_sparse_chunk_fill(info, ss->blk, blkcnt, ss->hdr.fill_val,
+				       response);
+	if (IS_ERR_VALUE(blks)) {
+		ss->state = SPARSE_STREAM_ERROR;
+		return -EIO;
+	}
+	ss->blk += blks;
+	ss->bytes_written += (u64)blkcnt * info->blksz;
+	ss->total_blocks += DIV_ROUND_UP_ULL(ss->chunk_left,
+					     ss->sparse_hdr.blk_sz);
+	ss->chunk_left = 0;
+	sparse_stream_chunk_done(ss);
+
+	return 0;
+}
+
+int sparse_stream_write(struct sparse_stream *ss, const void *data,
+			size_t len, char *response)
+{
+	size_t n;
+	int ret = 0;
+
+	while (len && !ret) {
+		switch (ss->state) {
+		case SPARSE_STREAM_FILE_HDR:
+		case SPARSE_STREAM_CHUNK_HDR:
+		case SPARSE_STREAM_FILL_VAL:
+			/* Only keep the part of the header that we know */
+			n = min_t(size_t, len, ss->hdr_size - ss->hdr_len);
+			if (ss->hdr_len < sizeof(ss->hdr))
+				memcpy((void *)&ss->hdr + ss->hdr_len, data,
+				       min_t(size_t, n,
+					     sizeof(ss->hdr) - ss->hdr_len));
+			ss->hdr_len += n;
+			if (ss->hdr_len < ss->hdr_size)
+				break;
+			if (ss->state == SPARSE_STREAM_FILE_HDR)
+				ret = sparse_stream_file_hdr(ss, response);
+			else if (ss->state == SPARSE_STREAM_CHUNK_HDR)
+				ret = sparse_stream_chunk_hdr(ss, response);
+			else
+				ret = sparse_stream_fill(ss, response);
+			break;
+		case SPARSE_STREAM_DATA:
+		case SPARSE_STREAM_SKIP:
+			n = min_t(u64, len, ss->chunk_left);
+			if (ss->state == SPARSE_STREAM_DATA)
+				ret = sparse_stream_data(ss, data, n, response);
+			ss->chunk_left -= n;
+			if (ss->chunk_left)
+				break;
+			if (ss->sparse_hdr.magic)
+				sparse_stream_chunk_done(ss);
+			else
+				ss->state = SPARSE_STREAM_DONE;
+			break;
+		case SPARSE_STREAM_DONE:
+			/* Ignore anything after the last chunk */
+			return 0;
+		case SPARSE_STREAM_ERROR:
+		default:
+			return -EIO;
+		}
+		data += n;
+		len -= n;
+	}
+
+	return ret;
+}
+
+int sparse_stream_finish(struct sparse_stream *ss, const char *part_name,
+			 char *response)
+{
+	int ret;
+
+	if (ss->state == SPARSE_STREAM_ERROR)
+		return -EIO;
+	if (ss->state != SPARSE_STREAM_DONE)
+		return sparse_stream_fail(ss, "image is incomplete", response);
+	ret = sparse_stream_queue(ss, response);
+	if (!ret)
+		ret = sparse_stream_flush(ss, response);
+	if (ret)
+		return ret;
+
+	if (ss->sparse_hdr.magic) {
+		debug("Wrote %d blocks, expected to write %d blocks\n",
+		      ss->total_blocks, ss->sparse_hdr.total_blks);
+		if (ss->total_blocks != ss->sparse_hdr.total_blks)
+			return sparse_stream_fail(ss,
+						  "sparse image write failure",
+						  response);
+	}
+	printf("........ wrote %llu bytes to '%s'\n", ss->bytes_written,
+	       part_name);
+
+	return 0;
+}
@@ -3,10 +3,14 @@
  * Copyright (c) 2013 The Chromium OS Authors.
  */
 
+#include <bootstage.h>
 #include <efi.h>
 #include <initcall.h>
 #include <log.h>
+#include <malloc.h>
 #include <relocate.h>
+#include <sort.h>
+#include <spl.h>
 #include <asm/global_data.h>
 
 DECLARE_GLOBAL_DATA_PTR;
@@ -42,6 +46,33 @@ static int initcall_is_event(init_fnc_t func)
 	return 0;
 }
 
+/**
+ * initcall_record() - Record the time taken by an initcall
+ *
+ * @addr: Unrelocated address of the function, or event type
+ * @type: Event type, or 0 if not an event
+ * @start_us: Time when the initcall started
+ * @ret: Return value from the initcall
+ */
+static void initcall_record(ulong addr, enum event_t type, ulong start_us,
+			    int ret)
+{
+#if CONFIG_IS_ENABLED(INITCALL_STATS)
+	struct initcall_stats *stats = &gd->initcall_stats;
+	struct initcall_stat *stat;
+
+	if (stats->count < CONFIG_INITCALL_STATS_COUNT) {
+		stat = &stats->stat[stats->count];
+		stat->addr = type ? type : addr;
+		stat->time_us = timer_get_boot_us() - start_us;
+		stat->phase = xpl_phase();
+		stat->flags = (type ? INITCALL_STATF_EVENT : 0) |
+			(ret ? INITCALL_STATF_FAILED : 0);
+	}
+	stats->count++;
+#endif
+}
+
 /*
  * To enable debugging. add #define DEBUG at the top of the including file.
  *
@@ -53,6 +84,7 @@ int initcall_run_list(const init_fnc_t init_sequence[])
 	const init_fnc_t *ptr;
 	enum event_t type;
 	init_fnc_t func;
+	ulong start_us;
 	int ret = 0;
 
 	for (ptr = init_sequence; func = *ptr, func; ptr++) {
@@ -71,7 +103,12 @@ int initcall_run_list(const init_fnc_t init_sequence[])
 			debug("initcall: %p\n", (char *)func - reloc_ofs);
 		}
 
+		if (CONFIG_IS_ENABLED(INITCALL_STATS))
+			start_us = timer_get_boot_us();
 		ret = type ? event_notify_null(type) : func();
+		if (CONFIG_IS_ENABLED(INITCALL_STATS))
+			initcall_record((ulong)func - reloc_ofs, type, start_us,
+					ret);
 		if (ret)
 			break;
 	}
@@ -100,3 +137,74 @@ int initcall_run_list(const init_fnc_t init_sequence[])
 
 	return 0;
 }
+
+#if CONFIG_IS_ENABLED(INITCALL_STATS)
+const char *initcall_stat_name(const struct initcall_stat *stat, char *buf,
+			       int size)
+{
+	if (stat->flags & INITCALL_STATF_EVENT)
+		snprintf(buf, size, "event %s", event_type_name(stat->addr));
+	else
+		snprintf(buf, size, "call %lx", stat->addr);
+
+	return buf;
+}
+
+static const char *initcall_phase_name(enum xpl_phase_t phase)
+{
+	switch (phase) {
+	case PHASE_BOARD_F:
+		return "board_f";
+	case PHASE_BOARD_R:
+		return "board_r";
+	default:
+		return xpl_name(phase);
+	}
+}
+
+static int h_cmp_time(const void *v1, const void *v2)
+{
+	const struct initcall_stat *s1 = v1, *s2 = v2;
+
+	if (s1->time_us == s2->time_us)
+		return 0;
+
+	return s1->time_us < s2->time_us ? 1 : -1;
+}
+
+int initcall_show_stats(bool sort)
+{
+	const struct initcall_stats *stats = &gd->initcall_stats;
+	struct initcall_stat *list;
+	ulong total_us = 0;
+	char buf[40];
+	uint count, i;
+
+	count = min_t(uint, stats->count, CONFIG_INITCALL_STATS_COUNT);
+	list = malloc(count * sizeof(*list));
+	if (!list)
+		return -ENOMEM;
+	memcpy(list, stats->stat, count * sizeof(*list));
+	if (sort)
+		qsort(list, count, sizeof(*list), h_cmp_time);
+
+	printf("%-8s %10s  %s\n", "Phase", "Time (us)", "Initcall");
+	printf("%-8s %10s  %s\n", "--------", "----------", "--------");
+	for (i = 0; i < count; i++) {
+		const struct initcall_stat *stat = &list[i];
+
+		printf("%-8s %10u  %s%s\n", initcall_phase_name(stat->phase),
+		       stat->time_us, initcall_stat_name(stat, buf, sizeof(buf)),
+		       stat->flags & INITCALL_STATF_FAILED ? " (failed)" : "");
+		total_us += stat->time_us;
+	}
+	printf("%-8s %10s  %s\n", "--------", "----------", "--------");
+	printf("%-8s %10lu  %u initcalls\n", "Total", total_us, count);
+	if (stats->count > count)
+		printf("Table overflowed by %u entries, please increase CONFIG_INITCALL_STATS_COUNT\n",
+		       stats->count - count);
+	free(list);
+
+	return 0;
+}
+#endif
@@ -11,6 +11,7 @@
 #define LOG_CATEGORY	LOGC_DT
 
 #include <abuf.h>
+#include <bootstage.h>
 #include <log.h>
 #include <linux/libfdt.h>
 #include <of_live.h>
@@ -23,6 +24,8 @@ enum {
 	BUF_STEP	= SZ_64K,
 };
 
+static struct of_live_stats live_stats;
+
 static void *unflatten_dt_alloc(void **mem, unsigned long size,
 				unsigned long align)
 {
@@ -35,6 +38,138 @@ static void *unflatten_dt_alloc(void **mem, unsigned long size,
 	return res;
 }
 
+/**
+ * unflatten_dt_props() - Alloc and populate the properties of a device_node
+ * @blob: The parent device tree blob
+ * @mem: Memory chunk to use for allocating properties
+ * @node_offset: Offset of the node in the flat tree
+ * @np: Node to update
+ * @pathp: Unit name of the node, used to create a 'name' property if needed
+ * @has_namep: On entry, true if the node already has a name, so no 'name'
+ * property is needed. On exit, true if it has a name or a 'name' property was
+ * found in the flat tree
+ * @dryrun: If true, do not allocate properties but still calculate needed
+ * memory size
+ */
+static void *unflatten_dt_props(const void *blob, void *mem, int node_offset,
+				struct device_node *np, const char *pathp,
+				int *has_namep, bool dryrun)
+{
+	struct property *pp, **prev_pp = NULL;
+	int has_name = *has_namep;
+	const __be32 *p;
+	int offset;
+
+	if (!dryrun)
+		prev_pp = &np->properties;
+
+	/* process properties */
+	for (offset = fdt_first_property_offset(blob, node_offset);
+	     (offset >= 0);
+	     (offset = fdt_next_property_offset(blob, offset))) {
+		const char *pname;
+		int sz;
+
+		p = fdt_getprop_by_offset(blob, offset, &pname, &sz);
+		if (!p) {
+			offset = -FDT_ERR_INTERNAL;
+			break;
+		}
+
+		if (pname == NULL) {
+			debug("Can't find property name in list !\n");
+			break;
+		}
+		if (strcmp(pname, "name") == 0)
+			has_name = 1;
+		pp = unflatten_dt_alloc(&mem, sizeof(struct property),
+					__alignof__(struct property));
+		if (!dryrun) {
+			/*
+			 * We accept flattened tree phandles either in
+			 * ePAPR-style "phandle" properties, or the
+			 * legacy "linux,phandle" properties.  If both
+			 * appear and have different values, things
+			 * will get weird.  Don't do that. */
+			if ((strcmp(pname, "phandle") == 0) ||
+			    (strcmp(pname, "linux,phandle") == 0)) {
+				if (np->phandle == 0)
+					np->phandle = be32_to_cpup(p);
+			}
+			/*
+			 * And we process the "ibm,phandle" property
+			 * used in pSeries dynamic device tree
+			 * stuff */
+			if (strcmp(pname, "ibm,phandle") == 0)
+				np->phandle = be32_to_cpup(p);
+			pp->name = (char *)pname;
+			pp->length = sz;
+			pp->value = (__be32 *)p;
+			*prev_pp = pp;
+			prev_pp = &pp->next;
+		}
+	}
+	/*
+	 * with version 0x10 we may not have the name property, recreate
+	 * it here from the unit name if absent
+	 */
+	if (!has_name) {
+		const char *p1 = pathp, *ps = pathp, *pa = NULL;
+		int sz;
+
+		while (*p1) {
+			if ((*p1) == '@')
+				pa = p1;
+			if ((*p1) == '/')
+				ps = p1 + 1;
+			p1++;
+		}
+		if (pa < ps)
+			pa = p1;
+		sz = (pa - ps) + 1;
+		pp = unflatten_dt_alloc(&mem, sizeof(struct property) + sz,
+					__alignof__(struct property));
+		if (!dryrun) {
+			pp->name = "name";
+			pp->length = sz;
+			pp->value = pp + 1;
+			*prev_pp = pp;
+			prev_pp = &pp->next;
+			memcpy(pp->value, ps, sz - 1);
+			((char *)pp->value)[sz - 1] = 0;
+			debug("fixed up name for %s -> %s\n", pathp,
+			      (char *)pp->value);
+		}
+	}
+	if (!dryrun)
+		*prev_pp = NULL;
+	*has_namep = has_name;
+
+	return mem;
+}
+
+/**
+ * unflatten_dt_lazy() - Set up a node whose properties are loaded later
+ * @blob: The parent device tree blob, which must remain valid
+ * @offset: Offset of the node in the flat tree
+ * @np: Node to update
+ * @has_name: true if the node name was obtained from its unit name
+ *
+ * This reads just the properties which are held in struct device_node itself
+ */
+static void unflatten_dt_lazy(const void *blob, int offset,
+			      struct device_node *np, int has_name)
+{
+#if CONFIG_IS_ENABLED(OF_LIVE_LAZY)
+	np->lazy_blob = blob;
+	np->lazy_offset = offset;
+	np->phandle = fdt_get_phandle(blob, offset);
+	if (!has_name)
+		np->name = fdt_getprop(blob, offset, "name", NULL);
+	np->type = fdt_getprop(blob, offset, "device_type", NULL);
+#endif
+}
+
 /**
  * unflatten_dt_node() - Alloc and populate a device_node from the flat tree
  * @blob: The parent device tree blob
@@ -45,21 +180,20 @@ static void *unflatten_dt_alloc(void **mem, unsigned long size,
  * @fpsize: Size of the node path up at t05he current depth.
  * @dryrun: If true, do not allocate device nodes but still calculate needed
  * memory size
+ * @lazy: If true, leave the properties in the flat tree, to be loaded on first
+ * use
  */
 static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 			       struct device_node *dad,
 			       struct device_node **nodepp,
-			       unsigned long fpsize, bool dryrun)
+			       unsigned long fpsize, bool dryrun, bool lazy)
 {
-	const __be32 *p;
 	struct device_node *np;
-	struct property *pp, **prev_pp = NULL;
 	const char *pathp;
 	int l;
 	unsigned int allocl;
 	static int depth;
 	int old_depth;
-	int offset;
 	int has_name = 0;
 	int new_format = 0;
 
@@ -126,101 +260,30 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 		}
 		memcpy(fn, pathp, l);
 
-		prev_pp = &np->properties;
 		if (dad != NULL) {
 			np->parent = dad;
 			np->sibling = dad->child;
 			dad->child = np;
 		}
 	}
-	/* process properties */
-	for (offset = fdt_first_property_offset(blob, *poffset);
-	     (offset >= 0);
-	     (offset = fdt_next_property_offset(blob, offset))) {
-		const char *pname;
-		int sz;
-
-		p = fdt_getprop_by_offset(blob, offset, &pname, &sz);
-		if (!p) {
-			offset = -FDT_ERR_INTERNAL;
-			break;
-		}
-
-		if (pname == NULL) {
-			debug("Can't find property name in list !\n");
-			break;
-		}
-		if (strcmp(pname, "name") == 0)
-			has_name = 1;
-		pp = unflatten_dt_alloc(&mem, sizeof(struct property),
-					__alignof__(struct property));
-		if (!dryrun) {
-			/*
-			 * We accept flattened tree phandles either in
-			 * ePAPR-style "phandle" properties, or the
-			 * legacy "linux,phandle" properties.  If both
-			 * appear and have different values, things
-			 * will get weird.  Don't do that. */
-			if ((strcmp(pname, "phandle") == 0) ||
-			    (strcmp(pname, "linux,phandle") == 0)) {
-				if (np->phandle == 0)
-					np->phandle = be32_to_cpup(p);
-			}
-			/*
-			 * And we process the "ibm,phandle" property
-			 * used in pSeries dynamic device tree
-			 * stuff */
-			if (strcmp(pname, "ibm,phandle") == 0)
-				np->phandle = be32_to_cpup(p);
-			pp->name = (char *)pname;
-			pp->length = sz;
-			pp->value = (__be32 *)p;
-			*prev_pp = pp;
-			prev_pp = &pp->next;
-		}
-	}
-	/*
-	 * with version 0x10 we may not have the name property, recreate
-	 * it here from the unit name if absent
-	 */
-	if (!has_name) {
-		const char *p1 = pathp, *ps = pathp, *pa = NULL;
-		int sz;
-
-		while (*p1) {
-			if ((*p1) == '@')
-				pa = p1;
-			if ((*p1) == '/')
-				ps = p1 + 1;
-			p1++;
-		}
-		if (pa < ps)
-			pa = p1;
-		sz = (pa - ps) + 1;
-		pp = unflatten_dt_alloc(&mem, sizeof(struct property) + sz,
-					__alignof__(struct property));
+	if (lazy) {
+		if (!dryrun)
+			unflatten_dt_lazy(blob, *poffset, np, has_name);
+	} else {
+		mem = unflatten_dt_props(blob, mem, *poffset, np, pathp,
+					 &has_name, dryrun);
 		if (!dryrun) {
-			pp->name = "name";
-			pp->length = sz;
-			pp->value = pp + 1;
-			*prev_pp = pp;
-			prev_pp = &pp->next;
-			memcpy(pp->value, ps, sz - 1);
-			((char *)pp->value)[sz - 1] = 0;
-			debug("fixed up name for %s -> %s\n", pathp,
-			      (char *)pp->value);
+			if (!has_name)
+				np->name = of_get_property(np, "name", NULL);
+			np->type = of_get_property(np, "device_type", NULL);
 		}
 	}
 	if (!dryrun) {
-		*prev_pp = NULL;
-		if (!has_name)
-			np->name = of_get_property(np, "name", NULL);
-		np->type = of_get_property(np, "device_type", NULL);
-
 		if (!np->name)
 			np->name = "<NULL>";
 		if (!np->type)
-			np->type = "<NULL>";	}
+			np->type = "<NULL>";
+	}
 
 	old_depth = depth;
 	*poffset = fdt_next_node(blob, *poffset, &depth);
@@ -228,7 +291,7 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 		depth = 0;
 	while (*poffset > 0 && depth > old_depth) {
 		mem = unflatten_dt_node(blob, mem, poffset, np, NULL,
-					fpsize, dryrun);
+					fpsize, dryrun, lazy);
 		if (!mem)
 			return NULL;
 	}
@@ -260,7 +323,53 @@ static void *unflatten_dt_node(const void *blob, void *mem, int *poffset,
 	return mem;
 }
 
-int unflatten_device_tree(const void *blob, struct device_node **mynodes)
+#if CONFIG_IS_ENABLED(OF_LIVE_LAZY)
+int of_live_load_props(struct device_node *np)
+{
+	const void *blob = np->lazy_blob;
+	int has_name = 1;
+	const char *pathp;
+	ulong size;
+	void *mem;
+
+	if (!blob)
+		return 0;
+
+	bootstage_start(BOOTSTAGE_ID_ACCUM_OF_LIVE_LOAD, "of_live_load");
+	pathp = fdt_get_name(blob, np->lazy_offset, NULL);
+	size = (ulong)unflatten_dt_props(blob, NULL, np->lazy_offset, np,
+					 pathp, &has_name, true);
+	mem = NULL;
+	if (size) {
+		mem = malloc(size);
+		if (!mem) {
+			bootstage_accum(BOOTSTAGE_ID_ACCUM_OF_LIVE_LOAD);
+			log_err("Out of memory for properties of '%s'\n",
+				np->full_name);
+			return log_msg_ret("lzy", -ENOMEM);
+		}
+	}
+
+	np->lazy_blob = NULL;
+	np->lazy_props = mem;
+	if (mem)
+		unflatten_dt_props(blob, mem, np->lazy_offset, np, pathp,
+				   &has_name, false);
+	live_stats.nodes_loaded++;
+	live_stats.props_size += size;
+	bootstage_accum(BOOTSTAGE_ID_ACCUM_OF_LIVE_LOAD);
+
+	return 0;
+}
+#endif
+
+void of_live_get_stats(struct of_live_stats *stats)
+{
+	*stats = live_stats;
+}
+
+static int unflatten_tree(const void *blob, struct device_node **mynodes,
+			  bool lazy, ulong *sizep)
 {
 	unsigned long size;
 	int start;
@@ -286,7 +395,7 @@ int unflatten_device_tree(const void *blob, struct device_node **mynodes)
 	/* First pass, scan for size */
 	start = 0;
 	size = (unsigned long)unflatten_dt_node(blob, NULL, &start, NULL, NULL,
-						0, true);
+						0, true, lazy);
 	if (!size)
 		return -EFAULT;
 	size = ALIGN(size, 4);
@@ -306,28 +415,46 @@ int unflatten_device_tree(const void *blob, struct device_node **mynodes)
 
 	/* Second pass, do actual unflattening */
 	start = 0;
-	unflatten_dt_node(blob, mem, &start, NULL, mynodes, 0, false);
+	unflatten_dt_node(blob, mem, &start, NULL, mynodes, 0, false, lazy);
 	if (be32_to_cpup(mem + size) != 0xdeadbeef) {
 		debug("End of tree marker overwritten: %08x\n",
 		      be32_to_cpup(mem + size));
 		return -ENOSPC;
 	}
+	if (sizep)
+		*sizep = size;
 
 	debug(" <- unflatten_device_tree()\n");
 
 	return 0;
 }
 
+int unflatten_device_tree(const void *blob, struct device_node **mynodes)
+{
+	return unflatten_tree(blob, mynodes, false, NULL);
+}
+
+#if CONFIG_IS_ENABLED(OF_LIVE_LAZY)
+int unflatten_device_tree_lazy(const void *blob, struct device_node **mynodes)
+{
+	return unflatten_tree(blob, mynodes, true, NULL);
+}
+#endif
+
 int of_live_build(const void *fdt_blob, struct device_node **rootp)
 {
+	ulong size;
 	int ret;
 
 	debug("%s: start\n", __func__);
-	ret = unflatten_device_tree(fdt_blob, rootp);
+	ret = unflatten_tree(fdt_blob, rootp,
+			     CONFIG_IS_ENABLED(OF_LIVE_LAZY), &size);
 	if (ret) {
 		debug("Failed to create live tree: err=%d\n", ret);
 		return ret;
 	}
+	live_stats.tree_size = size;
+	live_stats.lazy = CONFIG_IS_ENABLED(OF_LIVE_LAZY);
 	ret = of_alias_scan();
 	if (ret) {
 		debug("Failed to scan live tree aliases: err=%d\n", ret);
@@ -340,6 +467,22 @@ int of_live_build(const void *fdt_blob, struct device_node **rootp)
 
 void of_live_free(struct device_node *root)
 {
+#if CONFIG_IS_ENABLED(OF_LIVE_LAZY)
+	struct device_node *np = root;
+
+	/* free the properties which were loaded later, walking depth-first */
+	while (np) {
+		free(np->lazy_props);
+		np->lazy_props = NULL;
+		if (np->child) {
+			np = np->child;
+			continue;
+		}
+		while (np != root && !np->sibling)
+			np = np->parent;
+		np = np == root ? NULL : np->sibling;
+	}
+#endif
 	/* the tree is stored as a contiguous block of memory */
 	free(root);
 }
@@ -401,7 +544,10 @@ static int flatten_node(struct abuf *buf, const struct device_node *node)
 		return log_msg_ret("beg", ret);
 
 	/* First write out the properties */
-	for (pp = node->properties; !ret && pp; pp = pp->next) {
+	pp = of_node_props(node);
+	if (IS_ERR(pp))
+		return log_msg_ret("prp", PTR_ERR(pp));
+	for (; !ret && pp; pp = pp->next) {
 		ret = fdt_property(abuf_data(buf), pp->name, pp->value,
 				   pp->length);
 		ret = check_space(ret, buf);
@@ -0,0 +1,182 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Sampling profiler
+ *
+ * Samples are held in a ring buffer, so that a long run keeps the most recent
+ * ones. They are written out in the same chunk format as function traces, so
+ * proftool can turn them into a flame graph.
+ */
+
+#include <log.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <profile.h>
+#include <trace.h>
+#include <asm/global_data.h>
+#include <asm/sections.h>
+#include <linux/errno.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/**
+ * struct profile_state - Information about the samples collected
+ *
+ * @ring: Ring buffer of samples
+ * @count: Number of samples recorded, which may be more than the size of
+ *	the ring
+ * @other: Number of samples which were outside U-Boot's code
+ * @period_us: Sampling period in microseconds
+ * @running: true if samples are being collected
+ */
+struct profile_state {
+	struct trace_sample *ring;
+	ulong count;
+	ulong other;
+	ulong period_us;
+	bool running;
+};
+
+static struct profile_state profile;
+
+__weak int arch_profile_start(ulong period_us)
+{
+	return -ENOSYS;
+}
+
+__weak void arch_profile_stop(void)
+{
+}
+
+static ulong notrace profile_text_base(void)
+{
+#ifdef CONFIG_SANDBOX
+	return (ulong)_init;
+#else
+	if (gd->flags & GD_FLG_RELOC)
+		return gd->relocaddr;
+
+	return CONFIG_TEXT_BASE;
+#endif
+}
+
+/**
+ * profile_addr_to_offset() - Convert an address to an offset in U-Boot's code
+ *
+ * @addr: Address to convert
+ * @offsetp: Returns the offset from the start of U-Boot's code
+ * Return: true if the address is within U-Boot's code, else false
+ */
+static bool notrace profile_addr_to_offset(ulong addr, u32 *offsetp)
+{
+	ulong offset = addr - profile_text_base();
+
+	if (addr < profile_text_base() || (gd->mon_len && offset >= gd->mon_len))
+		return false;
+	*offsetp = offset;
+
+	return true;
+}
+
+void notrace profile_sample(ulong pc, ulong caller)
+{
+	struct trace_sample *rec;
+
+	if (!profile.running)
+		return;
+
+	rec = &profile.ring[profile.count % CONFIG_PROFILE_SAMPLES];
+	if (!profile_addr_to_offset(pc, &rec->pc)) {
+		profile.other++;
+		return;
+	}
+	if (!caller || !profile_addr_to_offset(caller, &rec->caller))
+		rec->caller = TRACE_SAMPLE_NO_CALLER;
+	profile.count++;
+}
+
+int profile_start(ulong period_us)
+{
+	int ret;
+
+	if (profile.running)
+		return -EALREADY;
+	if (!period_us)
+		return -EINVAL;
+	if (!profile.ring) {
+		profile.ring = malloc(CONFIG_PROFILE_SAMPLES *
+				      sizeof(struct trace_sample));
+		if (!profile.ring)
+			return log_msg_ret("prf", -ENOMEM);
+	}
+	profile.count = 0;
+	profile.other = 0;
+	profile.period_us = period_us;
+	profile.running = true;
+
+	ret = arch_profile_start(period_us);
+	if (ret) {
+		profile.running = false;
+		return log_msg_ret("arc", ret);
+	}
+
+	return 0;
+}
+
+int profile_stop(void)
+{
+	if (!profile.running)
+		return -EALREADY;
+	arch_profile_stop();
+	profile.running = false;
+
+	return 0;
+}
+
+int profile_list_samples(void *buff, size_t buff_size, size_t *needed)
+{
+	struct trace_output_hdr *output_hdr;
+	struct trace_sample *out;
+	ulong count, first, i;
+	size_t size;
+
+	count = min_t(ulong, profile.count, CONFIG_PROFILE_SAMPLES);
+	size = sizeof(*output_hdr) + count * sizeof(*out);
+	*needed = size;
+	if (size > buff_size)
+		return -ENOSPC;
+
+	output_hdr = buff;
+	memset(output_hdr, '\0', sizeof(*output_hdr));
+	output_hdr->type = TRACE_CHUNK_SAMPLES;
+	output_hdr->version = TRACE_VERSION;
+	output_hdr->rec_count = count;
+	output_hdr->text_base = CONFIG_TEXT_BASE;
+
+	/* Write the oldest sample first, in case the ring has wrapped */
+	out = (struct trace_sample *)(output_hdr + 1);
+	first = profile.count - count;
+	for (i = 0; i < count; i++)
+		out[i] = profile.ring[(first + i) % CONFIG_PROFILE_SAMPLES];
+
+	return 0;
+}
+
+void profile_print_stats(void)
+{
+	if (!profile.ring) {
+		printf("Profiling has not been started\n");
+		return;
+	}
+	printf("%s, period %lu us\n", profile.running ? "Running" : "Stopped",
+	       profile.period_us);
+	print_grouped_ull(profile.count, 10);
+	puts(" samples");
+	if (profile.count > CONFIG_PROFILE_SAMPLES) {
+		printf(" (%lu oldest overwritten)",
+		       profile.count - CONFIG_PROFILE_SAMPLES);
+	}
+	puts("\n");
+	print_grouped_ull(profile.other, 10);
+	puts(" samples outside U-Boot\n");
+	printf("\nsample buffer %lx\n", (ulong)map_to_sysmem(profile.ring));
+}
@@ -170,6 +170,8 @@ int		net_restart_wrap;
 static int	net_restarted;
 /* At least one device configured */
 static int	net_dev_exists;
+/* Leave the device running after a transfer, see net_hold_link() */
+bool		net_link_held;
 
 /* XXX in both little & big endian machines 0xFFFF == ntohs(-1) */
 /* default is without VLAN */
@@ -431,6 +433,13 @@ int net_init(void)
  *	Main network processing loop.
  */
 
+void net_hold_link(bool hold)
+{
+	if (net_link_held && !hold && eth_is_active(eth_get_dev()))
+		eth_halt();
+	net_link_held = hold;
+}
+
 int net_loop(enum proto_t protocol)
 {
 	int ret = -EINVAL;
@@ -457,7 +466,9 @@ int net_loop(enum proto_t protocol)
 
 	bootstage_mark_name(BOOTSTAGE_ID_ETH_START, "eth_start");
 	net_init();
-	if (eth_is_on_demand_init()) {
+	if (net_link_held && eth_is_active(eth_get_dev())) {
+		debug_cond(DEBUG_INT_STATE, "--- net_loop link still up\n");
+	} else if (eth_is_on_demand_init()) {
 		eth_halt();
 		eth_set_current();
 		ret = eth_init();
@@ -728,10 +739,10 @@ restart:
 				env_set_hex("filesize", net_boot_file_size);
 				env_set_hex("fileaddr", image_load_addr);
 			}
-			if (protocol != NETCONS && protocol != NCSI)
-				eth_halt();
-			else
+			if (protocol == NETCONS || protocol == NCSI)
 				eth_halt_state_only();
+			else if (!net_link_held)
+				eth_halt();
 
 			eth_set_last_protocol(protocol);
 
@@ -800,7 +811,9 @@ int net_start_again(void)
 	}
 
 	if ((!retry_forever) && (net_try_count > retrycnt)) {
-		eth_halt();
+		/* a held link stays up for the next transfer */
+		if (!net_link_held)
+			eth_halt();
 		net_set_state(NETLOOP_FAIL);
 		/*
 		 * We don't provide a way for the protocol to return an error,
@@ -759,6 +759,7 @@ static void sanitize_tftp_block_size_option(enum proto_t protocol)
 void tftp_start(enum proto_t protocol)
 {
 	__maybe_unused char *ep;             /* Environment pointer */
+	struct in_addr prev_remote_ip = tftp_remote_ip;
 
 	if (saved_tftp_block_size_option) {
 		tftp_block_size_option = saved_tftp_block_size_option;
@@ -934,8 +935,13 @@ void tftp_start(enum proto_t protocol)
 	tftp_cur_block = 0;
 	tftp_windowsize = 1;
 	tftp_last_nack = 0;
-	/* zero out server ether in case the server ip has changed */
-	memset(net_server_ethaddr, 0, 6);
+	/*
+	 * zero out server ether in case the server ip has changed, but keep it
+	 * while the link is held for a series of transfers from one server
+	 */
+	if (!net_link_held || (IS_ENABLED(CONFIG_IPV6) && use_ip6) ||
+	    tftp_remote_ip.s_addr != prev_remote_ip.s_addr)
+		memset(net_server_ethaddr, 0, 6);
 	/* Revert tftp_block_size to dflt */
 	tftp_block_size = TFTP_BLOCK_SIZE;
 #ifdef CONFIG_TFTP_TSIZE
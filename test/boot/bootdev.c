@@ -482,6 +482,60 @@ static int bootdev_test_hunt_scan(struct unit_test_state *uts)
 }
 BOOTSTD_TEST(bootdev_test_hunt_scan, UTF_DM | UTF_SCAN_FDT);
 
+/* Check starting hunters in the background */
+static int bootdev_test_hunt_start(struct unit_test_state *uts)
+{
+	struct bootdev_hunter *start;
+	struct bootstd_priv *std;
+	uint mask;
+	int n_ent, i;
+
+	if (!IS_ENABLED(CONFIG_BOOTSTD_HUNT_ASYNC))
+		return -EAGAIN;
+	bootstd_reset_usb();
+	test_set_skip_delays(true);
+
+	/* get access to the used hunters */
+	ut_assertok(bootstd_get_priv(&std));
+
+	start = ll_entry_start(struct bootdev_hunter, bootdev_hunter);
+	n_ent = ll_entry_count(struct bootdev_hunter, bootdev_hunter);
+	for (mask = 0, i = 0; i < n_ent; i++) {
+		if (start[i].start)
+			mask |= BIT(i);
+	}
+
+	/* only hunters with a start() function are started, none are used */
+	ut_assertok(bootdev_hunt_start_all(false));
+	ut_asserteq(mask, std->hunters_started);
+	ut_asserteq(0, std->hunters_used);
+	ut_assert_console_end();
+	if (!(mask & BIT(MMC_HUNTER)))
+		return 0;
+
+	/* hunting completes the job */
+	ut_assertok(bootdev_hunt("mmc", false));
+	ut_asserteq(BIT(MMC_HUNTER), std->hunters_used);
+	ut_assert(!(std->hunters_started & BIT(MMC_HUNTER)));
+
+	/* a hunter which has been used is not started again */
+	ut_assertok(bootdev_hunt_start_all(false));
+	ut_assert(!(std->hunters_started & BIT(MMC_HUNTER)));
+	if (!(mask & BIT(8)))
+		return 0;
+
+	/* USB only shows its bus once the ports are scanned */
+	ut_assertok(bootdev_hunt("usb", false));
+	ut_assert_nextline(
+		"Bus usb@1: scanning bus usb@1 for devices... 5 USB Device(s) found");
+	ut_assert_console_end();
+	ut_asserteq(BIT(MMC_HUNTER) | BIT(8), std->hunters_used);
+	ut_asserteq(0, std->hunters_started);
+
+	return 0;
+}
+BOOTSTD_TEST(bootdev_test_hunt_start, UTF_DM | UTF_SCAN_FDT | UTF_CONSOLE);
+
 /* Check that only bootable partitions are processed */
 static int bootdev_test_bootable(struct unit_test_state *uts)
 {
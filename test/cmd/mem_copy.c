@@ -166,3 +166,17 @@ static int mem_test_cp_q(struct unit_test_state *uts)
 }
 MEM_TEST(mem_test_cp_q);
 #endif
+
+/* Test that -v shows the time taken */
+static int mem_test_cp_verbose(struct unit_test_state *uts)
+{
+	ut_assertok(run_command("cp.b 1000 1100 10", 0));
+	ut_assert_console_end();
+
+	ut_assertok(run_command("cp.b -v 1000 1100 10", 0));
+	ut_assert_nextlinen("Copied 16 bytes in ");
+	ut_assert_console_end();
+
+	return 0;
+}
+UNIT_TEST(mem_test_cp_verbose, UTF_CONSOLE, mem_test);
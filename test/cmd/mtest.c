@@ -0,0 +1,39 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for 'mtest' command
+ */
+
+#include <command.h>
+#include <malloc.h>
+#include <mapmem.h>
+#include <dm/test.h>
+#include <test/ut.h>
+
+/* Declare a new mem test */
+#define MEM_TEST(_name, _flags)	UNIT_TEST(_name, _flags, mem_test)
+
+/* Test the fast memory test, checking the memory it leaves behind */
+static int mem_test_mtest_fast(struct unit_test_state *uts)
+{
+	const ulong size = 0x41008;
+	ulong *buf, addr;
+	int i;
+
+	/* use a buffer of our own, since the test overwrites all of it */
+	buf = malloc(size);
+	ut_assertnonnull(buf);
+	addr = map_to_sysmem(buf);
+
+	ut_assertok(run_commandf("mtest %lx %lx 10 2", addr, addr + size));
+	ut_assert_skip_to_line("Tested 2 iteration(s) with 0 errors.");
+	ut_assert_nextlinen("Throughput: write ");
+	ut_assert_console_end();
+
+	/* The second iteration writes a complemented, decrementing pattern */
+	for (i = 0; i < size / sizeof(ulong); i++)
+		ut_asserteq(~0x10UL - i, buf[i]);
+	free(buf);
+
+	return 0;
+}
+MEM_TEST(mem_test_mtest_fast, UTF_CONSOLE);
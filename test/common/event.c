@@ -67,6 +67,31 @@ static int test_event_simple(struct unit_test_state *uts)
 }
 COMMON_TEST(test_event_simple, 0);
 
+/* Test that events are counted */
+static int test_event_stats(struct unit_test_state *uts)
+{
+	const struct event_stats *stats;
+	uint count;
+
+	if (!CONFIG_IS_ENABLED(EVENT_STATS))
+		return -EAGAIN;
+
+	stats = event_get_stats(EVT_TEST);
+	ut_assertnonnull(stats);
+	count = stats->count;
+
+	called = false;
+	ut_assertok(event_notify_null(EVT_TEST));
+	ut_assert(called);
+	ut_asserteq(count + 1, stats->count);
+	ut_assert(stats->max_us <= stats->time_us);
+
+	ut_assertnull(event_get_stats(EVT_COUNT));
+
+	return 0;
+}
+COMMON_TEST(test_event_stats, 0);
+
 static int h_probe(void *ctx, struct event *event)
 {
 	struct test_state *test_state = ctx;
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for initcall timing
+ */
+
+#include <initcall.h>
+#include <malloc.h>
+#include <spl.h>
+#include <asm/global_data.h>
+#include <test/common.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+static int h_initcall_ok(void)
+{
+	return 0;
+}
+
+static int h_initcall_fail(void)
+{
+	return -EINVAL;
+}
+
+/* Test that each initcall is recorded, including events and failures */
+static int test_initcall_stats(struct unit_test_state *uts)
+{
+	const init_fnc_t seq[] = {
+		h_initcall_ok,
+		INITCALL_EVENT(EVT_TEST),
+		h_initcall_fail,
+		NULL,
+	};
+	struct initcall_stats *stats = &gd->initcall_stats;
+	struct initcall_stats *save;
+	const struct initcall_stat *stat;
+	char buf[40];
+
+	/* Keep the records from boot, since the test overwrites them */
+	save = malloc(sizeof(*save));
+	ut_assertnonnull(save);
+	memcpy(save, stats, sizeof(*save));
+	stats->count = 0;
+
+	ut_asserteq(-EINVAL, initcall_run_list(seq));
+	ut_asserteq(3, stats->count);
+
+	stat = &stats->stat[0];
+	ut_asserteq((ulong)h_initcall_ok - gd->reloc_off, stat->addr);
+	ut_asserteq(0, stat->flags);
+	ut_asserteq(xpl_phase(), stat->phase);
+
+	stat = &stats->stat[1];
+	ut_asserteq(EVT_TEST, stat->addr);
+	ut_asserteq(INITCALL_STATF_EVENT, stat->flags);
+	ut_asserteq_str("event test",
+			initcall_stat_name(stat, buf, sizeof(buf)));
+
+	stat = &stats->stat[2];
+	ut_asserteq((ulong)h_initcall_fail - gd->reloc_off, stat->addr);
+	ut_asserteq(INITCALL_STATF_FAILED, stat->flags);
+
+	memcpy(stats, save, sizeof(*save));
+	free(save);
+
+	return 0;
+}
+COMMON_TEST(test_initcall_stats, 0);
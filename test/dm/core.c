@@ -5,11 +5,13 @@
  * Copyright (c) 2013 Google, Inc
  */
 
+#include <cyclic.h>
 #include <errno.h>
 #include <dm.h>
 #include <fdtdec.h>
 #include <log.h>
 #include <malloc.h>
+#include <time.h>
 #include <asm/global_data.h>
 #include <dm/device-internal.h>
 #include <dm/root.h>
@@ -1182,6 +1184,89 @@ static int dm_test_inactive_child(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_inactive_child, UTF_SCAN_PDATA);
 
+/* Test probing devices which complete their probe in the background */
+static int dm_test_probe_async(struct unit_test_state *uts)
+{
+	struct udevice *dev1, *dev2, *dev3;
+	struct dm_test_priv *priv;
+	ulong start;
+
+	if (!CONFIG_IS_ENABLED(DM_PROBE_ASYNC))
+		return -EAGAIN;
+	uts->skip_post_probe = 1;
+
+	ut_assertok(device_bind(dm_root(), DM_DRIVER_GET(test_async_drv),
+				"async1", NULL, ofnode_null(), &dev1));
+	ut_assertok(device_bind(dm_root(), DM_DRIVER_GET(test_async_drv),
+				"async2", NULL, ofnode_null(), &dev2));
+	ut_assertok(device_bind(dm_root(), DM_DRIVER_GET(test_async_drv),
+				"async3", NULL, ofnode_null(), &dev3));
+
+	/* The probe starts but does not wait for the device */
+	ut_assertok(device_probe_async(dev1));
+	ut_assert(!device_active(dev1));
+	ut_assert(dev_get_flags(dev1) & DM_FLAG_PROBE_PENDING);
+	priv = dev_get_priv(dev1);
+	ut_asserteq(0, priv->op_count[DM_TEST_OP_PROBE_COMPLETE]);
+
+	/* A normal probe joins the device, so it is ready afterwards */
+	ut_assertok(device_probe(dev1));
+	ut_assert(device_active(dev1));
+	ut_assert(!(dev_get_flags(dev1) & DM_FLAG_PROBE_PENDING));
+	ut_asserteq(3, priv->op_count[DM_TEST_OP_PROBE_COMPLETE]);
+
+	/* The cyclic function completes the probe in the background */
+	ut_assertok(device_probe_async(dev2));
+	start = get_timer(0);
+	while ((dev_get_flags(dev2) & DM_FLAG_PROBE_PENDING) &&
+	       get_timer(start) < 1000)
+		schedule();
+	ut_assert(!(dev_get_flags(dev2) & DM_FLAG_PROBE_PENDING));
+	priv = dev_get_priv(dev2);
+	ut_asserteq(3, priv->op_count[DM_TEST_OP_PROBE_COMPLETE]);
+
+	/* Joining everything leaves nothing pending */
+	ut_assertok(device_probe_async(dev3));
+	ut_assertok(dm_probe_join_all());
+	ut_assert(!(dev_get_flags(dev3) & DM_FLAG_PROBE_PENDING));
+
+	/* Removing a device cancels its pending probe */
+	ut_assertok(device_remove(dev1, DM_REMOVE_NORMAL));
+	ut_assertok(device_probe_async(dev1));
+	ut_assert(dev_get_flags(dev1) & DM_FLAG_PROBE_PENDING);
+	ut_assertok(device_remove(dev1, DM_REMOVE_NORMAL));
+	ut_assert(!device_active(dev1));
+	ut_assert(!(dev_get_flags(dev1) & DM_FLAG_PROBE_PENDING));
+	ut_assertok(dm_probe_join_all());
+
+	/* Removing devices before booting an OS waits for pending probes */
+	ut_assertok(device_probe_async(dev1));
+	dm_remove_devices_flags(DM_REMOVE_ACTIVE_ALL);
+	ut_assert(device_active(dev1));
+	ut_assert(!(dev_get_flags(dev1) & DM_FLAG_PROBE_PENDING));
+
+	return 0;
+}
+DM_TEST(dm_test_probe_async, 0);
+
+/* Test that a probe completes in one call if nothing polls the device */
+static int dm_test_probe_async_sync(struct unit_test_state *uts)
+{
+	struct dm_test_priv *priv;
+	struct udevice *dev;
+
+	uts->skip_post_probe = 1;
+	ut_assertok(device_bind(dm_root(), DM_DRIVER_GET(test_async_drv),
+				"async", NULL, ofnode_null(), &dev));
+	ut_assertok(device_probe(dev));
+	ut_assert(device_active(dev));
+	priv = dev_get_priv(dev);
+	ut_asserteq(3, priv->op_count[DM_TEST_OP_PROBE_COMPLETE]);
+
+	return 0;
+}
+DM_TEST(dm_test_probe_async_sync, 0);
+
 /* Make sure all bound devices have a sequence number */
 static int dm_test_all_have_seq(struct unit_test_state *uts)
 {
@@ -12,6 +12,7 @@
 #include <dma.h>
 #include <test/test.h>
 #include <test/ut.h>
+#include <asm/cache.h>
 
 static int dm_test_dma_m2m(struct unit_test_state *uts)
 {
@@ -36,6 +37,41 @@ static int dm_test_dma_m2m(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_dma_m2m, UTF_SCAN_FDT);
 
+#if CONFIG_IS_ENABLED(DMA_MEMCPY_OFFLOAD)
+/* Test copying large regions with DMA, falling back to the CPU */
+static int dm_test_dma_memcpy_try(struct unit_test_state *uts)
+{
+	const size_t len = CONFIG_DMA_MEMCPY_OFFLOAD_MIN + 3;
+	u8 *src, *dst;
+	int i;
+
+	src = memalign(ARCH_DMA_MINALIGN, len + ARCH_DMA_MINALIGN);
+	dst = memalign(ARCH_DMA_MINALIGN, len + ARCH_DMA_MINALIGN);
+	ut_assertnonnull(src);
+	ut_assertnonnull(dst);
+	for (i = 0; i < len + ARCH_DMA_MINALIGN; i++)
+		src[i] = i * 7;
+
+	/* Partial cache lines at each end are copied by the CPU */
+	memset(dst, '\0', len + ARCH_DMA_MINALIGN);
+	ut_assertok(dma_memcpy_try(dst + 1, src + 1, len));
+	ut_asserteq_mem(src + 1, dst + 1, len);
+	ut_asserteq(0, dst[0]);
+	ut_asserteq(0, dst[len + 1]);
+
+	/* Too small, different alignment, or overlapping */
+	ut_asserteq(-EINVAL, dma_memcpy_try(dst, src, len / 2));
+	ut_asserteq(-EINVAL, dma_memcpy_try(dst + 1, src + 2, len));
+	ut_asserteq(-EINVAL, dma_memcpy_try(src + ARCH_DMA_MINALIGN, src, len));
+
+	free(dst);
+	free(src);
+
+	return 0;
+}
+DM_TEST(dm_test_dma_memcpy_try, UTF_SCAN_FDT);
+#endif
+
 static int dm_test_dma(struct unit_test_state *uts)
 {
 	struct udevice *dev;
@@ -189,6 +189,38 @@ static int dm_test_eth(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_eth, UTF_SCAN_FDT);
 
+/* Test holding the link up between transfers */
+static int dm_test_eth_hold_link(struct unit_test_state *uts)
+{
+	net_ping_ip = string_to_ip("1.1.2.2");
+	env_set("ethact", "eth@10002000");
+
+	/* normally the device is stopped after each transfer */
+	ut_assertok(net_loop(PING));
+	ut_assert(!eth_is_active(eth_get_dev()));
+
+	/* while the link is held it stays running */
+	net_hold_link(true);
+	ut_assertok(net_loop(PING));
+	ut_assert(eth_is_active(eth_get_dev()));
+	ut_assertok(net_loop(PING));
+	ut_assert(eth_is_active(eth_get_dev()));
+	ut_asserteq_str("eth@10002000", env_get("ethact"));
+
+	/* a transfer which gives up does not stop it either */
+	ut_assertok(env_set("netretry", "no"));
+	ut_asserteq(-ETIMEDOUT, net_start_again());
+	ut_assert(eth_is_active(eth_get_dev()));
+	ut_assertok(env_set("netretry", NULL));
+
+	/* releasing the link stops the device */
+	net_hold_link(false);
+	ut_assert(!eth_is_active(eth_get_dev()));
+
+	return 0;
+}
+DM_TEST(dm_test_eth_hold_link, UTF_SCAN_FDT);
+
 static int dm_test_eth_alias(struct unit_test_state *uts)
 {
 	net_ping_ip = string_to_ip("1.1.2.2");
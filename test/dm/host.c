@@ -5,8 +5,11 @@
  */
 
 #include <blk.h>
+#include <bootstage.h>
 #include <dm.h>
 #include <fs.h>
+#include <malloc.h>
+#include <mapmem.h>
 #include <os.h>
 #include <sandbox_host.h>
 #include <asm/test.h>
@@ -108,6 +111,80 @@ static int dm_test_host_dup(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_host_dup, UTF_SCAN_FDT);
 
+/* Read a file in pieces from a filesystem image */
+static int check_fs_open(struct unit_test_state *uts, const char *img)
+{
+	const int size = 0x1234;
+	struct udevice *dev, *blk;
+	loff_t actwrite, actread, fsize;
+	struct blk_desc *desc;
+	struct fs_file *file;
+	char fname[256];
+	u8 buf[0x100];
+	u8 *data;
+	int i;
+
+	ut_assertok(host_create_device("fs", true, DEFAULT_BLKSZ, &dev));
+	ut_assertok(os_persistent_file(fname, sizeof(fname), img));
+	ut_assertok(host_attach_file(dev, fname));
+	ut_assertok(blk_get_from_parent(dev, &blk));
+	ut_assertok(device_probe(blk));
+	desc = dev_get_uclass_plat(blk);
+
+	data = malloc(size);
+	ut_assertnonnull(data);
+	for (i = 0; i < size; i++)
+		data[i] = i * 7;
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_write("/pread", map_to_sysmem(data), 0, size,
+			     &actwrite));
+	ut_asserteq(size, actwrite);
+
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_open("/pread", &file));
+	ut_asserteq(size, file->size);
+
+	ut_assertok(fs_pread(file, buf, 0x100, sizeof(buf), &actread));
+	ut_asserteq(sizeof(buf), actread);
+	ut_asserteq_mem(data + 0x100, buf, sizeof(buf));
+
+	/* use the filesystem for something else, which may mount it again */
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_size("/pread", &fsize));
+	ut_asserteq(size, fsize);
+
+	/* make sure the file has to mount the filesystem again */
+	fs_cache_invalidate(NULL);
+
+	/* reading stops at the end of the file */
+	ut_assertok(fs_pread(file, buf, size - 0x10, sizeof(buf), &actread));
+	ut_asserteq(0x10, actread);
+	ut_asserteq_mem(data + size - 0x10, buf, 0x10);
+
+	ut_assertok(fs_pread(file, buf, size, sizeof(buf), &actread));
+	ut_asserteq(0, actread);
+	fs_closefile(file);
+	free(data);
+
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_asserteq(-ENOENT, fs_open("/missing", &file));
+
+	ut_assertok(host_detach_file(dev));
+	ut_assertok(device_unbind(dev));
+
+	return 0;
+}
+
+/* Test reading files in pieces with fs_open() and fs_pread() */
+static int dm_test_host_fs_open(struct unit_test_state *uts)
+{
+	ut_assertok(check_fs_open(uts, "2MB.ext2.img"));
+	ut_assertok(check_fs_open(uts, "1MB.fat32.img"));
+
+	return 0;
+}
+DM_TEST(dm_test_host_fs_open, UTF_SCAN_FDT);
+
 /* Basic test of 'host' command */
 static int dm_test_cmd_host(struct unit_test_state *uts)
 {
@@ -198,3 +275,63 @@ static int dm_test_cmd_host(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_cmd_host, UTF_SCAN_FDT | UTF_CONSOLE);
+
+/* Test that a filesystem stays mounted until its device is written */
+static int dm_test_host_fs_cache(struct unit_test_state *uts)
+{
+	ulong hits, misses, addr;
+	struct udevice *dev, *blk;
+	struct blk_desc *desc;
+	char fname[256];
+	loff_t actwrite, size;
+	u8 buf[DEFAULT_BLKSZ];
+
+	if (!CONFIG_IS_ENABLED(FS_MOUNT_CACHE) ||
+	    !CONFIG_IS_ENABLED(BOOTSTAGE))
+		return -EAGAIN;
+
+	ut_assertok(host_create_device("fs", true, DEFAULT_BLKSZ, &dev));
+	ut_assertok(os_persistent_file(fname, sizeof(fname), "2MB.ext2.img"));
+	ut_assertok(host_attach_file(dev, fname));
+	ut_assertok(blk_get_from_parent(dev, &blk));
+	ut_assertok(device_probe(blk));
+	desc = dev_get_uclass_plat(blk);
+
+	addr = map_to_sysmem(buf);
+	memset(buf, 'a', sizeof(buf));
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_write("/cache", addr, 0, sizeof(buf), &actwrite));
+
+	/* the write closes the filesystem, so it is mounted again here */
+	hits = bootstage_get_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_HIT);
+	misses = bootstage_get_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_MISS);
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_size("/cache", &size));
+	ut_asserteq(sizeof(buf), size);
+	ut_asserteq(misses + 1,
+		    bootstage_get_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_MISS));
+
+	/* later operations use the mounted filesystem */
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_size("/cache", &size));
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assert(fs_exists("/cache"));
+	ut_asserteq(hits + 2,
+		    bootstage_get_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_HIT));
+	ut_asserteq(misses + 1,
+		    bootstage_get_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_MISS));
+
+	/* writing to the device directly drops it */
+	ut_asserteq(1, blk_read(blk, 0, 1, buf));
+	ut_asserteq(1, blk_write(blk, 0, 1, buf));
+	ut_assertok(fs_set_blk_dev_with_part(desc, 0));
+	ut_assertok(fs_size("/cache", &size));
+	ut_asserteq(misses + 2,
+		    bootstage_get_count(BOOTSTAGE_ID_COUNT_FS_MOUNT_MISS));
+
+	ut_assertok(host_detach_file(dev));
+	ut_assertok(device_unbind(dev));
+
+	return 0;
+}
+DM_TEST(dm_test_host_fs_cache, UTF_SCAN_FDT);
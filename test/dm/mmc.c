@@ -3,9 +3,17 @@
  * Copyright (C) 2015 Google, Inc
  */
 
+#include <bloblist.h>
+#include <cyclic.h>
 #include <dm.h>
+#include <memalign.h>
 #include <mmc.h>
 #include <part.h>
+#include <time.h>
+#include <asm/global_data.h>
+#include <asm/test.h>
+#include <dm/device-internal.h>
+#include <dm/lists.h>
 #include <dm/test.h>
 #include <test/test.h>
 #include <test/ut.h>
@@ -48,6 +56,139 @@ static int dm_test_mmc_blk(struct unit_test_state *uts)
 	ut_asserteq(4, blk_dread(dev_desc, 0, 4, read));
 	ut_asserteq_mem(write, read, sizeof(write));
 
+	/* The erased state is zero, so blocks [2 - 3] can be zeroed too */
+	for (i = 0; i < sizeof(write); i++)
+		write[i] = i;
+	ut_asserteq(4, blk_dwrite(dev_desc, 0, 4, write));
+	memset(&write[2 * 512], '\0', 2 * 512);
+	ut_asserteq(2, blk_dzero(dev_desc, 2, 2));
+	ut_asserteq(4, blk_dread(dev_desc, 0, 4, read));
+	ut_asserteq_mem(write, read, sizeof(write));
+
 	return 0;
 }
 DM_TEST(dm_test_mmc_blk, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+
+/* Test starting initialisation in the background and then completing it */
+static int dm_test_mmc_init_async(struct unit_test_state *uts)
+{
+	struct udevice *dev;
+	struct mmc *mmc;
+
+	if (!CONFIG_IS_ENABLED(MMC_INIT_ASYNC))
+		return -EAGAIN;
+
+	/* probing sets the card up, so start again */
+	ut_assertok(uclass_get_device(UCLASS_MMC, 0, &dev));
+	mmc = mmc_get_mmc_dev(dev);
+	ut_assertnonnull(mmc);
+	mmc->has_init = 0;
+
+	ut_assertok(mmc_start_init_async(mmc));
+	ut_asserteq(1, mmc->init_in_progress);
+
+	/* the sandbox card powers up at once, so there is nothing to poll */
+	ut_asserteq(0, mmc->async_init);
+	ut_assertok(mmc_poll_op_cond(mmc));
+
+	ut_assertok(mmc_init(mmc));
+	ut_asserteq(1, mmc->has_init);
+	ut_asserteq(0, mmc->init_in_progress);
+
+	/* starting again does nothing once the card is set up */
+	ut_assertok(mmc_start_init_async(mmc));
+	ut_asserteq(0, mmc->init_in_progress);
+
+	/* now with a card which is still busy when mmc_init() is called */
+	mmc->has_init = 0;
+	sandbox_mmc_set_busy(dev, 20);
+	ut_assertok(mmc_start_init_async(mmc));
+	ut_asserteq(1, mmc->init_in_progress);
+	ut_asserteq(1, mmc->async_init);
+	ut_asserteq(1, mmc->sd_op_cond_pending);
+	ut_asserteq(-EAGAIN, mmc_poll_op_cond(mmc));
+
+	/* only mmc_init() polls the card while it waits */
+	ut_assertok(mmc_init(mmc));
+	ut_asserteq(1, mmc->has_init);
+	ut_asserteq(0, mmc->async_init);
+	ut_asserteq(0, mmc->sd_op_cond_pending);
+	ut_asserteq(0, sandbox_mmc_get_cyclic_polls(dev));
+
+	/* a card which times out in the background is set up by mmc_init() */
+	mmc->has_init = 0;
+	sandbox_mmc_set_busy(dev, 3);
+	ut_assertok(mmc_start_init_async(mmc));
+	ut_asserteq(1, mmc->sd_op_cond_pending);
+	mmc->op_cond_start = get_timer(0) - 2000;
+	schedule();
+
+	/* the cyclic function gave up after one poll, without the fallback */
+	ut_asserteq(1, sandbox_mmc_get_cyclic_polls(dev));
+	ut_asserteq(0, mmc->init_in_progress);
+	ut_asserteq(0, mmc->async_init);
+	ut_assertok(mmc_init(mmc));
+	ut_asserteq(1, mmc->has_init);
+	ut_asserteq(1, sandbox_mmc_get_cyclic_polls(dev));
+
+	return 0;
+}
+DM_TEST(dm_test_mmc_init_async, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+
+/* Test that the recorded eMMC setup is reused correctly after a reset */
+static int dm_test_mmc_handoff(struct unit_test_state *uts)
+{
+	ALLOC_CACHE_ALIGN_BUFFER(u8, ext_csd, MMC_MAX_BLOCK_LEN);
+	struct mmc_handoff_card *card;
+	struct mmc_handoff *ho;
+	struct udevice *dev;
+	struct mmc *mmc;
+	ofnode node;
+
+	if (!CONFIG_IS_ENABLED(MMC_HANDOFF))
+		return -EAGAIN;
+
+	node = ofnode_path("/mmc8");
+	ut_assert(ofnode_valid(node));
+	ut_assertok(lists_bind_fdt(gd->dm_root, node, &dev, NULL, false));
+	ut_assertok(device_probe(dev));
+	mmc = mmc_get_mmc_dev(dev);
+	ut_assert(IS_MMC(mmc));
+	ut_asserteq(MMC_HS_52, mmc->selected_mode);
+	ut_asserteq(8, mmc->bus_width);
+
+	ho = bloblist_find(BLOBLISTT_U_BOOT_MMC, sizeof(*ho));
+	ut_assertnonnull(ho);
+	ut_asserteq(1, ho->count);
+	card = &ho->card[0];
+	ut_asserteq_mem(mmc->cid, card->cid, sizeof(card->cid));
+	ut_asserteq(MMC_HS_52, card->mode);
+	ut_asserteq(1, card->has_ext_csd);
+
+	/* the snapshot follows the switch to the first boot partition */
+	ut_assertok(blk_dselect_hwpart(mmc_get_blk_desc(mmc), 1));
+	ut_asserteq(1, card->ext_csd[EXT_CSD_PART_CONF] & PART_ACCESS_MASK);
+
+	/*
+	 * Set the card up again using the snapshot. The card is reset to the
+	 * user partition, so that must not be taken from the snapshot.
+	 */
+	mmc->has_init = 0;
+	ut_assertok(mmc_init(mmc));
+	ut_asserteq(MMC_HS_52, mmc->selected_mode);
+	ut_asserteq(8, mmc->bus_width);
+	ut_asserteq(0, mmc_get_blk_desc(mmc)->hwpart);
+	ut_asserteq(0, mmc->part_config & PART_ACCESS_MASK);
+
+	ut_assertok(mmc_send_ext_csd(mmc, ext_csd));
+	ut_asserteq(ext_csd[EXT_CSD_PART_CONF],
+		    mmc->ext_csd[EXT_CSD_PART_CONF]);
+	ut_asserteq(ext_csd[EXT_CSD_ERASE_GROUP_DEF],
+		    mmc->ext_csd[EXT_CSD_ERASE_GROUP_DEF]);
+	ut_asserteq(ext_csd[EXT_CSD_PART_CONF],
+		    card->ext_csd[EXT_CSD_PART_CONF]);
+	ut_asserteq(1, ho->count);
+
+	return 0;
+}
+DM_TEST(dm_test_mmc_handoff, UTF_SCAN_FDT);
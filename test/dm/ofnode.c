@@ -19,6 +19,7 @@
 #include <abuf.h>
 #include <dm.h>
 #include <log.h>
+#include <malloc.h>
 #include <of_live.h>
 #include <dm/device-internal.h>
 #include <dm/lists.h>
@@ -1530,3 +1531,74 @@ static int dm_test_bool(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_bool, UTF_SCAN_FDT);
+
+/* test that a tree with properties loaded on demand matches a normal one */
+static int dm_test_oftree_lazy(struct unit_test_state *uts)
+{
+	struct device_node *lazy, *eager, *lnp, *enp;
+	struct of_live_stats before, after;
+	struct property *lpp, *epp;
+	int count;
+
+	if (!CONFIG_IS_ENABLED(OF_LIVE_LAZY))
+		return -EAGAIN;
+
+	of_live_get_stats(&before);
+	ut_assertok(unflatten_device_tree(gd->fdt_blob, &eager));
+	ut_assertok(unflatten_device_tree_lazy(gd->fdt_blob, &lazy));
+
+	/* Nothing is loaded until the properties are accessed */
+	of_live_get_stats(&after);
+	ut_asserteq(before.nodes_loaded, after.nodes_loaded);
+
+	count = 0;
+	for (lnp = lazy, enp = eager; lnp && enp;
+	     lnp = of_find_all_nodes(lnp), enp = of_find_all_nodes(enp)) {
+		ut_asserteq_str(enp->full_name, lnp->full_name);
+		ut_asserteq_str(enp->name, lnp->name);
+		ut_asserteq_str(enp->type, lnp->type);
+		ut_asserteq(enp->phandle, lnp->phandle);
+
+		lpp = of_node_props(lnp);
+		ut_assert(!IS_ERR(lpp));
+		for (epp = enp->properties; lpp && epp;
+		     lpp = lpp->next, epp = epp->next) {
+			ut_asserteq_str(epp->name, lpp->name);
+			ut_asserteq(epp->length, lpp->length);
+			ut_asserteq_mem(epp->value, lpp->value, epp->length);
+		}
+		ut_assertnull(lpp);
+		ut_assertnull(epp);
+		count++;
+	}
+	ut_assertnull(lnp);
+	ut_assertnull(enp);
+
+	of_live_get_stats(&after);
+	ut_asserteq(count, after.nodes_loaded - before.nodes_loaded);
+
+	/* Loading again does nothing */
+	ut_assertok(of_live_load_props(lazy));
+	of_live_get_stats(&before);
+	ut_asserteq(after.nodes_loaded, before.nodes_loaded);
+	ut_asserteq(after.props_size, before.props_size);
+	of_live_free(lazy);
+
+	/* A node whose properties cannot be loaded is not usable */
+	ut_assertok(unflatten_device_tree_lazy(gd->fdt_blob, &lazy));
+	malloc_enable_testing(0);
+	ut_asserteq_ptr(ERR_PTR(-ENOMEM), of_node_props(lazy));
+	ut_assert(!of_device_is_available(lazy));
+	malloc_disable_testing();
+	ut_assertnonnull(lazy->lazy_blob);
+
+	/* but loading works once there is memory again */
+	ut_assert(!IS_ERR_OR_NULL(of_node_props(lazy)));
+	ut_assert(of_device_is_available(lazy));
+
+	of_live_free(lazy);
+	of_live_free(eager);
+
+	return 0;
+}
+DM_TEST(dm_test_oftree_lazy, 0);
@@ -194,3 +194,58 @@ static int dm_test_part_get_info_by_type(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_part_get_info_by_type, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+
+static int dm_test_part_find(struct unit_test_state *uts)
+{
+	char str_disk_guid[UUID_STR_LEN + 1];
+	struct disk_partition info;
+	struct blk_desc *mmc_dev_desc;
+	struct disk_partition parts[2] = {
+		{
+			.start = 48, /* GPT data takes up the first 34 blocks or so */
+			.size = 1,
+			.name = "test1",
+		},
+		{
+			.start = 49,
+			.size = 1,
+			.name = "test2",
+		},
+	};
+
+	if (!CONFIG_IS_ENABLED(RANDOM_UUID) ||
+	    !CONFIG_IS_ENABLED(PARTITION_UUIDS))
+		return -EAGAIN;
+
+	ut_asserteq(2, blk_get_device_by_str("mmc", "2", &mmc_dev_desc));
+	gen_rand_uuid_str(parts[0].uuid, UUID_STR_FORMAT_STD);
+	gen_rand_uuid_str(parts[1].uuid, UUID_STR_FORMAT_STD);
+	gen_rand_uuid_str(str_disk_guid, UUID_STR_FORMAT_STD);
+	ut_assertok(gpt_restore(mmc_dev_desc, str_disk_guid, parts,
+				ARRAY_SIZE(parts)));
+
+	ut_asserteq(2, part_get_info_by_name(mmc_dev_desc, "test2", &info));
+	ut_asserteq(49, info.start);
+	ut_asserteq_str("test2", (char *)info.name);
+	ut_asserteq(-ENOENT, part_get_info_by_name(mmc_dev_desc, "test3",
+						   &info));
+
+	ut_asserteq(1, part_get_info_by_uuid(mmc_dev_desc, parts[0].uuid,
+					     &info));
+	ut_asserteq(48, info.start);
+	ut_asserteq(-ENOENT, part_get_info_by_uuid(mmc_dev_desc, str_disk_guid,
+						   &info));
+
+	/* Writing a new GPT must discard any cached copy of the old one */
+	strcpy((char *)parts[1].name, "test3");
+	ut_assertok(gpt_restore(mmc_dev_desc, str_disk_guid, parts,
+				ARRAY_SIZE(parts)));
+	ut_asserteq(-ENOENT, part_get_info_by_name(mmc_dev_desc, "test2",
+						   &info));
+	ut_asserteq(2, part_get_info_by_name(mmc_dev_desc, "test3", &info));
+	ut_asserteq(2, part_get_info_by_uuid(mmc_dev_desc, parts[1].uuid,
+					     &info));
+
+	return 0;
+}
+DM_TEST(dm_test_part_find, UTF_SCAN_PDATA | UTF_SCAN_FDT);
@@ -88,3 +88,30 @@ static int dm_test_serial(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_serial, UTF_SCAN_FDT);
+
+/* Test that output is buffered while the uart is busy */
+static int dm_test_serial_tx_buffer(struct unit_test_state *uts)
+{
+	size_t start, stalled, flushed;
+
+	if (!IS_ENABLED(CONFIG_SERIAL_TX_BUFFER))
+		return -EAGAIN;
+
+	sandbox_serial_endisable(false);
+	start = sandbox_serial_written();
+	sandbox_serial_tx_stall(true);
+	serial_puts(test_message);
+	stalled = sandbox_serial_written();
+
+	/* Flushing sends everything, with a \r added before each \n */
+	sandbox_serial_tx_stall(false);
+	serial_flush();
+	flushed = sandbox_serial_written();
+	sandbox_serial_endisable(true);
+
+	ut_asserteq(start, stalled);
+	ut_asserteq(sizeof(test_message) - 1 + 2, flushed - start);
+
+	return 0;
+}
+DM_TEST(dm_test_serial_tx_buffer, UTF_SCAN_FDT);
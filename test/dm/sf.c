@@ -101,3 +101,65 @@ static int dm_test_spi_flash_func(struct unit_test_state *uts)
 	return 0;
 }
 DM_TEST(dm_test_spi_flash_func, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+
+/* Test that 'sf update' avoids needless erase and program cycles */
+static int dm_test_spi_flash_update(struct unit_test_state *uts)
+{
+	int size = 0x10000;
+	u8 *src, *dst;
+	int i;
+
+	src = map_sysmem(0x20000, size);
+	dst = map_sysmem(0x40000, size);
+	for (i = 0; i < size; i++)
+		src[i] = i;
+
+	ut_assertok(run_command("host save hostfs - 0 spi.bin 200000", 0));
+	ut_assertok(run_command("sf probe", 0));
+	ut_assertok(run_command("sf erase 0 10000", 0));
+	ut_assert_skip_to_linen("SF: 65536 bytes @ 0x0 Erased: OK");
+
+	/* Blank sectors are programmed without being erased first */
+	ut_assertok(run_command("sf update 20000 0 10000", 0));
+	ut_assert_skip_to_linen("\r65536 bytes written, 0 bytes skipped, 0 sectors erased");
+	ut_assertok(run_command("sf read 40000 0 10000", 0));
+	ut_asserteq_mem(src, dst, size);
+
+	/* Writing the same data again does nothing */
+	ut_assertok(run_command("sf update 20000 0 10000", 0));
+	ut_assert_skip_to_linen("\r0 bytes written, 65536 bytes skipped, 0 sectors erased");
+
+	/* Changing a single byte needs that sector to be erased again */
+	src[0x1234] ^= 0xff;
+	ut_assertok(run_command("sf update 20000 0 10000", 0));
+	ut_assertok(run_command("sf read 40000 0 10000", 0));
+	ut_asserteq_mem(src, dst, size);
+
+	/* Only clearing bits programs the changed page without an erase */
+	if (IS_ENABLED(CONFIG_CMD_SF_UPDATE_PROGRAM_ONLY)) {
+		src[0x2345] = 0;
+		ut_assertok(run_command("sf update 20000 0 10000", 0));
+		ut_assert_skip_to_linen("\r256 bytes written, 65280 bytes skipped, 0 sectors erased");
+		ut_assertok(run_command("sf read 40000 0 10000", 0));
+		ut_asserteq_mem(src, dst, size);
+	}
+
+	/* Pages which are blank after the erase are not programmed */
+	memset(src, 0xff, size);
+	ut_assertok(run_command("sf update 20000 0 10000", 0));
+	ut_assert_skip_to_linen("\r0 bytes written, 65536 bytes skipped, ");
+	ut_assertok(run_command("sf read 40000 0 10000", 0));
+	ut_asserteq_mem(src, dst, size);
+
+	unmap_sysmem(dst);
+	unmap_sysmem(src);
+
+	/*
+	 * Since we are about to destroy all devices, we must tell sandbox
+	 * to forget the emulation device
+	 */
+	sandbox_sf_unbind_emul(state_get_current(), 0, 0);
+
+	return 0;
+}
+DM_TEST(dm_test_spi_flash_update, UTF_SCAN_PDATA | UTF_SCAN_FDT | UTF_CONSOLE);
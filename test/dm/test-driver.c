@@ -197,3 +197,29 @@ U_BOOT_DRIVER(test_act_dma_vital_clk_drv) = {
 	.unbind	= test_manual_unbind,
 	.flags	= DM_FLAG_VITAL | DM_FLAG_ACTIVE_DMA,
 };
+
+/* Number of calls to probe_complete() before the device is ready */
+#define TEST_ASYNC_POLLS	3
+
+static int test_async_probe_complete(struct udevice *dev)
+{
+	struct dm_test_priv *priv = dev_get_priv(dev);
+
+	dm_testdrv_op_count[DM_TEST_OP_PROBE_COMPLETE]++;
+	if (++priv->op_count[DM_TEST_OP_PROBE_COMPLETE] < TEST_ASYNC_POLLS)
+		return -EAGAIN;
+
+	return 0;
+}
+
+U_BOOT_DRIVER(test_async_drv) = {
+	.name	= "test_async_drv",
+	.id	= UCLASS_TEST,
+	.ops	= &test_manual_ops,
+	.bind	= test_manual_bind,
+	.probe	= test_manual_probe,
+	.probe_complete	= test_async_probe_complete,
+	.remove	= test_manual_remove,
+	.unbind	= test_manual_unbind,
+	.flags	= DM_FLAG_PROBE_ASYNC,
+};
@@ -13,7 +13,9 @@
 #include <dm/test.h>
 #include <dm/read.h>
 #include <dm/root.h>
+#include <dm/snapshot.h>
 #include <dm/device-internal.h>
+#include <dm/lists.h>
 #include <dm/devres.h>
 #include <dm/uclass-internal.h>
 #include <dm/util.h>
@@ -179,6 +181,118 @@ static int dm_test_fdt(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_fdt, 0);
 
+/* Test that compatible lookup finds the first driver in the linker list */
+static int dm_test_fdt_lookup_compat(struct unit_test_state *uts)
+{
+	struct driver *driver = ll_entry_start(struct driver, driver);
+	const int n_ents = ll_entry_count(struct driver, driver);
+	const struct udevice_id *of_id, *id, *found_id;
+	struct driver *entry, *first;
+
+	for (entry = driver; entry != driver + n_ents; entry++) {
+		for (of_id = entry->of_match; of_id && of_id->compatible;
+		     of_id++) {
+			/* Find the first driver with this string */
+			for (first = driver; first <= entry; first++) {
+				for (id = first->of_match;
+				     id && id->compatible; id++) {
+					if (!strcmp(id->compatible,
+						    of_id->compatible))
+						break;
+				}
+				if (id && id->compatible)
+					break;
+			}
+
+			found_id = NULL;
+			ut_asserteq_ptr(first,
+					lists_driver_lookup_compat(of_id->compatible,
+								   &found_id));
+			ut_asserteq_ptr(id, found_id);
+		}
+	}
+	ut_assertnull(lists_driver_lookup_compat("u-boot,no-such-device",
+						 &found_id));
+
+	return 0;
+}
+DM_TEST(dm_test_fdt_lookup_compat, 0);
+
+/* Test binding devices using a snapshot of the devices already bound */
+static int dm_test_fdt_snapshot(struct unit_test_state *uts)
+{
+	struct udevice *dev, *parent;
+	const struct udevice_id *id;
+	struct driver *drv;
+	ofnode node;
+
+	if (!CONFIG_IS_ENABLED(DM_SNAPSHOT))
+		return -EAGAIN;
+
+	ut_assertok(uclass_find_first_device(UCLASS_TEST_FDT, &dev));
+	node = dev_ofnode(dev);
+	parent = dev->parent;
+
+	/* Nothing is found until a snapshot is in use */
+	ut_asserteq(-ENOENT, dm_snapshot_lookup(node, &drv, &id));
+	ut_assertok(dm_snapshot_write());
+	ut_assertok(dm_snapshot_begin());
+	ut_assertok(dm_snapshot_lookup(node, &drv, &id));
+	ut_asserteq_ptr(dev->driver, drv);
+	ut_asserteq(dev->driver_data, id->data);
+	ut_asserteq(-ENOENT, dm_snapshot_lookup(ofnode_root(), &drv, &id));
+
+	/* Binding the node again uses the same driver */
+	ut_assertok(device_unbind(dev));
+	ut_assertok(lists_bind_fdt(parent, node, &dev, NULL, false));
+	ut_assertnonnull(dev);
+	ut_asserteq_ptr(drv, dev->driver);
+	ut_asserteq(id->data, dev->driver_data);
+
+	dm_snapshot_end();
+	ut_asserteq(-ENOENT, dm_snapshot_lookup(node, &drv, &id));
+
+	return 0;
+}
+DM_TEST(dm_test_fdt_snapshot, UTF_SCAN_PDATA | UTF_SCAN_FDT | UTF_FLAT_TREE);
+
+/* Test looking up devices by node as they are moved and unbound */
+static int dm_test_fdt_ofnode_lookup(struct unit_test_state *uts)
+{
+	struct udevice *dev, *found;
+	ofnode node, other;
+
+	ut_assertok(uclass_find_first_device(UCLASS_TEST_FDT, &dev));
+	node = dev_ofnode(dev);
+	ut_assert(ofnode_valid(node));
+
+	ut_assertok(device_find_global_by_ofnode(node, &found));
+	ut_asserteq_ptr(dev, found);
+	ut_assertok(uclass_find_device_by_ofnode(UCLASS_TEST_FDT, node, &found));
+	ut_asserteq_ptr(dev, found);
+	ut_asserteq(-ENODEV, uclass_find_device_by_ofnode(UCLASS_I2C, node,
+							  &found));
+
+	/* Moving the device to another node must be reflected in lookups */
+	other = ofnode_path("/aliases");
+	ut_assert(ofnode_valid(other));
+	dev_set_ofnode(dev, other);
+	ut_asserteq(-ENOENT, device_find_global_by_ofnode(node, &found));
+	ut_assertok(device_find_global_by_ofnode(other, &found));
+	ut_asserteq_ptr(dev, found);
+	dev_set_ofnode(dev, node);
+	ut_asserteq(-ENOENT, device_find_global_by_ofnode(other, &found));
+
+	/* Once unbound, the device must not be found */
+	ut_assertok(device_unbind(dev));
+	ut_asserteq(-ENOENT, device_find_global_by_ofnode(node, &found));
+	ut_asserteq(-ENODEV, uclass_find_device_by_ofnode(UCLASS_TEST_FDT,
+							  node, &found));
+
+	return 0;
+}
+DM_TEST(dm_test_fdt_ofnode_lookup, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+
 static int dm_test_alias_highest_id(struct unit_test_state *uts)
 {
 	int ret;
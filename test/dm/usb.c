@@ -166,6 +166,26 @@ static int dm_test_usb_stop(struct unit_test_state *uts)
 }
 DM_TEST(dm_test_usb_stop, UTF_SCAN_PDATA | UTF_SCAN_FDT);
 
+/* test that scanning all controllers together finds the same devices */
+static int dm_test_usb_scan_parallel(struct unit_test_state *uts)
+{
+	struct udevice *dev;
+
+	if (!IS_ENABLED(CONFIG_USB_SCAN_PARALLEL))
+		return -EAGAIN;
+
+	state_set_skip_delays(true);
+	ut_assertok(usb_init());
+	ut_assertok(uclass_get_device(UCLASS_MASS_STORAGE, 0, &dev));
+	ut_assertok(uclass_get_device(UCLASS_MASS_STORAGE, 1, &dev));
+	ut_assertok(uclass_get_device(UCLASS_MASS_STORAGE, 2, &dev));
+	ut_asserteq(6, count_usb_devices());
+	ut_assertok(usb_stop());
+
+	return 0;
+}
+DM_TEST(dm_test_usb_scan_parallel, UTF_SCAN_PDATA | UTF_SCAN_FDT);
+
 /**
  * dm_test_usb_keyb() - test USB keyboard driver
  *
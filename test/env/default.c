@@ -0,0 +1,51 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for looking up variables in the default environment
+ */
+
+#include <env.h>
+#include <env_internal.h>
+#include <malloc.h>
+#include <asm/global_data.h>
+#include <test/env.h>
+#include <test/ut.h>
+
+DECLARE_GLOBAL_DATA_PTR;
+
+/* Check that each default variable is found, using the build-time index */
+static int env_test_default_index(struct unit_test_state *uts)
+{
+	const char *p, *val;
+	char name[64];
+	char *buf;
+	int count;
+
+	buf = malloc(CONFIG_ENV_SIZE);
+	ut_assertnonnull(buf);
+
+	for (count = 0, p = default_environment; *p; p = val + strlen(val) + 1) {
+		val = strchr(p, '=');
+		ut_assertnonnull(val);
+		ut_assert(val - p < sizeof(name));
+		strlcpy(name, p, val - p + 1);
+		val++;
+
+		ut_asserteq(strlen(val),
+			    env_get_default_into(name, buf, CONFIG_ENV_SIZE));
+		ut_asserteq_str(val, buf);
+		count++;
+	}
+	ut_assert(count > 0);
+
+	/* the index matches the environment, so was used for all of that */
+	ut_assert(gd->flags & GD_FLG_ENV_INDEX_CHECKED);
+	ut_assert(gd->flags & GD_FLG_ENV_INDEX_OK);
+
+	/* a missing variable is not found, without scanning */
+	ut_asserteq(-1, env_get_default_into("no_such_default_var", buf,
+					     CONFIG_ENV_SIZE));
+	free(buf);
+
+	return 0;
+}
+ENV_TEST(env_test_default_index, 0);
@@ -6,14 +6,17 @@
 
 #include <command.h>
 #include <log.h>
+#include <malloc.h>
 #include <search.h>
 #include <stdio.h>
+#include <time.h>
 #include <vsprintf.h>
 #include <test/env.h>
 #include <test/ut.h>
 
 #define SIZE 32
 #define ITERATIONS 10000
+#define LARGE_ENV_VARS 10000
 
 static int htab_fill(struct unit_test_state *uts,
 		     struct hsearch_data *htab, size_t size)
@@ -122,3 +125,66 @@ static int env_test_htab_deletes(struct unit_test_state *uts)
 	return 0;
 }
 ENV_TEST(env_test_htab_deletes, 0);
+
+/*
+ * Import and export a large environment, which needs the table to grow well
+ * beyond its initial size. This also shows how long each step takes.
+ */
+static int env_test_htab_large(struct unit_test_state *uts)
+{
+	struct hsearch_data htab, copy;
+	struct env_entry item, *ritem;
+	char *env, *p, *out = NULL;
+	char key[20], val[20];
+	ulong start, import_us, export_us;
+	ssize_t size;
+	int i;
+
+	if (!IS_ENABLED(CONFIG_ENV_HASH_RESIZE))
+		return -EAGAIN;
+
+	env = malloc(LARGE_ENV_VARS * 32 + 1);
+	ut_assertnonnull(env);
+	for (i = 0, p = env; i < LARGE_ENV_VARS; i++)
+		p += sprintf(p, "var%d=value%d", i, i) + 1;
+	*p++ = '\0';
+
+	memset(&htab, '\0', sizeof(htab));
+	start = timer_get_us();
+	ut_asserteq(1, himport_r(&htab, env, p - env, '\0', 0, 0, 0, NULL));
+	import_us = timer_get_us() - start;
+	ut_asserteq(LARGE_ENV_VARS, htab.filled);
+	ut_assert(htab.size > CONFIG_ENV_MAX_ENTRIES);
+	ut_assert(htab.filled * 4 <= htab.size * 3);
+
+	for (i = 0; i < LARGE_ENV_VARS; i++) {
+		sprintf(key, "var%d", i);
+		sprintf(val, "value%d", i);
+		item.key = key;
+		item.data = NULL;
+		hsearch_r(item, ENV_FIND, &ritem, &htab, 0);
+		ut_assertnonnull(ritem);
+		ut_asserteq_str(val, ritem->data);
+	}
+
+	start = timer_get_us();
+	size = hexport_r(&htab, '\0', 0, &out, 0, 0, NULL);
+	export_us = timer_get_us() - start;
+	ut_asserteq(p - env, size);
+
+	/* the export is sorted, so re-import it to check it */
+	memset(&copy, '\0', sizeof(copy));
+	ut_asserteq(1, himport_r(&copy, out, size, '\0', 0, 0, 0, NULL));
+	ut_asserteq(LARGE_ENV_VARS, copy.filled);
+
+	printf("%d variables: import %lu us, export %lu us, table size %u\n",
+	       LARGE_ENV_VARS, import_us, export_us, htab.size);
+
+	hdestroy_r(&copy);
+	hdestroy_r(&htab);
+	free(out);
+	free(env);
+
+	return 0;
+}
+ENV_TEST(env_test_htab_large, 0);
@@ -83,3 +83,41 @@ static int hush_test_until(struct unit_test_state *uts)
 	return 0;
 }
 HUSH_TEST(hush_test_until, UTF_CONSOLE);
+
+static int hush_test_parse_cache(struct unit_test_state *uts)
+{
+	int i;
+
+	if (!IS_ENABLED(CONFIG_HUSH_PARSE_CACHE) ||
+	    !(gd->flags & GD_FLG_HUSH_OLD_PARSER))
+		return -EAGAIN;
+
+	/* Later runs use the cached script but still see the new variable */
+	for (i = 0; i < 3; i++) {
+		env_set_ulong("loop_cache", i);
+		ut_assertok(run_command("for loop_j in a b; do echo $loop_j $loop_cache; done", 0));
+		ut_assert_nextline("a %d", i);
+		ut_assert_nextline("b %d", i);
+		ut_assert_console_end();
+	}
+
+	/* Leaving a loop part-way through must not change the cached script */
+	for (i = 0; i < 2; i++) {
+		ut_assertok(run_command("for loop_k in c d; do echo $loop_k; exit; done", 0));
+		ut_assert_nextline("c");
+		ut_assert_console_end();
+	}
+
+	/* Syntax errors are still reported each time */
+	for (i = 0; i < 2; i++) {
+		ut_asserteq(1, run_command("echo ${loop_cache", 0));
+		ut_assert_nextline("syntax error");
+		ut_assert_console_end();
+	}
+
+	env_set("loop_cache", NULL);
+	puts("Beware: this test set local variables loop_j and loop_k and they cannot be unset!");
+
+	return 0;
+}
+HUSH_TEST(hush_test_parse_cache, UTF_CONSOLE);
@@ -0,0 +1,297 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for writing sparse images as they arrive
+ */
+
+#include <image-sparse.h>
+#include <malloc.h>
+#include <memalign.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+#define SPARSE_TEST_BLKSZ	512
+#define SPARSE_TEST_BLKS	32
+/* Two buffers of two blocks each, so a chunk needs several of them */
+#define SPARSE_TEST_BUF_SIZE	(4 * SPARSE_TEST_BLKSZ)
+#define SPARSE_TEST_FILL	0x12345678
+
+static u8 sparse_test_disk[SPARSE_TEST_BLKS * SPARSE_TEST_BLKSZ];
+static char sparse_test_msg[64];
+static lbaint_t sparse_test_zeroed;
+
+static lbaint_t sparse_test_write(struct sparse_storage *info, lbaint_t blk,
+				  lbaint_t blkcnt, const void *buffer)
+{
+	memcpy(sparse_test_disk + blk * info->blksz, buffer,
+	       blkcnt * info->blksz);
+
+	return blkcnt;
+}
+
+static lbaint_t sparse_test_reserve(struct sparse_storage *info,
+				    lbaint_t blk, lbaint_t blkcnt)
+{
+	return blkcnt;
+}
+
+static lbaint_t sparse_test_zero(struct sparse_storage *info, lbaint_t blk,
+				 lbaint_t blkcnt)
+{
+	memset(sparse_test_disk + blk * info->blksz, '\0',
+	       blkcnt * info->blksz);
+	sparse_test_zeroed += blkcnt;
+
+	return blkcnt;
+}
+
+static void sparse_test_mssg(const char *str, char *response)
+{
+	strlcpy(sparse_test_msg, str, sizeof(sparse_test_msg));
+}
+
+static void sparse_test_setup(struct sparse_storage *info)
+{
+	memset(sparse_test_disk, 0xff, sizeof(sparse_test_disk));
+	*sparse_test_msg = '\0';
+	sparse_test_zeroed = 0;
+	info->blksz = SPARSE_TEST_BLKSZ;
+	info->start = 0;
+	info->size = SPARSE_TEST_BLKS;
+	info->write = sparse_test_write;
+	info->reserve = sparse_test_reserve;
+	info->zero = NULL;
+	info->mssg = sparse_test_mssg;
+}
+
+static void *sparse_test_chunk(void *ptr, int type, u32 chunk_sz, u32 data_sz)
+{
+	chunk_header_t *chunk = ptr;
+
+	chunk->chunk_type = type;
+	chunk->reserved1 = 0;
+	chunk->chunk_sz = chunk_sz;
+	chunk->total_sz = sizeof(*chunk) + data_sz;
+
+	return chunk + 1;
+}
+
+/* Feed an image to a stream in small pieces, flushing after each one */
+static int sparse_test_feed(struct unit_test_state *uts,
+			    struct sparse_stream *ss, const u8 *image,
+			    size_t size)
+{
+	size_t upto, n;
+
+	for (upto = 0; upto < size; upto += n) {
+		n = min_t(size_t, size - upto, 7);
+		ut_assertok(sparse_stream_write(ss, image + upto, n, NULL));
+		ut_assertok(sparse_stream_flush(ss, NULL));
+	}
+
+	return 0;
+}
+
+/* Test writing a sparse image with each type of chunk */
+static int lib_test_sparse_stream(struct unit_test_state *uts)
+{
+	const int blk_sz = 2 * SPARSE_TEST_BLKSZ;
+	struct sparse_storage info;
+	struct sparse_stream ss;
+	sparse_header_t *hdr;
+	u8 *image, *ptr, *buf;
+	u32 *fill;
+	int i;
+
+	image = calloc(1, 16 * blk_sz);
+	ut_assertnonnull(image);
+	buf = memalign(ARCH_DMA_MINALIGN, SPARSE_TEST_BUF_SIZE);
+	ut_assertnonnull(buf);
+
+	hdr = (sparse_header_t *)image;
+	hdr->magic = SPARSE_HEADER_MAGIC;
+	hdr->major_version = 1;
+	hdr->file_hdr_sz = sizeof(*hdr);
+	hdr->chunk_hdr_sz = sizeof(chunk_header_t);
+	hdr->blk_sz = blk_sz;
+	hdr->total_blks = 8;
+	hdr->total_chunks = 4;
+	ptr = (u8 *)(hdr + 1);
+
+	/* blocks 0-5: raw data */
+	ptr = sparse_test_chunk(ptr, CHUNK_TYPE_RAW, 3, 3 * blk_sz);
+	for (i = 0; i < 3 * blk_sz; i++)
+		*ptr++ = i;
+
+	/* blocks 6-9: don't care */
+	ptr = sparse_test_chunk(ptr, CHUNK_TYPE_DONT_CARE, 2, 0);
+
+	/* blocks 10-11: filled */
+	ptr = sparse_test_chunk(ptr, CHUNK_TYPE_FILL, 1, sizeof(u32));
+	*(u32 *)ptr = SPARSE_TEST_FILL;
+	ptr += sizeof(u32);
+
+	/* blocks 12-15: more raw data */
+	ptr = sparse_test_chunk(ptr, CHUNK_TYPE_RAW, 2, 2 * blk_sz);
+	memset(ptr, 0xa5, 2 * blk_sz);
+	ptr += 2 * blk_sz;
+
+	sparse_test_setup(&info);
+	ut_assertok(sparse_stream_start(&ss, &info, buf, SPARSE_TEST_BUF_SIZE,
+					ptr - image));
+	ut_assertok(sparse_test_feed(uts, &ss, image, ptr - image));
+	ut_assertok(sparse_stream_finish(&ss, "test", NULL));
+	ut_asserteq_str("", sparse_test_msg);
+
+	for (i = 0; i < 3 * blk_sz; i++)
+		ut_asserteq((u8)i, sparse_test_disk[i]);
+	for (; i < 5 * blk_sz; i++)
+		ut_asserteq(0xff, sparse_test_disk[i]);
+	fill = (u32 *)(sparse_test_disk + i);
+	for (; i < 6 * blk_sz; i += sizeof(u32))
+		ut_asserteq(SPARSE_TEST_FILL, *fill++);
+	for (; i < 8 * blk_sz; i++)
+		ut_asserteq(0xa5, sparse_test_disk[i]);
+	for (; i < sizeof(sparse_test_disk); i++)
+		ut_asserteq(0xff, sparse_test_disk[i]);
+
+	/* An image which does not fit in the partition is rejected */
+	sparse_test_setup(&info);
+	info.size = 8;
+	ut_assertok(sparse_stream_start(&ss, &info, buf, SPARSE_TEST_BUF_SIZE,
+					ptr - image));
+	ut_asserteq(-EINVAL, sparse_stream_write(&ss, image, ptr - image,
+						 NULL));
+	ut_asserteq_str("Request would exceed partition size!",
+			sparse_test_msg);
+	ut_asserteq(-EIO, sparse_stream_finish(&ss, "test", NULL));
+
+	/* A truncated image is reported when it is finished */
+	sparse_test_setup(&info);
+	ut_assertok(sparse_stream_start(&ss, &info, buf, SPARSE_TEST_BUF_SIZE,
+					ptr - image));
+	ut_assertok(sparse_test_feed(uts, &ss, image, 100));
+	ut_asserteq(-EINVAL, sparse_stream_finish(&ss, "test", NULL));
+	ut_asserteq_str("image is incomplete", sparse_test_msg);
+
+	free(buf);
+	free(image);
+
+	return 0;
+}
+LIB_TEST(lib_test_sparse_stream, 0);
+
+/* Test writing a raw image, which is padded to a whole block */
+static int lib_test_sparse_stream_raw(struct unit_test_state *uts)
+{
+	const int size = 3 * SPARSE_TEST_BLKSZ + 100;
+	struct sparse_storage info;
+	struct sparse_stream ss;
+	u8 *image, *buf;
+	int i;
+
+	image = malloc(size);
+	ut_assertnonnull(image);
+	buf = memalign(ARCH_DMA_MINALIGN, SPARSE_TEST_BUF_SIZE);
+	ut_assertnonnull(buf);
+	for (i = 0; i < size; i++)
+		image[i] = i * 3;
+
+	sparse_test_setup(&info);
+	info.start = 2;
+	info.size = 4;
+	ut_assertok(sparse_stream_start(&ss, &info, buf, SPARSE_TEST_BUF_SIZE,
+					size));
+	ut_assertok(sparse_test_feed(uts, &ss, image, size));
+	ut_assertok(sparse_stream_finish(&ss, "test", NULL));
+
+	for (i = 0; i < 2 * SPARSE_TEST_BLKSZ; i++)
+		ut_asserteq(0xff, sparse_test_disk[i]);
+	ut_asserteq_mem(image, sparse_test_disk + i, size);
+	for (i += size; i < 6 * SPARSE_TEST_BLKSZ; i++)
+		ut_asserteq(0, sparse_test_disk[i]);
+	for (; i < sizeof(sparse_test_disk); i++)
+		ut_asserteq(0xff, sparse_test_disk[i]);
+
+	/* Too large for the partition */
+	sparse_test_setup(&info);
+	info.size = 3;
+	ut_assertok(sparse_stream_start(&ss, &info, buf, SPARSE_TEST_BUF_SIZE,
+					size));
+	ut_asserteq(-EINVAL, sparse_stream_write(&ss, image, size, NULL));
+	ut_asserteq_str("too large for partition", sparse_test_msg);
+
+	free(buf);
+	free(image);
+
+	return 0;
+}
+LIB_TEST(lib_test_sparse_stream_raw, 0);
+
+/* Test that zero-filled and skipped chunks are zeroed without writing them */
+static int lib_test_sparse_zero(struct unit_test_state *uts)
+{
+	const int blk_sz = 2 * SPARSE_TEST_BLKSZ;
+	struct sparse_storage info;
+	sparse_header_t *hdr;
+	u8 *image, *ptr;
+	int i;
+
+	image = calloc(1, 4 * blk_sz);
+	ut_assertnonnull(image);
+
+	hdr = (sparse_header_t *)image;
+	hdr->magic = SPARSE_HEADER_MAGIC;
+	hdr->major_version = 1;
+	hdr->file_hdr_sz = sizeof(*hdr);
+	hdr->chunk_hdr_sz = sizeof(chunk_header_t);
+	hdr->blk_sz = blk_sz;
+	hdr->total_blks = 6;
+	hdr->total_chunks = 3;
+	ptr = (u8 *)(hdr + 1);
+
+	/* blocks 0-3: filled with zero */
+	ptr = sparse_test_chunk(ptr, CHUNK_TYPE_FILL, 2, sizeof(u32));
+	*(u32 *)ptr = 0;
+	ptr += sizeof(u32);
+
+	/* blocks 4-7: don't care */
+	ptr = sparse_test_chunk(ptr, CHUNK_TYPE_DONT_CARE, 2, 0);
+
+	/* blocks 8-11: raw data */
+	ptr = sparse_test_chunk(ptr, CHUNK_TYPE_RAW, 2, 2 * blk_sz);
+	memset(ptr, 0xa5, 2 * blk_sz);
+
+	sparse_test_setup(&info);
+	info.zero = sparse_test_zero;
+	ut_assertok(write_sparse_image(&info, "test", image, NULL));
+	ut_asserteq_str("", sparse_test_msg);
+
+	for (i = 0; i < 4 * SPARSE_TEST_BLKSZ; i++)
+		ut_asserteq(0, sparse_test_disk[i]);
+	if (IS_ENABLED(CONFIG_IMAGE_SPARSE_ZERO_DONT_CARE)) {
+		ut_asserteq(8, sparse_test_zeroed);
+		for (; i < 8 * SPARSE_TEST_BLKSZ; i++)
+			ut_asserteq(0, sparse_test_disk[i]);
+	} else {
+		ut_asserteq(4, sparse_test_zeroed);
+		for (; i < 8 * SPARSE_TEST_BLKSZ; i++)
+			ut_asserteq(0xff, sparse_test_disk[i]);
+	}
+	for (; i < 12 * SPARSE_TEST_BLKSZ; i++)
+		ut_asserteq(0xa5, sparse_test_disk[i]);
+
+	/* Without the callback, zeroes are written as before */
+	sparse_test_setup(&info);
+	ut_assertok(write_sparse_image(&info, "test", image, NULL));
+	ut_asserteq(0, sparse_test_zeroed);
+	for (i = 0; i < 4 * SPARSE_TEST_BLKSZ; i++)
+		ut_asserteq(0, sparse_test_disk[i]);
+	for (; i < 8 * SPARSE_TEST_BLKSZ; i++)
+		ut_asserteq(0xff, sparse_test_disk[i]);
+
+	free(image);
+
+	return 0;
+}
+LIB_TEST(lib_test_sparse_zero, 0);
@@ -0,0 +1,97 @@
+// SPDX-License-Identifier: GPL-2.0+
+/*
+ * Tests for the sampling profiler
+ */
+
+#include <malloc.h>
+#include <profile.h>
+#include <time.h>
+#include <trace.h>
+#include <asm/sections.h>
+#include <test/lib.h>
+#include <test/test.h>
+#include <test/ut.h>
+
+/* Period long enough that no samples arrive from the timer during a test */
+#define PROFILE_LONG_PERIOD_US	(100 * 1000 * 1000)
+
+/* Test that samples are recorded in a ring buffer, oldest first */
+static int lib_test_profile_ring(struct unit_test_state *uts)
+{
+	const struct trace_output_hdr *hdr;
+	const struct trace_sample *sample;
+	ulong base = (ulong)_init;
+	size_t size, needed;
+	void *buf;
+	int i;
+
+	ut_assertok(profile_start(PROFILE_LONG_PERIOD_US));
+	ut_asserteq(-EALREADY, profile_start(PROFILE_LONG_PERIOD_US));
+
+	/* Samples outside U-Boot are only counted */
+	profile_sample(base - 4, 0);
+	profile_sample(base + 0x40, base + 0x84);
+	profile_sample(base + 0x44, 0);
+	ut_assertok(profile_stop());
+	ut_asserteq(-EALREADY, profile_stop());
+
+	/* Not recorded, since the profiler is stopped */
+	profile_sample(base + 0x48, 0);
+
+	size = sizeof(*hdr) + (CONFIG_PROFILE_SAMPLES + 1) * sizeof(*sample);
+	buf = malloc(size);
+	ut_assertnonnull(buf);
+	ut_asserteq(-ENOSPC, profile_list_samples(buf, sizeof(*hdr), &needed));
+	ut_asserteq(sizeof(*hdr) + 2 * sizeof(*sample), needed);
+	ut_assertok(profile_list_samples(buf, size, &needed));
+
+	hdr = buf;
+	ut_asserteq(TRACE_CHUNK_SAMPLES, hdr->type);
+	ut_asserteq(2, hdr->rec_count);
+	sample = (struct trace_sample *)(hdr + 1);
+	ut_asserteq(0x40, sample[0].pc);
+	ut_asserteq(0x84, sample[0].caller);
+	ut_asserteq(0x44, sample[1].pc);
+	ut_asserteq(TRACE_SAMPLE_NO_CALLER, sample[1].caller);
+
+	/* Fill the ring so that it wraps, which drops the oldest samples */
+	ut_assertok(profile_start(PROFILE_LONG_PERIOD_US));
+	for (i = 0; i < CONFIG_PROFILE_SAMPLES + 2; i++)
+		profile_sample(base + (i % 0x100) * 4, 0);
+	ut_assertok(profile_stop());
+
+	ut_assertok(profile_list_samples(buf, size, &needed));
+	ut_asserteq(CONFIG_PROFILE_SAMPLES, hdr->rec_count);
+	ut_asserteq(8, sample[0].pc);
+	ut_asserteq(((CONFIG_PROFILE_SAMPLES + 1) % 0x100) * 4,
+		    sample[CONFIG_PROFILE_SAMPLES - 1].pc);
+	free(buf);
+
+	return 0;
+}
+LIB_TEST(lib_test_profile_ring, 0);
+
+/* Test that the timer produces samples */
+static int lib_test_profile_timer(struct unit_test_state *uts)
+{
+	size_t needed;
+	ulong start;
+	int ret;
+
+	ret = profile_start(100);
+	if (ret == -ENOSYS)
+		return -EAGAIN;
+	ut_assertok(ret);
+
+	/* The timer uses CPU time, so keep busy until a sample arrives */
+	start = get_timer(0);
+	do {
+		profile_list_samples(NULL, 0, &needed);
+	} while (needed == sizeof(struct trace_output_hdr) &&
+		 get_timer(start) < 1000);
+	ut_assertok(profile_stop());
+	ut_assert(needed > sizeof(struct trace_output_hdr));
+
+	return 0;
+}
+LIB_TEST(lib_test_profile_timer, 0);
@@ -394,6 +394,9 @@ static int test_pre_run(struct unit_test_state *uts, struct unit_test *test)
 static int test_post_run(struct unit_test_state *uts, struct unit_test *test)
 {
 	ut_unsilence_console(uts);
+
+	/* drop any USB scan left pending by a bootdev hunter */
+	usb_init_abort();
 	if (test->flags & UTF_DM)
 		ut_assertok(dm_test_post_run(uts));
 	ut_assertok(cyclic_unregister_all());
@@ -8,9 +8,13 @@
  * This prints the list of default environment variables as currently
  * configured.
  *
+ * With -i it instead prints a C header holding an index of the variables,
+ * see include/env_index.h
  */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* Pull in the current config to define the default environment */
 #include <linux/kconfig.h>
@@ -26,8 +30,66 @@
 #define DEFAULT_ENV_INSTANCE_STATIC
 #include <generated/environment.h>
 #include <env_default.h>
+#include <env_index.h>
 
-int main(void)
+/* Number of slots for each variable, so that probe sequences stay short */
+#define INDEX_SPREAD	2
+#define INDEX_MIN_SLOTS	16
+
+/*
+ * Print a hash table of the offsets of the variables, using linear probing.
+ * Each slot holds the offset plus one, or zero if empty. Only the first
+ * definition of a variable is included, to match env_get_f().
+ */
+static int print_index(void)
+{
+	unsigned int slots, count, i, hash, len;
+	unsigned int *index;
+	char *env, *nxt, *eq;
+
+	for (count = 0, env = default_environment; *env;
+	     env += strlen(env) + 1)
+		count++;
+	for (slots = INDEX_MIN_SLOTS; slots < count * INDEX_SPREAD;)
+		slots <<= 1;
+	index = calloc(slots, sizeof(*index));
+	if (!index) {
+		fprintf(stderr, "## Error: out of memory\n");
+		return -1;
+	}
+
+	for (env = default_environment; *env; env = nxt + 1) {
+		nxt = env + strlen(env);
+		eq = strchr(env, '=');
+		if (!eq)
+			continue;
+		len = eq - env;
+		hash = env_index_hash(env, len);
+		for (i = hash & (slots - 1); index[i]; i = (i + 1) & (slots - 1)) {
+			const char *other = default_environment + index[i] - 1;
+
+			if (!strncmp(other, env, len) && other[len] == '=')
+				break;
+		}
+		if (!index[i])
+			index[i] = env - default_environment + 1;
+	}
+
+	printf("/* Automatically generated by printinitialenv - do not edit */\n\n");
+	printf("#define ENV_INDEX_ENV_SIZE\t%zu\n", sizeof(default_environment));
+	printf("#define ENV_INDEX_ENV_HASH\t%#xU\n",
+	       fnv1a(default_environment, sizeof(default_environment)));
+	printf("#define ENV_INDEX_SLOTS\t\t%u\n\n", slots);
+	printf("static const unsigned int env_index[ENV_INDEX_SLOTS] = {");
+	for (i = 0; i < slots; i++)
+		printf("%s%u,", i % 8 ? " " : "\n\t", index[i]);
+	printf("\n};\n");
+	free(index);
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
 {
 	char *env, *nxt;
 
@@ -38,7 +100,16 @@ int main(void)
 				return -1;
 			}
 		}
-		printf("%s\n", env);
+		if (argc < 2)
+			printf("%s\n", env);
+	}
+	if (argc > 1) {
+		if (strcmp(argv[1], "-i")) {
+			fprintf(stderr, "Usage: %s [-i]\n", argv[0]);
+			return -1;
+		}
+		return print_index();
 	}
+
 	return 0;
 }
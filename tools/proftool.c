@@ -70,6 +70,8 @@ enum {
  * @OUT_FMT_FLAMEGRAPH_CALLS: Write a file suitable for flamegraph.pl
  * @OUT_FMT_FLAMEGRAPH_TIMING: Write a file suitable for flamegraph.pl with the
  * counts set to the number of microseconds used by each function
+ * @OUT_FMT_FLAMEGRAPH_SAMPLES: Write a file suitable for flamegraph.pl with the
+ * counts set to the number of profiler samples in each function
  */
 enum out_format_t {
 	OUT_FMT_DEFAULT,
@@ -77,6 +79,7 @@ enum out_format_t {
 	OUT_FMT_FUNCGRAPH,
 	OUT_FMT_FLAMEGRAPH_CALLS,
 	OUT_FMT_FLAMEGRAPH_TIMING,
+	OUT_FMT_FLAMEGRAPH_SAMPLES,
 };
 
 /* Section types for v7 format (trace-cmd format) */
@@ -254,6 +257,8 @@ struct func_info *func_list;
 int func_count;			/* number of functions */
 struct trace_call *call_list;	/* list of all calls in the input trace file */
 int call_count;			/* number of calls */
+struct trace_sample *sample_list; /* list of profiler samples in the file */
+int sample_count;		/* number of samples */
 int verbose;	/* Verbosity level 0=none, 1=warn, 2=notice, 3=info, 4=debug */
 ulong text_offset;		/* text address of first function */
 ulong text_base;		/* CONFIG_TEXT_BASE from trace file */
@@ -292,7 +297,8 @@ static void usage(void)
 		"   -f <subtype>\tSpecify output subtype\n"
 		"   -m <map>\tSpecify System.map file\n"
 		"   -o <fname>\tSpecify output file\n"
-		"   -t <fname>\tSpecify trace data file (from U-Boot 'trace calls')\n"
+		"   -t <fname>\tSpecify trace data file (from U-Boot 'trace calls'\n"
+		"\t\tand/or 'profile dump')\n"
 		"   -v <0-4>\tSpecify verbosity\n"
 		"\n"
 		"Subtypes for dump-ftrace:\n"
@@ -301,7 +307,8 @@ static void usage(void)
 		"\n"
 		"Subtypes for dump-flamegraph\n"
 		"   calls - create a flamegraph of stack frames\n"
-		"   timing - create a flamegraph of microseconds for each stack frame\n");
+		"   timing - create a flamegraph of microseconds for each stack frame\n"
+		"   samples - create a flamegraph of profiler samples (caller/function)\n");
 	exit(EXIT_FAILURE);
 }
 
@@ -483,6 +490,29 @@ static int read_calls(FILE *fin, size_t count)
 	return 0;
 }
 
+/**
+ * read_samples() - Read the list of profiler samples from the trace data
+ *
+ * @fin: File to read from
+ * @count: Number of samples to read
+ * Returns: 0 if OK, -1 on error
+ */
+static int read_samples(FILE *fin, size_t count)
+{
+	notice("sample count: %zu\n", count);
+	sample_list = calloc(count, sizeof(*sample_list));
+	if (!sample_list) {
+		error("Cannot allocate sample_list\n");
+		return -1;
+	}
+	sample_count = count;
+
+	if (count && read_data(fin, sample_list, count * sizeof(*sample_list)))
+		return -1;
+
+	return 0;
+}
+
 /**
  * read_trace() - Read the U-Boot trace file
  *
@@ -515,6 +545,11 @@ static int read_trace(FILE *fin)
 			if (read_calls(fin, hdr.rec_count))
 				return 1;
 			break;
+
+		case TRACE_CHUNK_SAMPLES:
+			if (read_samples(fin, hdr.rec_count))
+				return 1;
+			break;
 		}
 	}
 	return 0;
@@ -1635,6 +1670,38 @@ static struct flame_node *create_node(const char *msg)
 	return node;
 }
 
+/**
+ * get_child() - Find or create the child node for a function
+ *
+ * @state: Current flamegraph state
+ * @node: Parent node
+ * @func: Function to look for
+ * Returns: Child node, or NULL if out of memory
+ */
+static struct flame_node *get_child(struct flame_state *state,
+				    struct flame_node *node,
+				    struct func_info *func)
+{
+	struct flame_node *child;
+
+	/* see if we have this as a child node already */
+	list_for_each_entry(child, &node->child_head, sibling_node) {
+		if (child->func == func)
+			return child;
+	}
+
+	/* create a new node */
+	child = create_node("child");
+	if (!child)
+		return NULL;
+	list_add_tail(&child->sibling_node, &node->child_head);
+	child->func = func;
+	child->parent = node;
+	state->nodes++;
+
+	return child;
+}
+
 /**
  * process_call(): Add a call to the flamegraph info
  *
@@ -1658,26 +1725,11 @@ static int process_call(struct flame_state *state, bool entry, ulong timestamp,
 	int stack_ptr = state->stack_ptr;
 
 	if (entry) {
-		struct flame_node *child, *chd;
-
-		/* see if we have this as a child node already */
-		child = NULL;
-		list_for_each_entry(chd, &node->child_head, sibling_node) {
-			if (chd->func == func) {
-				child = chd;
-				break;
-			}
-		}
-		if (!child) {
-			/* create a new node */
-			child = create_node("child");
-			if (!child)
-				return -1;
-			list_add_tail(&child->sibling_node, &node->child_head);
-			child->func = func;
-			child->parent = node;
-			state->nodes++;
-		}
+		struct flame_node *child;
+
+		child = get_child(state, node, func);
+		if (!child)
+			return -1;
 		debug("entry %s: move from %s to %s\n", func->name,
 		      node->func ? node->func->name : "(root)",
 		      child->func->name);
@@ -1725,6 +1777,45 @@ static int process_call(struct flame_state *state, bool entry, ulong timestamp,
 	return 0;
 }
 
+/**
+ * process_sample() - Add a profiler sample to the flamegraph info
+ *
+ * Each sample adds a count to the node for the sampled function, below its
+ * caller if known
+ *
+ * @state: Current flamegraph state
+ * @tree: Root node
+ * @sample: Sample to add
+ * Returns: 0 on success, -ve on error
+ */
+static int process_sample(struct flame_state *state, struct flame_node *tree,
+			  const struct trace_sample *sample)
+{
+	struct flame_node *node = tree;
+	struct func_info *func;
+
+	if (sample->caller != TRACE_SAMPLE_NO_CALLER) {
+		func = find_caller_by_offset(sample->caller);
+		if (func) {
+			node = get_child(state, node, func);
+			if (!node)
+				return -1;
+		}
+	}
+
+	func = find_caller_by_offset(sample->pc);
+	if (!func) {
+		warn("Cannot find function at %lx\n", text_offset + sample->pc);
+		return 0;
+	}
+	node = get_child(state, node, func);
+	if (!node)
+		return -1;
+	node->count++;
+
+	return 0;
+}
+
 /**
  * make_flame_tree() - Create a tree of stack traces
  *
@@ -1753,6 +1844,17 @@ static int make_flame_tree(enum out_format_t out_format,
 	state.node = tree;
 	state.nodes = 0;
 
+	if (out_format == OUT_FMT_FLAMEGRAPH_SAMPLES) {
+		for (i = 0; i < sample_count; i++) {
+			if (process_sample(&state, tree, &sample_list[i]))
+				return -1;
+		}
+		fprintf(stderr, "%d nodes\n", state.nodes);
+		*treep = tree;
+
+		return 0;
+	}
+
 	for (i = 0, call = call_list; i < call_count; i++, call++) {
 		bool entry = TRACE_CALL_TYPE(call) == FUNCF_ENTRY;
 		ulong timestamp = call->flags & FUNCF_TIMESTAMP_MASK;
@@ -1810,7 +1912,7 @@ static int output_tree(FILE *fout, enum out_format_t out_format,
 	char *str = abuf_data(str_buf);
 
 	if (node->count) {
-		if (out_format == OUT_FMT_FLAMEGRAPH_CALLS) {
+		if (out_format != OUT_FMT_FLAMEGRAPH_TIMING) {
 			fprintf(fout, "%s %d\n", str, node->count);
 		} else {
 			/*
@@ -1937,9 +2039,13 @@ static int prof_tool(int argc, char *const argv[],
 		} else if (!strcmp(cmd, "dump-flamegraph")) {
 			FILE *fout;
 
+			/* Use the samples if there is no function trace */
 			if (out_format != OUT_FMT_FLAMEGRAPH_CALLS &&
-			    out_format != OUT_FMT_FLAMEGRAPH_TIMING)
-				out_format = OUT_FMT_FLAMEGRAPH_CALLS;
+			    out_format != OUT_FMT_FLAMEGRAPH_TIMING &&
+			    out_format != OUT_FMT_FLAMEGRAPH_SAMPLES)
+				out_format = !call_count && sample_count ?
+					OUT_FMT_FLAMEGRAPH_SAMPLES :
+					OUT_FMT_FLAMEGRAPH_CALLS;
 			fout = fopen(out_fname, "w");
 			if (!fout) {
 				fprintf(stderr, "Cannot write file '%s'\n",
@@ -1980,9 +2086,11 @@ int main(int argc, char *argv[])
 				out_format = OUT_FMT_FLAMEGRAPH_CALLS;
 			} else if (!strcmp("timing", optarg)) {
 				out_format = OUT_FMT_FLAMEGRAPH_TIMING;
+			} else if (!strcmp("samples", optarg)) {
+				out_format = OUT_FMT_FLAMEGRAPH_SAMPLES;
 			} else {
 				fprintf(stderr,
-					"Invalid format: use function, funcgraph, calls, timing\n");
+					"Invalid format: use function, funcgraph, calls, timing, samples\n");
 				exit(1);
 			}
 			break;